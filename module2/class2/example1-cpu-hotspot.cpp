@@ -3,6 +3,11 @@
 #include <chrono>
 #include <random>
 #include <iomanip>
+#include <cmath>
+#include <cstring>
+#include <cstdint>
+#include <string>
+#include <algorithm>
 
 // FUNÇÃO EXTREMAMENTE INTENSIVA DE CPU - PROBLEMA CRÍTICO DE PERFORMANCE
 // Esta função foi projetada para ser um PESADELO de performance
@@ -19,7 +24,7 @@ double calcularSomaVetorIntensiva(const std::vector<double>& vetor) {
             valor = valor * 1.001 + 0.001;
             valor = sqrt(valor * valor + 1.0);
             valor = sin(cos(tan(valor))) + 1.0;
-            valor = log(abs(valor) + 1.0);
+            valor = log(std::abs(valor) + 1.0);  // std::abs: o abs(int) de C truncaria o valor
             valor = pow(valor, 1.1);
         }
         
@@ -57,6 +62,304 @@ double calcularSomaVetorIntensiva(const std::vector<double>& vetor) {
     return soma;
 }
 
+// =====================================================================================
+// VERSÃO VETORIZADA (SIMD) - FUNÇÕES TRANSCENDENTAIS SEM LIBM
+// =====================================================================================
+//
+// O kernel acima chama sin/cos/tan/sqrt/log/exp/pow da libm, um elemento por vez.
+// Os laços internos não dependem dos dados (mesma sequência de operações para
+// todo elemento), então vários elementos podem avançar juntos, um por lane de um
+// registrador SIMD. Para isso as funções são reimplementadas com polinômios e
+// redução de argumento, usando só soma, multiplicação e operações de bits:
+// - sqrt: instrução de hardware (arredondamento correto, 0 ULP)
+// - exp: x = n*ln2 + r, |r| <= ln2/2, Taylor grau 13, escala 2^n montada nos bits
+// - log: x = 2^k * m, m em [sqrt(1/2), sqrt(2)), série de atanh (coeficientes fdlibm)
+// - sin/cos/tan: redução por pi/2 em três partes (Cody-Waite), polinômios fdlibm em
+//   [-pi/4, pi/4] e escolha do quadrante por máscara de bits, sem desvios
+// - pow(x, y) = exp(y * log(x)) para x > 0
+// Erro máximo medido contra a libm (glibc), igual em SSE2, AVX2 e AVX-512:
+//   sqrt 0 ULP | exp 1 ULP (|x| <= 708) | log 1 ULP (x normal positivo)
+//   sin/cos 2 ULP e tan 3 ULP (|x| <= 1e4; a redução perde precisão acima de ~1e5)
+//   pow 9 ULP com |y * ln x| <= 10. O erro cresce com |y * ln x|, porque exp
+//   amplifica o erro absoluto do produto: ~90 ULP em |y * ln x| ~ 100
+// O programa mede e imprime esses números (executarComparacaoSimd).
+//
+// O conjunto de instruções é escolhido na compilação:
+//   g++ -O2 -march=native (ou -mavx2 -mfma / -mavx512f)   |   MSVC: /arch:AVX2 ou /arch:AVX512
+// Sem essas opções usa SSE2 (sempre presente em x64) e, fora de x86, uma lane escalar.
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+typedef __m512d VecD;
+typedef __m512i VecI;
+const int SIMD_LARGURA = 8;
+const char* const SIMD_NOME = "AVX-512";
+// sqrt/min/max/shifts com máscara cheia: as formas sem máscara geram um falso
+// aviso -Wmaybe-uninitialized no GCC 12; o código gerado é o mesmo
+const __mmask8 TODAS_LANES = 0xFF;
+inline VecD vSet(double x) { return _mm512_set1_pd(x); }
+inline VecD vLoad(const double* p) { return _mm512_loadu_pd(p); }
+inline void vStore(double* p, VecD a) { _mm512_storeu_pd(p, a); }
+inline VecD vAdd(VecD a, VecD b) { return _mm512_add_pd(a, b); }
+inline VecD vSub(VecD a, VecD b) { return _mm512_sub_pd(a, b); }
+inline VecD vMul(VecD a, VecD b) { return _mm512_mul_pd(a, b); }
+inline VecD vDiv(VecD a, VecD b) { return _mm512_div_pd(a, b); }
+inline VecD vFma(VecD a, VecD b, VecD c) { return _mm512_fmadd_pd(a, b, c); }
+inline VecD vSqrt(VecD a) { return _mm512_maskz_sqrt_pd(TODAS_LANES, a); }
+inline VecD vMin(VecD a, VecD b) { return _mm512_maskz_min_pd(TODAS_LANES, a, b); }
+inline VecD vMax(VecD a, VecD b) { return _mm512_maskz_max_pd(TODAS_LANES, a, b); }
+inline VecI vBits(VecD a) { return _mm512_castpd_si512(a); }
+inline VecD vFromBits(VecI a) { return _mm512_castsi512_pd(a); }
+inline VecI iSet(uint64_t x) { return _mm512_set1_epi64(static_cast<long long>(x)); }
+inline VecI iAdd(VecI a, VecI b) { return _mm512_add_epi64(a, b); }
+inline VecI iSub(VecI a, VecI b) { return _mm512_sub_epi64(a, b); }
+inline VecI iAnd(VecI a, VecI b) { return _mm512_and_si512(a, b); }
+inline VecI iOr(VecI a, VecI b) { return _mm512_or_si512(a, b); }
+inline VecI iXor(VecI a, VecI b) { return _mm512_xor_si512(a, b); }
+template <int N> inline VecI iShl(VecI a) { return _mm512_maskz_slli_epi64(TODAS_LANES, a, N); }
+template <int N> inline VecI iShr(VecI a) { return _mm512_maskz_srli_epi64(TODAS_LANES, a, N); }
+#elif defined(__AVX2__)
+#include <immintrin.h>
+typedef __m256d VecD;
+typedef __m256i VecI;
+const int SIMD_LARGURA = 4;
+const char* const SIMD_NOME = "AVX2";
+inline VecD vSet(double x) { return _mm256_set1_pd(x); }
+inline VecD vLoad(const double* p) { return _mm256_loadu_pd(p); }
+inline void vStore(double* p, VecD a) { _mm256_storeu_pd(p, a); }
+inline VecD vAdd(VecD a, VecD b) { return _mm256_add_pd(a, b); }
+inline VecD vSub(VecD a, VecD b) { return _mm256_sub_pd(a, b); }
+inline VecD vMul(VecD a, VecD b) { return _mm256_mul_pd(a, b); }
+inline VecD vDiv(VecD a, VecD b) { return _mm256_div_pd(a, b); }
+#if defined(__FMA__)
+inline VecD vFma(VecD a, VecD b, VecD c) { return _mm256_fmadd_pd(a, b, c); }
+#else
+inline VecD vFma(VecD a, VecD b, VecD c) { return _mm256_add_pd(_mm256_mul_pd(a, b), c); }
+#endif
+inline VecD vSqrt(VecD a) { return _mm256_sqrt_pd(a); }
+inline VecD vMin(VecD a, VecD b) { return _mm256_min_pd(a, b); }
+inline VecD vMax(VecD a, VecD b) { return _mm256_max_pd(a, b); }
+inline VecI vBits(VecD a) { return _mm256_castpd_si256(a); }
+inline VecD vFromBits(VecI a) { return _mm256_castsi256_pd(a); }
+inline VecI iSet(uint64_t x) { return _mm256_set1_epi64x(static_cast<long long>(x)); }
+inline VecI iAdd(VecI a, VecI b) { return _mm256_add_epi64(a, b); }
+inline VecI iSub(VecI a, VecI b) { return _mm256_sub_epi64(a, b); }
+inline VecI iAnd(VecI a, VecI b) { return _mm256_and_si256(a, b); }
+inline VecI iOr(VecI a, VecI b) { return _mm256_or_si256(a, b); }
+inline VecI iXor(VecI a, VecI b) { return _mm256_xor_si256(a, b); }
+template <int N> inline VecI iShl(VecI a) { return _mm256_slli_epi64(a, N); }
+template <int N> inline VecI iShr(VecI a) { return _mm256_srli_epi64(a, N); }
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+typedef __m128d VecD;
+typedef __m128i VecI;
+const int SIMD_LARGURA = 2;
+const char* const SIMD_NOME = "SSE2";
+inline VecD vSet(double x) { return _mm_set1_pd(x); }
+inline VecD vLoad(const double* p) { return _mm_loadu_pd(p); }
+inline void vStore(double* p, VecD a) { _mm_storeu_pd(p, a); }
+inline VecD vAdd(VecD a, VecD b) { return _mm_add_pd(a, b); }
+inline VecD vSub(VecD a, VecD b) { return _mm_sub_pd(a, b); }
+inline VecD vMul(VecD a, VecD b) { return _mm_mul_pd(a, b); }
+inline VecD vDiv(VecD a, VecD b) { return _mm_div_pd(a, b); }
+inline VecD vFma(VecD a, VecD b, VecD c) { return _mm_add_pd(_mm_mul_pd(a, b), c); }
+inline VecD vSqrt(VecD a) { return _mm_sqrt_pd(a); }
+inline VecD vMin(VecD a, VecD b) { return _mm_min_pd(a, b); }
+inline VecD vMax(VecD a, VecD b) { return _mm_max_pd(a, b); }
+inline VecI vBits(VecD a) { return _mm_castpd_si128(a); }
+inline VecD vFromBits(VecI a) { return _mm_castsi128_pd(a); }
+inline VecI iSet(uint64_t x) { return _mm_set1_epi64x(static_cast<long long>(x)); }
+inline VecI iAdd(VecI a, VecI b) { return _mm_add_epi64(a, b); }
+inline VecI iSub(VecI a, VecI b) { return _mm_sub_epi64(a, b); }
+inline VecI iAnd(VecI a, VecI b) { return _mm_and_si128(a, b); }
+inline VecI iOr(VecI a, VecI b) { return _mm_or_si128(a, b); }
+inline VecI iXor(VecI a, VecI b) { return _mm_xor_si128(a, b); }
+template <int N> inline VecI iShl(VecI a) { return _mm_slli_epi64(a, N); }
+template <int N> inline VecI iShr(VecI a) { return _mm_srli_epi64(a, N); }
+#else
+// Sem SIMD: uma lane, mesmos algoritmos
+typedef double VecD;
+typedef uint64_t VecI;
+const int SIMD_LARGURA = 1;
+const char* const SIMD_NOME = "escalar";
+inline VecD vSet(double x) { return x; }
+inline VecD vLoad(const double* p) { return *p; }
+inline void vStore(double* p, VecD a) { *p = a; }
+inline VecD vAdd(VecD a, VecD b) { return a + b; }
+inline VecD vSub(VecD a, VecD b) { return a - b; }
+inline VecD vMul(VecD a, VecD b) { return a * b; }
+inline VecD vDiv(VecD a, VecD b) { return a / b; }
+inline VecD vFma(VecD a, VecD b, VecD c) { return a * b + c; }
+inline VecD vSqrt(VecD a) { return std::sqrt(a); }
+inline VecD vMin(VecD a, VecD b) { return b < a ? b : a; }
+inline VecD vMax(VecD a, VecD b) { return b > a ? b : a; }
+inline VecI vBits(VecD a) { VecI bits; std::memcpy(&bits, &a, sizeof bits); return bits; }
+inline VecD vFromBits(VecI a) { VecD value; std::memcpy(&value, &a, sizeof value); return value; }
+inline VecI iSet(uint64_t x) { return x; }
+inline VecI iAdd(VecI a, VecI b) { return a + b; }
+inline VecI iSub(VecI a, VecI b) { return a - b; }
+inline VecI iAnd(VecI a, VecI b) { return a & b; }
+inline VecI iOr(VecI a, VecI b) { return a | b; }
+inline VecI iXor(VecI a, VecI b) { return a ^ b; }
+template <int N> inline VecI iShl(VecI a) { return a << N; }
+template <int N> inline VecI iShr(VecI a) { return a >> N; }
+#endif
+
+// Somar e subtrair 1.5 * 2^52 arredonda para o inteiro mais próximo (|x| < 2^51), e
+// os bits baixos da soma são esse inteiro em complemento de dois
+const double ARREDONDA_MAGICO = 6755399441055744.0;
+const uint64_t EXPOENTE_UM = 0x3FF0000000000000ULL;   // bits de 1.0
+const uint64_t BIT_SINAL = 0x8000000000000000ULL;
+
+// Lanes onde `mascara` tem todos os bits em 1 recebem a, as outras recebem b
+inline VecD vSelecionar(VecI mascara, VecD a, VecD b) {
+    return vFromBits(iOr(iAnd(mascara, vBits(a)), iAnd(iXor(mascara, iSet(~0ULL)), vBits(b))));
+}
+
+inline VecD simdAbs(VecD x) { return vFromBits(iAnd(vBits(x), iSet(~BIT_SINAL))); }
+
+// e^x para |x| <= 708 (fora disso o argumento é saturado)
+inline VecD simdExp(VecD x) {
+    x = vMin(vMax(x, vSet(-708.0)), vSet(708.0));
+    VecD t = vFma(x, vSet(1.4426950408889634074), vSet(ARREDONDA_MAGICO));
+    VecD n = vSub(t, vSet(ARREDONDA_MAGICO));
+    VecD r = vFma(n, vSet(-6.93147180369123816490e-01), x);   // ln2 em duas partes
+    r = vFma(n, vSet(-1.90821492927058770002e-10), r);
+
+    VecD p = vSet(1.0 / 6227020800.0);                          // 1/13!
+    p = vFma(p, r, vSet(1.0 / 479001600.0));
+    p = vFma(p, r, vSet(1.0 / 39916800.0));
+    p = vFma(p, r, vSet(1.0 / 3628800.0));
+    p = vFma(p, r, vSet(1.0 / 362880.0));
+    p = vFma(p, r, vSet(1.0 / 40320.0));
+    p = vFma(p, r, vSet(1.0 / 5040.0));
+    p = vFma(p, r, vSet(1.0 / 720.0));
+    p = vFma(p, r, vSet(1.0 / 120.0));
+    p = vFma(p, r, vSet(1.0 / 24.0));
+    p = vFma(p, r, vSet(1.0 / 6.0));
+    p = vFma(p, r, vSet(0.5));
+    p = vFma(p, r, vSet(1.0));
+    p = vFma(p, r, vSet(1.0));
+
+    // 2^n: n (bits baixos de t) somado ao expoente de 1.0
+    VecI inteiro = iSub(vBits(t), vBits(vSet(ARREDONDA_MAGICO)));
+    VecD escala = vFromBits(iAdd(iShl<52>(inteiro), iSet(EXPOENTE_UM)));
+    return vMul(p, escala);
+}
+
+// ln(x) para x normal e positivo
+inline VecD simdLog(VecD x) {
+    // x = 2^k * m com m em [sqrt(1/2), sqrt(2)); o deslocamento mantém tudo sem sinal
+    const uint64_t RAIZ_MEIO = 0x3FE6A09E667F3BCDULL;
+    VecI bits = vBits(x);
+    VecI topo = iShr<52>(iAdd(iSub(bits, iSet(RAIZ_MEIO)), iSet(EXPOENTE_UM)));   // k + 1023
+    VecD m = vFromBits(iAdd(iSub(bits, iShl<52>(topo)), iSet(EXPOENTE_UM)));
+    VecD k = vSub(vFromBits(iOr(topo, vBits(vSet(4503599627370496.0)))), vSet(4503599627370496.0 + 1023.0));
+
+    VecD f = vSub(m, vSet(1.0));
+    VecD s = vDiv(f, vAdd(vSet(2.0), f));
+    VecD z = vMul(s, s);
+    VecD w = vMul(z, z);
+    VecD t1 = vMul(w, vFma(w, vFma(w, vSet(1.531383769920937332e-01), vSet(2.222219843214978396e-01)),
+                           vSet(3.999999999940941908e-01)));
+    VecD t2 = vMul(z, vFma(w, vFma(w, vFma(w, vSet(1.479819860511658591e-01), vSet(1.818357216161805012e-01)),
+                                   vSet(2.857142874366239149e-01)), vSet(6.666666666666735130e-01)));
+    VecD resto = vAdd(t2, t1);
+    VecD metadeF2 = vMul(vSet(0.5), vMul(f, f));
+    VecD correcao = vFma(s, vAdd(metadeF2, resto), vMul(k, vSet(1.90821492927058770002e-10)));
+    return vFma(k, vSet(6.93147180369123816490e-01), vSub(f, vSub(metadeF2, correcao)));
+}
+
+// sin(x) e cos(x) com uma redução de argumento; o quadrante n & 3 troca e inverte
+// os dois polinômios
+inline void simdSinCos(VecD x, VecD& seno, VecD& cosseno) {
+    VecD t = vFma(x, vSet(6.36619772367581382433e-01), vSet(ARREDONDA_MAGICO));   // x * 2/pi
+    VecD n = vSub(t, vSet(ARREDONDA_MAGICO));
+    VecD r = vFma(n, vSet(-1.57079632673412561417e+00), x);    // pi/2 em três partes
+    r = vFma(n, vSet(-6.07710050630396597660e-11), r);
+    r = vFma(n, vSet(-2.02226624871116645580e-21), r);
+
+    VecD z = vMul(r, r);
+    VecD ps = vFma(z, vFma(z, vFma(z, vFma(z, vSet(1.58969099521155010221e-10), vSet(-2.50507602534068634195e-08)),
+                                   vSet(2.75573137070700676789e-06)), vSet(-1.98412698298579493134e-04)),
+                   vSet(8.33333333332248946124e-03));
+    VecD s = vFma(vMul(z, r), vFma(z, ps, vSet(-1.66666666666666324348e-01)), r);
+
+    VecD pc = vFma(z, vFma(z, vFma(z, vFma(z, vFma(z, vSet(-1.13596475577881948265e-11), vSet(2.08757232129817482790e-09)),
+                                           vSet(-2.75573143513906633035e-07)), vSet(2.48015872894767294178e-05)),
+                           vSet(-1.38888888888741095749e-03)), vSet(4.16666666666666019037e-02));
+    VecD hz = vMul(vSet(0.5), z);
+    VecD um = vSub(vSet(1.0), hz);
+    VecD c = vAdd(um, vFma(vMul(z, z), pc, vSub(vSub(vSet(1.0), um), hz)));
+
+    VecI quadrante = iSub(vBits(t), vBits(vSet(ARREDONDA_MAGICO)));
+    VecI impar = iSub(iSet(0), iAnd(quadrante, iSet(1)));
+    VecD sinBase = vSelecionar(impar, c, s);
+    VecD cosBase = vSelecionar(impar, s, c);
+    seno = vFromBits(iXor(vBits(sinBase), iShl<62>(iAnd(quadrante, iSet(2)))));
+    cosseno = vFromBits(iXor(vBits(cosBase), iShl<62>(iAnd(iAdd(quadrante, iSet(1)), iSet(2)))));
+}
+
+inline VecD simdTan(VecD x) {
+    VecD s, c;
+    simdSinCos(x, s, c);
+    return vDiv(s, c);
+}
+
+// x^y para x > 0
+inline VecD simdPow(VecD x, VecD y) { return simdExp(vMul(y, simdLog(x))); }
+
+// Mesmo cálculo de calcularSomaVetorIntensiva, SIMD_LARGURA elementos por vez
+double calcularSomaVetorIntensivaSimd(const std::vector<double>& vetor) {
+    double soma = 0.0;
+    double lanes[SIMD_LARGURA];
+
+    for (size_t i = 0; i < vetor.size(); i += SIMD_LARGURA) {
+        // O último bloco é completado repetindo o último elemento (resultado descartado)
+        size_t ativos = std::min(static_cast<size_t>(SIMD_LARGURA), vetor.size() - i);
+        for (int l = 0; l < SIMD_LARGURA; ++l) lanes[l] = vetor[i + std::min(static_cast<size_t>(l), ativos - 1)];
+        VecD valor = vLoad(lanes);
+
+        for (int j = 0; j < 1000; ++j) {
+            valor = vAdd(vMul(valor, vSet(1.001)), vSet(0.001));
+            valor = vSqrt(vAdd(vMul(valor, valor), vSet(1.0)));
+            VecD s, c;
+            simdSinCos(simdTan(valor), s, c);
+            simdSinCos(c, s, c);
+            valor = vAdd(s, vSet(1.0));
+            valor = simdLog(vAdd(simdAbs(valor), vSet(1.0)));
+            valor = simdPow(valor, vSet(1.1));
+        }
+
+        for (int k = 0; k < 500; ++k) {
+            VecD temp = valor;
+            for (int l = 0; l < 100; ++l) {
+                temp = vSqrt(vAdd(vMul(temp, temp), vSet(static_cast<double>(k + l))));
+                VecD s, c;
+                simdSinCos(temp, s, c);
+                temp = vAdd(vMul(s, c), vSet(1.0));
+                temp = simdExp(vDiv(temp, vSet(1000.0)));
+            }
+            valor = vAdd(valor, vMul(temp, vSet(0.001)));
+        }
+
+        for (int m = 0; m < 200; ++m) {
+            for (int n = 0; n < 50; ++n) {
+                VecD matrixVal = vAdd(valor, vSet(static_cast<double>(m * n)));
+                matrixVal = vSqrt(vAdd(vMul(matrixVal, matrixVal), vSet(1.0)));
+                VecD s, c;
+                simdSinCos(matrixVal, s, c);
+                valor = vAdd(valor, vMul(vAdd(s, c), vSet(0.0001)));
+            }
+        }
+
+        vStore(lanes, valor);
+        for (size_t l = 0; l < ativos; ++l) soma += lanes[l];
+    }
+
+    return soma;
+}
+
 // Função auxiliar para processamento adicional
 // Esta função também consumirá CPU mas em menor escala
 double processamentoSecundario(const std::vector<double>& vetor) {
@@ -67,7 +370,7 @@ double processamentoSecundario(const std::vector<double>& vetor) {
         // Operações matemáticas menos intensivas
         for (int k = 0; k < 50; ++k) {
             temp = temp * 0.999 + 0.1;
-            temp = log(abs(temp) + 1.0);
+            temp = log(std::abs(temp) + 1.0);
         }
         resultado += temp;
     }
@@ -87,6 +390,98 @@ void preencherVetorAleatorio(std::vector<double>& vetor, size_t tamanho) {
     }
 }
 
+// Distância em ULPs: doubles vizinhos diferem de 1 depois de ordenar os bits como inteiros
+double distanciaUlp(double a, double b) {
+    int64_t ia, ib;
+    std::memcpy(&ia, &a, sizeof ia);
+    std::memcpy(&ib, &b, sizeof ib);
+    if (ia < 0) ia = INT64_MIN - ia;
+    if (ib < 0) ib = INT64_MIN - ib;
+    // Subtração em inteiros: convertidos antes para double, os bits baixos se perderiam
+    uint64_t distancia = ia > ib ? static_cast<uint64_t>(ia) - static_cast<uint64_t>(ib)
+                                 : static_cast<uint64_t>(ib) - static_cast<uint64_t>(ia);
+    return static_cast<double>(distancia);
+}
+
+// Compara uma função vetorizada com a libm em `amostras` pontos (semente fixa)
+template <typename FuncaoSimd, typename FuncaoLibm, typename Gerador>
+void medirPrecisao(const char* nome, const char* dominio, FuncaoSimd simd, FuncaoLibm libm, Gerador gerarEntrada) {
+    const int amostras = 200000;
+    std::mt19937_64 gen(12345);
+    double maxUlp = 0.0, somaUlp = 0.0;
+    double entradas[SIMD_LARGURA], saidas[SIMD_LARGURA];
+    for (int i = 0; i < amostras; i += SIMD_LARGURA) {
+        for (int l = 0; l < SIMD_LARGURA; ++l) entradas[l] = gerarEntrada(gen);
+        vStore(saidas, simd(vLoad(entradas)));
+        for (int l = 0; l < SIMD_LARGURA; ++l) {
+            double erro = distanciaUlp(saidas[l], libm(entradas[l]));
+            maxUlp = std::max(maxUlp, erro);
+            somaUlp += erro;
+        }
+    }
+    std::cout << "  " << std::left << std::setw(12) << nome << std::setw(28) << dominio << std::right
+              << std::setw(10) << std::setprecision(0) << maxUlp
+              << std::setw(12) << std::setprecision(3) << somaUlp / amostras << std::endl;
+}
+
+// Tempo de cada versão do kernel na mesma amostra de elementos
+void executarComparacaoSimd(const std::vector<double>& vetor) {
+    std::cout << std::fixed;
+    std::cout << "=== VERSÃO VETORIZADA (" << SIMD_NOME << ", " << SIMD_LARGURA << " x double por registrador) ===" << std::endl;
+    std::cout << "Precisão contra a libm (" << 200000 << " pontos por função):" << std::endl;
+    // setw conta bytes: "ç", "ã" e "í" ocupam dois em UTF-8
+    std::cout << "  " << std::left << std::setw(14) << "Função" << std::setw(29) << "Domínio" << std::right
+              << std::setw(10) << "max ULP" << std::setw(12) << "média ULP" << std::endl;
+
+    std::uniform_real_distribution<double> trig(-1e4, 1e4), expoente(-708.0, 708.0), escala(-690.0, 690.0);
+    std::uniform_real_distribution<double> base(1e-3, 1e3), potencia(-10.0, 10.0), positivo(0.0, 1e6);
+    medirPrecisao("sqrt", "[0, 1e6]", [](VecD x) { return vSqrt(x); },
+                  [](double x) { return std::sqrt(x); }, [&](std::mt19937_64& g) { return positivo(g); });
+    medirPrecisao("exp", "[-708, 708]", [](VecD x) { return simdExp(x); },
+                  [](double x) { return std::exp(x); }, [&](std::mt19937_64& g) { return expoente(g); });
+    medirPrecisao("log", "[1e-300, 1e300]", [](VecD x) { return simdLog(x); },
+                  [](double x) { return std::log(x); }, [&](std::mt19937_64& g) { return std::exp(escala(g)); });
+    medirPrecisao("sin", "[-1e4, 1e4]", [](VecD x) { VecD s, c; simdSinCos(x, s, c); return s; },
+                  [](double x) { return std::sin(x); }, [&](std::mt19937_64& g) { return trig(g); });
+    medirPrecisao("cos", "[-1e4, 1e4]", [](VecD x) { VecD s, c; simdSinCos(x, s, c); return c; },
+                  [](double x) { return std::cos(x); }, [&](std::mt19937_64& g) { return trig(g); });
+    medirPrecisao("tan", "[-1e4, 1e4]", [](VecD x) { return simdTan(x); },
+                  [](double x) { return std::tan(x); }, [&](std::mt19937_64& g) { return trig(g); });
+    medirPrecisao("pow(x,1.1)", "x em [1e-3, 1e3]", [](VecD x) { return simdPow(x, vSet(1.1)); },
+                  [](double x) { return std::pow(x, 1.1); }, [&](std::mt19937_64& g) { return base(g); });
+    // y = 10 / ln(x) * u: |y * ln x| cobre [0, 10]
+    medirPrecisao("pow(2,y)", "|y * ln 2| <= 10", [](VecD y) { return simdPow(vSet(2.0), y); },
+                  [](double y) { return std::pow(2.0, y); }, [&](std::mt19937_64& g) { return potencia(g) / std::log(2.0); });
+    medirPrecisao("pow(2,y)", "|y * ln 2| <= 100", [](VecD y) { return simdPow(vSet(2.0), y); },
+                  [](double y) { return std::pow(2.0, y); }, [&](std::mt19937_64& g) { return 10.0 * potencia(g) / std::log(2.0); });
+
+    std::vector<double> amostra(vetor.begin(), vetor.begin() + std::min<size_t>(vetor.size(), 256));
+    std::cout << std::endl << "Kernel completo em " << amostra.size() << " elementos:" << std::endl;
+
+    auto inicio = std::chrono::high_resolution_clock::now();
+    double somaEscalar = 0.0;
+    {
+        // Silencia o progresso da versão original durante a medição
+        std::streambuf* saida = std::cout.rdbuf(NULL);
+        somaEscalar = calcularSomaVetorIntensiva(amostra);
+        std::cout.rdbuf(saida);
+    }
+    double segundosEscalar = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - inicio).count();
+
+    inicio = std::chrono::high_resolution_clock::now();
+    double somaSimd = calcularSomaVetorIntensivaSimd(amostra);
+    double segundosSimd = std::chrono::duration<double>(std::chrono::high_resolution_clock::now() - inicio).count();
+
+    std::cout << "  libm escalar:  " << std::setprecision(0) << std::setw(10) << amostra.size() / segundosEscalar
+              << " elementos/s  (soma " << std::setprecision(10) << somaEscalar << ")" << std::endl;
+    std::cout << "  " << std::left << std::setw(14) << SIMD_NOME << std::right << " " << std::setprecision(0)
+              << std::setw(10) << amostra.size() / segundosSimd << " elementos/s  (soma " << std::setprecision(10)
+              << somaSimd << ")" << std::endl;
+    std::cout << "  Speedup: " << std::setprecision(2) << segundosEscalar / segundosSimd << "x, diferença relativa da soma: "
+              << std::scientific << std::setprecision(2) << std::fabs(somaSimd - somaEscalar) / std::fabs(somaEscalar)
+              << std::fixed << std::endl;
+}
+
 // Função principal de demonstração
 void executarDemonstracao() {
     std::cout << "=== DEMONSTRAÇÃO DE PROFILING - CPU HOTSPOT ===" << std::endl;
@@ -161,10 +556,21 @@ void executarDemonstracao() {
     std::cout << "3. No Visual Studio: Debug -> Performance Profiler" << std::endl;
     std::cout << "4. Selecione 'CPU Usage' e execute" << std::endl;
     std::cout << "5. A função 'calcularSomaVetorIntensiva' deve aparecer como hotspot principal" << std::endl;
+    std::cout << std::endl;
+
+    executarComparacaoSimd(vetorPrincipal);
 }
 
-int main() {
+// Uso: example1-cpu-hotspot        demonstração completa (vários minutos)
+//      example1-cpu-hotspot simd   só a comparação libm x SIMD
+int main(int argc, char* argv[]) {
     try {
+        if (argc >= 2 && std::string(argv[1]) == "simd") {
+            std::vector<double> vetor;
+            preencherVetorAleatorio(vetor, 256);
+            executarComparacaoSimd(vetor);
+            return 0;
+        }
         executarDemonstracao();
     }
     catch (const std::exception& e) {
@@ -8,6 +8,26 @@
 #include <iomanip>
 #include <random>
 #include <cmath>
+#include <set>
+#include <string>
+#include <algorithm>
+#include <sstream>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <stdexcept>
+#include <cstdint>
+#include <climits>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#pragma comment(lib, "Synchronization.lib")
+#elif defined(__linux__)
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
 
 // ANÁLISE MULTITHREAD COM SAMPLING PROFILER
 // Demonstra distribuição de CPU entre múltiplas threads
@@ -17,6 +37,13 @@
 std::mutex consoleMutex;
 std::atomic<int> contadorGlobal{0};
 
+// setw conta bytes; acentos em UTF-8 ocupam dois
+int larguraUtf8(const char* texto, int colunas) {
+    int extras = 0;
+    for (const char* c = texto; *c; ++c) extras += (static_cast<unsigned char>(*c) & 0xC0) == 0x80;
+    return colunas + extras;
+}
+
 // Função computacionalmente intensiva para simular trabalho real
 // Esta função será executada por múltiplas threads simultaneamente
 double calcularTrabalhoIntensivo(int threadId, int inicio, int fim, const std::string& tipoTrabalho) {
@@ -139,32 +166,544 @@ void demonstracaoThreadsBasicas() {
     std::cout << "- Operações processadas: " << contadorGlobal.load() << std::endl;
 }
 
+// =====================================================================================
+// POOL DE THREADS COM ROUBO DE TRABALHO (WORK STEALING)
+// =====================================================================================
+//
+// std::async(std::launch::async) e std::thread criam uma thread do sistema por tarefa:
+// cada unidade de trabalho paga a criação da thread e o escalonamento do SO. O pool
+// cria as threads uma vez e reparte as tarefas entre elas:
+// - Cada worker tem um deque Chase-Lev: o dono empilha e desempilha no fundo (LIFO,
+//   cache quente, sem CAS no caso comum); workers ociosos roubam do topo (as tarefas
+//   mais antigas, que numa divisão recursiva são as maiores)
+// - Tarefas enviadas por threads de fora do pool entram numa fila de injeção com mutex
+// - Um worker sem trabalho gira um pouco e depois dorme num futex (WaitOnAddress no
+//   Windows); quem publica trabalho só faz a chamada de sistema se há alguém dormindo
+// - FuturoPool<T> guarda o resultado (ou a exceção) de submeter(); entao() agenda uma
+//   continuação para quando o valor ficar pronto
+// - Esperar dentro de um worker executa outras tarefas em vez de bloquear: sem isso,
+//   tarefas que esperam subtarefas travariam o pool
+// - paraleloPara divide o intervalo ao meio recursivamente; as metades pendentes ficam
+//   no deque e são roubadas sob demanda
+
+// Dorme enquanto endereco == esperado; pode acordar sem motivo, quem chama re-testa
+void esperarEndereco(std::atomic<uint32_t>& endereco, uint32_t esperado) {
+    static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t), "futex precisa de 32 bits");
+#ifdef _WIN32
+    WaitOnAddress(&endereco, &esperado, sizeof(esperado), INFINITE);
+#elif defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&endereco), FUTEX_WAIT_PRIVATE, esperado, nullptr, nullptr, 0);
+#else
+    while (endereco.load() == esperado) std::this_thread::sleep_for(std::chrono::microseconds(50));
+#endif
+}
+
+void acordarEndereco(std::atomic<uint32_t>& endereco, bool todos) {
+#ifdef _WIN32
+    if (todos) WakeByAddressAll(&endereco);
+    else WakeByAddressSingle(&endereco);
+#elif defined(__linux__)
+    syscall(SYS_futex, reinterpret_cast<uint32_t*>(&endereco), FUTEX_WAKE_PRIVATE, todos ? INT32_MAX : 1, nullptr,
+            nullptr, 0);
+#else
+    (void)endereco;
+    (void)todos;
+#endif
+}
+
+// Evento de disparo único; disparar() só faz chamada de sistema se alguém dorme nele
+struct Sinal {
+    std::atomic<uint32_t> pronto{0};
+    std::atomic<uint32_t> esperando{0};
+
+    bool disparado() const { return pronto.load(std::memory_order_acquire) != 0; }
+
+    void disparar() {
+        pronto.store(1, std::memory_order_seq_cst);
+        if (esperando.load(std::memory_order_seq_cst)) acordarEndereco(pronto, true);
+    }
+
+    void esperarBloqueando() {
+        esperando.store(1, std::memory_order_seq_cst);
+        while (!pronto.load(std::memory_order_seq_cst)) esperarEndereco(pronto, 0);
+    }
+};
+
+struct Tarefa {
+    std::function<void()> corpo;
+};
+
+// Deque de Chase e Lev (com as ordens de memória de Lê et al., PPoPP 2013)
+class DequeChaseLev {
+private:
+    struct Anel {
+        int64_t capacidade;
+        std::unique_ptr<std::atomic<Tarefa*>[]> itens;
+
+        explicit Anel(int64_t c) : capacidade(c), itens(new std::atomic<Tarefa*>[c]) {}
+        Tarefa* ler(int64_t i) const { return itens[i & (capacidade - 1)].load(std::memory_order_relaxed); }
+        void escrever(int64_t i, Tarefa* t) { itens[i & (capacidade - 1)].store(t, std::memory_order_relaxed); }
+    };
+
+    // topo (ladrões) e fundo (dono) em linhas de cache separadas; enchimento em vez de
+    // alignas para o Worker não precisar de new alinhado (C++17)
+    std::atomic<int64_t> topo{0};
+    char separaTopo[64 - sizeof(std::atomic<int64_t>)];
+    std::atomic<int64_t> fundo{0};
+    char separaFundo[64 - sizeof(std::atomic<int64_t>)];
+    std::atomic<Anel*> anel;
+    std::vector<std::unique_ptr<Anel>> aneis;   // anéis antigos ficam vivos: um ladrão pode estar lendo
+
+public:
+    explicit DequeChaseLev(int64_t capacidade = 256) {
+        aneis.emplace_back(new Anel(capacidade));
+        anel.store(aneis.back().get(), std::memory_order_relaxed);
+    }
+
+    // Só o dono
+    void empilhar(Tarefa* t) {
+        const int64_t b = fundo.load(std::memory_order_relaxed);
+        const int64_t tp = topo.load(std::memory_order_acquire);
+        Anel* a = anel.load(std::memory_order_relaxed);
+        if (b - tp > a->capacidade - 1) {
+            Anel* maior = new Anel(a->capacidade * 2);
+            for (int64_t i = tp; i < b; ++i) maior->escrever(i, a->ler(i));
+            aneis.emplace_back(maior);
+            anel.store(maior, std::memory_order_release);
+            a = maior;
+        }
+        a->escrever(b, t);
+        std::atomic_thread_fence(std::memory_order_release);
+        fundo.store(b + 1, std::memory_order_relaxed);
+    }
+
+    // Só o dono; nullptr se vazio
+    Tarefa* desempilhar() {
+        const int64_t b = fundo.load(std::memory_order_relaxed) - 1;
+        Anel* a = anel.load(std::memory_order_relaxed);
+        fundo.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t tp = topo.load(std::memory_order_relaxed);
+        if (tp > b) {
+            fundo.store(b + 1, std::memory_order_relaxed);
+            return nullptr;
+        }
+        Tarefa* t = a->ler(b);
+        if (tp == b) {
+            // Último item: disputa o topo com os ladrões
+            if (!topo.compare_exchange_strong(tp, tp + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+                t = nullptr;
+            }
+            fundo.store(b + 1, std::memory_order_relaxed);
+        }
+        return t;
+    }
+
+    // Qualquer thread; nullptr se vazio ou se perdeu a disputa
+    Tarefa* roubar() {
+        int64_t tp = topo.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        const int64_t b = fundo.load(std::memory_order_acquire);
+        if (tp >= b) return nullptr;
+        Tarefa* t = anel.load(std::memory_order_acquire)->ler(tp);
+        if (!topo.compare_exchange_strong(tp, tp + 1, std::memory_order_seq_cst, std::memory_order_relaxed)) {
+            return nullptr;
+        }
+        return t;
+    }
+
+    bool vazio() const {
+        return topo.load(std::memory_order_acquire) >= fundo.load(std::memory_order_acquire);
+    }
+};
+
+template <typename T> class FuturoPool;
+
+class PoolRouboTrabalho {
+public:
+    struct Estatisticas {
+        uint64_t executadas = 0;
+        uint64_t roubadas = 0;
+        uint64_t dormidas = 0;
+    };
+
+private:
+    static const int GIROS_ANTES_DE_DORMIR = 64;
+
+    struct Worker {
+        DequeChaseLev deque;
+        std::thread thread;
+        uint64_t semente = 0;
+        std::atomic<uint64_t> executadas{0};
+        std::atomic<uint64_t> roubadas{0};
+        std::atomic<uint64_t> dormidas{0};
+    };
+
+    std::vector<std::unique_ptr<Worker>> workers;
+    std::mutex mutexInjecao;
+    std::deque<Tarefa*> filaInjecao;
+    std::atomic<size_t> tamanhoInjecao{0};
+    std::atomic<uint32_t> epoca{0};   // futex dos workers dormindo: muda a cada aviso de trabalho novo
+    std::atomic<int> dormindo{0};
+    std::atomic<bool> parar{false};
+
+    static thread_local PoolRouboTrabalho* poolAtual;
+    static thread_local int indiceAtual;
+
+    bool noWorker() const { return poolAtual == this && indiceAtual >= 0; }
+
+    uint64_t aleatorio(int indice) {
+        static thread_local uint64_t sementeExterna = 0x9E3779B97F4A7C15ull;
+        uint64_t& s = indice >= 0 ? workers[indice]->semente : sementeExterna;
+        s ^= s << 13;
+        s ^= s >> 7;
+        s ^= s << 17;
+        return s;
+    }
+
+    void avisarSeAlguemDorme() {
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (dormindo.load(std::memory_order_seq_cst) > 0) {
+            epoca.fetch_add(1, std::memory_order_seq_cst);
+            acordarEndereco(epoca, false);
+        }
+    }
+
+    void publicar(Tarefa* t) {
+        if (noWorker()) {
+            workers[indiceAtual]->deque.empilhar(t);
+        } else {
+            std::lock_guard<std::mutex> lock(mutexInjecao);
+            filaInjecao.push_back(t);
+            tamanhoInjecao.store(filaInjecao.size(), std::memory_order_relaxed);
+        }
+        avisarSeAlguemDorme();
+    }
+
+    Tarefa* buscarTarefa(int indice) {
+        Tarefa* t = nullptr;
+        if (indice >= 0 && (t = workers[indice]->deque.desempilhar()) != nullptr) return t;
+        if (tamanhoInjecao.load(std::memory_order_relaxed) > 0) {
+            std::lock_guard<std::mutex> lock(mutexInjecao);
+            if (!filaInjecao.empty()) {
+                t = filaInjecao.front();
+                filaInjecao.pop_front();
+                tamanhoInjecao.store(filaInjecao.size(), std::memory_order_relaxed);
+                return t;
+            }
+        }
+        // Começa numa vítima aleatória para não concentrar os ladrões no mesmo deque
+        const size_t n = workers.size();
+        const size_t primeira = static_cast<size_t>(aleatorio(indice) % n);
+        for (size_t k = 0; k < n; ++k) {
+            const size_t vitima = (primeira + k) % n;
+            if (static_cast<int>(vitima) == indice) continue;
+            if ((t = workers[vitima]->deque.roubar()) != nullptr) {
+                if (indice >= 0) workers[indice]->roubadas.fetch_add(1, std::memory_order_relaxed);
+                return t;
+            }
+        }
+        return nullptr;
+    }
+
+    bool haTrabalhoVisivel() const {
+        if (tamanhoInjecao.load(std::memory_order_seq_cst) > 0) return true;
+        for (const auto& w : workers) {
+            if (!w->deque.vazio()) return true;
+        }
+        return false;
+    }
+
+    void executarTarefa(Tarefa* t, int indice) {
+        t->corpo();
+        delete t;
+        workers[indice]->executadas.fetch_add(1, std::memory_order_relaxed);
+    }
+
+    void loopWorker(int indice) {
+        poolAtual = this;
+        indiceAtual = indice;
+        int giros = 0;
+        while (!parar.load(std::memory_order_acquire)) {
+            if (Tarefa* t = buscarTarefa(indice)) {
+                // Pegou trabalho de outro lugar: pode haver mais, acorda um colega em cascata
+                if (giros > 0) avisarSeAlguemDorme();
+                executarTarefa(t, indice);
+                giros = 0;
+                continue;
+            }
+            if (++giros < GIROS_ANTES_DE_DORMIR) {
+                std::this_thread::yield();
+                continue;
+            }
+            // Lê a época antes de se declarar dormindo: um aviso entre as duas coisas
+            // muda a época e o futex não dorme
+            const uint32_t e = epoca.load(std::memory_order_seq_cst);
+            dormindo.fetch_add(1, std::memory_order_seq_cst);
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+            if (!haTrabalhoVisivel() && !parar.load(std::memory_order_seq_cst)) {
+                workers[indice]->dormidas.fetch_add(1, std::memory_order_relaxed);
+                esperarEndereco(epoca, e);
+            }
+            dormindo.fetch_sub(1, std::memory_order_seq_cst);
+            giros = 1;
+        }
+    }
+
+public:
+    explicit PoolRouboTrabalho(unsigned numWorkers = std::thread::hardware_concurrency()) {
+        if (numWorkers == 0) numWorkers = 1;
+        for (unsigned i = 0; i < numWorkers; ++i) {
+            workers.emplace_back(new Worker());
+            workers.back()->semente = 0x2545F4914F6CDD1Dull * (i + 1);
+        }
+        for (unsigned i = 0; i < numWorkers; ++i) {
+            workers[i]->thread = std::thread([this, i]() { loopWorker(static_cast<int>(i)); });
+        }
+    }
+
+    ~PoolRouboTrabalho() {
+        parar.store(true, std::memory_order_seq_cst);
+        epoca.fetch_add(1, std::memory_order_seq_cst);
+        acordarEndereco(epoca, true);
+        for (auto& w : workers) w->thread.join();
+        for (auto& w : workers) {
+            while (Tarefa* t = w->deque.desempilhar()) delete t;
+        }
+        for (Tarefa* t : filaInjecao) delete t;
+    }
+
+    PoolRouboTrabalho(const PoolRouboTrabalho&) = delete;
+    PoolRouboTrabalho& operator=(const PoolRouboTrabalho&) = delete;
+
+    size_t tamanho() const { return workers.size(); }
+
+    // Índice do worker que está executando a chamada, ou -1 fora de qualquer pool
+    static int indiceWorkerAtual() { return poolAtual != nullptr ? indiceAtual : -1; }
+
+    // Dispara e esquece; uma exceção que escapa de f encerra o programa, como em std::thread
+    template <typename F>
+    void lancar(F&& f) {
+        publicar(new Tarefa{ std::function<void()>(std::forward<F>(f)) });
+    }
+
+    template <typename F>
+    auto submeter(F&& f) -> FuturoPool<decltype(f())>;
+
+    // corpo(i0, i1) processa [i0, i1); pedaços de no máximo grao índices
+    template <typename F>
+    void paraleloPara(size_t inicio, size_t fim, size_t grao, F corpo);
+
+    // Executa uma tarefa pendente na thread atual (só em workers deste pool)
+    bool ajudar() {
+        if (!noWorker()) return false;
+        Tarefa* t = buscarTarefa(indiceAtual);
+        if (t == nullptr) return false;
+        executarTarefa(t, indiceAtual);
+        return true;
+    }
+
+    // Em um worker, executa outras tarefas enquanto espera; fora do pool, dorme no futex
+    void esperar(Sinal& sinal) {
+        if (noWorker()) {
+            while (!sinal.disparado()) {
+                if (!ajudar()) std::this_thread::yield();
+            }
+        } else {
+            sinal.esperarBloqueando();
+        }
+    }
+
+    Estatisticas estatisticas() const {
+        Estatisticas total;
+        for (const auto& w : workers) {
+            total.executadas += w->executadas.load(std::memory_order_relaxed);
+            total.roubadas += w->roubadas.load(std::memory_order_relaxed);
+            total.dormidas += w->dormidas.load(std::memory_order_relaxed);
+        }
+        return total;
+    }
+
+    uint64_t executadasPorWorker(size_t indice) const {
+        return workers[indice]->executadas.load(std::memory_order_relaxed);
+    }
+};
+
+thread_local PoolRouboTrabalho* PoolRouboTrabalho::poolAtual = nullptr;
+thread_local int PoolRouboTrabalho::indiceAtual = -1;
+
+// Resultado de uma tarefa do pool; cópias compartilham o mesmo estado (T não pode ser void)
+template <typename T>
+class FuturoPool {
+private:
+    template <typename> friend class FuturoPool;
+    friend class PoolRouboTrabalho;
+
+    struct Estado {
+        PoolRouboTrabalho* pool;
+        Sinal sinal;
+        T valor{};
+        std::exception_ptr erro;
+        std::mutex mutex;
+        bool concluido = false;
+        std::vector<std::function<void()>> continuacoes;
+
+        explicit Estado(PoolRouboTrabalho* p) : pool(p) {}
+
+        template <typename F>
+        void cumprir(F& f) {
+            try {
+                valor = f();
+            } catch (...) {
+                erro = std::current_exception();
+            }
+            concluir();
+        }
+
+        void concluir() {
+            std::vector<std::function<void()>> pendentes;
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                concluido = true;
+                pendentes.swap(continuacoes);
+            }
+            sinal.disparar();
+            for (auto& c : pendentes) c();
+        }
+
+        void aoConcluir(std::function<void()> c) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!concluido) {
+                    continuacoes.push_back(std::move(c));
+                    return;
+                }
+            }
+            c();
+        }
+    };
+
+    std::shared_ptr<Estado> estado;
+
+    explicit FuturoPool(PoolRouboTrabalho* pool) : estado(std::make_shared<Estado>(pool)) {}
+
+public:
+    bool pronto() const { return estado->sinal.disparado(); }
+
+    void esperar() const {
+        if (!pronto()) estado->pool->esperar(estado->sinal);
+    }
+
+    // Relança a exceção da tarefa, se houve
+    const T& obter() const {
+        esperar();
+        if (estado->erro) std::rethrow_exception(estado->erro);
+        return estado->valor;
+    }
+
+    // f(valor) vira uma tarefa do pool quando este resultado fica pronto;
+    // uma exceção aqui passa direto para o futuro devolvido
+    template <typename F>
+    auto entao(F f) -> FuturoPool<decltype(f(std::declval<const T&>()))> {
+        typedef decltype(f(std::declval<const T&>())) R;
+        FuturoPool<R> proximo(estado->pool);
+        std::shared_ptr<Estado> origem = estado;
+        std::shared_ptr<typename FuturoPool<R>::Estado> destino = proximo.estado;
+        origem->aoConcluir([origem, destino, f]() {
+            origem->pool->lancar([origem, destino, f]() {
+                if (origem->erro) {
+                    destino->erro = origem->erro;
+                    destino->concluir();
+                    return;
+                }
+                auto aplicar = [&]() { return f(origem->valor); };
+                destino->cumprir(aplicar);
+            });
+        });
+        return proximo;
+    }
+};
+
+template <typename F>
+auto PoolRouboTrabalho::submeter(F&& f) -> FuturoPool<decltype(f())> {
+    typedef decltype(f()) T;
+    FuturoPool<T> futuro(this);
+    std::shared_ptr<typename FuturoPool<T>::Estado> estado = futuro.estado;
+    typename std::decay<F>::type corpo(std::forward<F>(f));
+    lancar([estado, corpo]() mutable { estado->cumprir(corpo); });
+    return futuro;
+}
+
+// Controle compartilhado (shared_ptr): a última tarefa ainda o toca depois de disparar o sinal
+template <typename F>
+struct ControleParaleloPara {
+    PoolRouboTrabalho* pool;
+    F corpo;
+    size_t grao;
+    std::atomic<size_t> pendentes{1};
+    Sinal sinal;
+
+    ControleParaleloPara(PoolRouboTrabalho* p, F c, size_t g) : pool(p), corpo(std::move(c)), grao(g) {}
+
+    // Deixa a metade de cima no deque (para ser roubada) e continua com a de baixo
+    static void dividir(const std::shared_ptr<ControleParaleloPara>& c, size_t i0, size_t i1) {
+        while (i1 - i0 > c->grao) {
+            const size_t meio = i0 + (i1 - i0) / 2;
+            c->pendentes.fetch_add(1, std::memory_order_relaxed);
+            std::shared_ptr<ControleParaleloPara> copia = c;
+            c->pool->lancar([copia, meio, i1]() { dividir(copia, meio, i1); });
+            i1 = meio;
+        }
+        c->corpo(i0, i1);
+        if (c->pendentes.fetch_sub(1, std::memory_order_acq_rel) == 1) c->sinal.disparar();
+    }
+};
+
+template <typename F>
+void PoolRouboTrabalho::paraleloPara(size_t inicio, size_t fim, size_t grao, F corpo) {
+    if (inicio >= fim) return;
+    std::shared_ptr<ControleParaleloPara<F>> controle =
+        std::make_shared<ControleParaleloPara<F>>(this, std::move(corpo), std::max<size_t>(grao, 1));
+    if (noWorker()) {
+        ControleParaleloPara<F>::dividir(controle, inicio, fim);
+    } else {
+        lancar([controle, inicio, fim]() { ControleParaleloPara<F>::dividir(controle, inicio, fim); });
+    }
+    esperar(controle->sinal);
+}
+
 // Função para demonstrar async/future para tarefas assíncronas
 void demonstracaoAsyncFuture() {
-    std::cout << "\n=== DEMONSTRAÇÃO: ASYNC/FUTURE (std::async) ===" << std::endl;
-    std::cout << "Usando std::async para processamento assíncrono..." << std::endl;
+    std::cout << "\n=== DEMONSTRAÇÃO: ASYNC/FUTURE (pool com roubo de trabalho) ===" << std::endl;
+    std::cout << "Usando tarefas no pool em vez de uma thread nova por std::async..." << std::endl;
     
     contadorGlobal = 0;
     const int NUM_TAREFAS = 6;
     const int TRABALHO_POR_TAREFA = 3000;
     
+    auto inicioTempo = std::chrono::high_resolution_clock::now();
+    
+    // Threads criadas uma vez; cada tarefa é só um item num deque. Estas tarefas passam
+    // boa parte do tempo dormindo (I/O simulado), então o pool tem pelo menos uma thread
+    // por tarefa: com uma por core, os sleeps não se sobreporiam
+    PoolRouboTrabalho pool(std::max<unsigned>(NUM_TAREFAS, std::thread::hardware_concurrency()));
+    
     std::cout << "Configuração:" << std::endl;
     std::cout << "- Número de tarefas assíncronas: " << NUM_TAREFAS << std::endl;
+    std::cout << "- Workers no pool: " << pool.tamanho() << std::endl;
     std::cout << "- Trabalho por tarefa: " << TRABALHO_POR_TAREFA << " iterações" << std::endl;
     std::cout << "- Tipo de processamento: Simulação de servidor" << std::endl;
     std::cout << std::endl;
     
-    auto inicioTempo = std::chrono::high_resolution_clock::now();
-    
     // Criar tarefas assíncronas
-    std::vector<std::future<double>> futures;
+    std::vector<FuturoPool<double>> futures;
     
     for (int i = 0; i < NUM_TAREFAS; ++i) {
         int inicio = i * TRABALHO_POR_TAREFA;
         int fim = inicio + TRABALHO_POR_TAREFA - 1;
         
         futures.push_back(
-            std::async(std::launch::async, [i, inicio, fim]() {
+            pool.submeter([i, inicio, fim]() {
                 return calcularTrabalhoIntensivo(i, inicio, fim, "simulacao");
             })
         );
@@ -173,7 +712,7 @@ void demonstracaoAsyncFuture() {
     // Coletar resultados
     std::vector<double> resultados;
     for (auto& future : futures) {
-        resultados.push_back(future.get());
+        resultados.push_back(future.obter());
     }
     
     auto fimTempo = std::chrono::high_resolution_clock::now();
@@ -190,82 +729,736 @@ void demonstracaoAsyncFuture() {
     std::cout << "- Tempo total: " << duracao.count() << " ms" << std::endl;
     std::cout << "- Resultado combinado: " << std::fixed << std::setprecision(2) << resultadoTotal << std::endl;
     std::cout << "- Operações processadas: " << contadorGlobal.load() << std::endl;
+    std::cout << "- Throughput: " << std::setprecision(0) << contadorGlobal.load() * 1000.0 / std::max<long long>(1, duracao.count())
+              << " operações/s" << std::endl;
 }
 
-// Simulação de processamento de servidor web multithread
-void simulacaoServidorWeb() {
-    std::cout << "\n=== SIMULAÇÃO: SERVIDOR WEB MULTITHREAD ===" << std::endl;
-    std::cout << "Simulando processamento de requisições HTTP paralelas..." << std::endl;
-    
-    contadorGlobal = 0;
-    const int NUM_WORKERS = 8;
-    const int REQUISICOES_POR_WORKER = 1000;
-    
-    std::cout << "Cenário do servidor:" << std::endl;
-    std::cout << "- Workers threads: " << NUM_WORKERS << std::endl;
-    std::cout << "- Requisições por worker: " << REQUISICOES_POR_WORKER << std::endl;
-    std::cout << "- Total de requisições: " << NUM_WORKERS * REQUISICOES_POR_WORKER << std::endl;
-    std::cout << std::endl;
-    
-    auto inicioTempo = std::chrono::high_resolution_clock::now();
-    
-    // Simular pool de threads de servidor
-    std::vector<std::thread> workers;
-    std::atomic<int> requisicoesConcluidas{0};
-    
-    for (int workerId = 0; workerId < NUM_WORKERS; ++workerId) {
-        workers.emplace_back([workerId, REQUISICOES_POR_WORKER, &requisicoesConcluidas]() {
-            std::random_device rd;
-            std::mt19937 gen(rd());
-            std::uniform_int_distribution<int> tempoProcessamento(100, 1000);
-            std::uniform_real_distribution<double> cargaProcessamento(1.0, 10.0);
-            
-            for (int req = 0; req < REQUISICOES_POR_WORKER; ++req) {
-                // Simular processamento de requisição HTTP
-                double carga = cargaProcessamento(gen);
-                double resultado = 0.0;
-                
-                // Processamento variável por requisição
-                int iteracoes = tempoProcessamento(gen);
-                for (int i = 0; i < iteracoes; ++i) {
-                    resultado += std::sin(carga * i) * std::cos(carga * i);
-                    resultado = std::sqrt(resultado * resultado + 1.0);
-                }
-                
-                requisicoesConcluidas++;
+// =====================================================================================
+// CARGA EM MALHA ABERTA, HISTOGRAMA HDR E SLO
+// =====================================================================================
+//
+// "Processar N requisições o mais rápido possível" é uma malha fechada: o tempo total
+// não mostra quanto cada requisição esperou na fila, e um gerador que só envia quando
+// o servidor dá vazão deixa de medir justamente as requisições que chegariam durante
+// uma pausa (coordinated omission). Aqui as chegadas seguem um horário fixado antes da
+// execução, independente do servidor:
+// - Poisson: intervalos exponenciais com média 1/taxa
+// - Rajadas: períodos ON com taxa × FATOR_RAJADA e OFF sem chegadas, mesma taxa média
+// - A latência conta do horário PREVISTO da chegada até o fim do processamento: se o
+//   gerador se atrasar (sleep impreciso, CPU ocupada), o atraso entra na medida
+// - As latências vão para um histograma HDR; os percentis são comparados com metas de
+//   SLO configuráveis, e a varredura procura a maior taxa que ainda cumpre todas
+
+// Histograma HDR log-linear: cada potência de 2 é dividida em 64 faixas iguais, então
+// qualquer valor de 1 ns a ~18 minutos é guardado com erro relativo < 1/64 (~1,6%), em
+// memória fixa (~18 KB). registrar() pode ser chamado de várias threads ao mesmo tempo
+class HistogramaHdr {
+private:
+    static const int BITS_SUB = 7;                       // 128 valores exatos, depois 64 faixas por oitava
+    static const int METADE = 1 << (BITS_SUB - 1);
+    static const int EXPOENTE_LIMITE = 40;               // valores até 2^40 ns
+    static const int NUM_FAIXAS = (EXPOENTE_LIMITE - BITS_SUB + 2) * METADE;
+
+    std::unique_ptr<std::atomic<uint64_t>[]> contagens;
+    std::atomic<uint64_t> total{0};
+    std::atomic<uint64_t> maior{0};
+
+    static int bitMaisAlto(uint64_t v) {
+        int bit = 0;
+        for (int passo = 32; passo > 0; passo /= 2) {
+            if (v >> (bit + passo)) bit += passo;
+        }
+        return bit;
+    }
+
+    static size_t indice(uint64_t v) {
+        if (v < 2 * static_cast<uint64_t>(METADE)) return static_cast<size_t>(v);
+        const int e = bitMaisAlto(v) - BITS_SUB + 1;
+        return static_cast<size_t>(e) * METADE + static_cast<size_t>(v >> e);
+    }
+
+    static uint64_t menorValorDaFaixa(size_t i) {
+        if (i < 2 * static_cast<size_t>(METADE)) return i;
+        const size_t e = i / METADE - 1;
+        return static_cast<uint64_t>(i - e * METADE) << e;
+    }
+
+public:
+    HistogramaHdr() : contagens(new std::atomic<uint64_t>[NUM_FAIXAS]) {
+        for (int i = 0; i < NUM_FAIXAS; ++i) contagens[i].store(0, std::memory_order_relaxed);
+    }
+
+    void registrar(uint64_t ns) {
+        const uint64_t limite = (uint64_t(1) << EXPOENTE_LIMITE) - 1;
+        const uint64_t v = ns < limite ? ns : limite;
+        contagens[indice(v)].fetch_add(1, std::memory_order_relaxed);
+        total.fetch_add(1, std::memory_order_relaxed);
+        uint64_t atual = maior.load(std::memory_order_relaxed);
+        while (v > atual && !maior.compare_exchange_weak(atual, v, std::memory_order_relaxed)) {
+        }
+    }
+
+    uint64_t contagem() const { return total.load(std::memory_order_relaxed); }
+
+    // Como no HdrHistogram: o maior valor da faixa onde o percentil cai (nunca subestima)
+    uint64_t percentil(double p) const {
+        const uint64_t n = contagem();
+        if (n == 0) return 0;
+        const uint64_t alvo = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(p / 100.0 * n)));
+        const uint64_t maximo = maior.load(std::memory_order_relaxed);
+        uint64_t acumulado = 0;
+        for (int i = 0; i < NUM_FAIXAS; ++i) {
+            acumulado += contagens[i].load(std::memory_order_relaxed);
+            if (acumulado >= alvo) return std::min(menorValorDaFaixa(i + 1) - 1, maximo);
+        }
+        return maximo;
+    }
+};
+
+enum class ModeloChegada { POISSON, RAJADAS };
+
+struct MetaSlo {
+    double percentil;   // ex.: 99.9
+    double limiteMs;
+};
+
+const double FATOR_RAJADA = 4.0;          // rajadas: taxa × 4 durante 1/4 de cada período
+const double PERIODO_RAJADA_S = 0.05;
+const double VAZAO_MINIMA = 0.95;         // sustentável: conclui ao menos 95% da taxa oferecida
+
+std::vector<MetaSlo> metasSloPadrao() {
+    return { { 50.0, 1.0 }, { 99.0, 5.0 }, { 99.9, 20.0 } };
+}
+
+struct ConfigCarga {
+    double taxa = 20000.0;                // chegadas por segundo (média)
+    ModeloChegada modelo = ModeloChegada::POISSON;
+    double duracaoS = 0.4;
+    unsigned workers = 8;
+    bool log = false;
+    std::vector<MetaSlo> metas = metasSloPadrao();
+};
+
+struct ResultadoCarga {
+    size_t requisicoes = 0;
+    // As duas taxas usam a mesma janela, a do horário de chegadas (duracaoS): com
+    // rajadas a última chegada vem antes do fim da janela, e dividir a vazão pelo
+    // tempo até a última conclusão a colocaria acima da taxa oferecida
+    double taxaOferecida = 0.0;           // chegadas na janela / duracaoS
+    double vazao = 0.0;                   // conclusões dentro da janela / duracaoS
+    double tempoTotalS = 0.0;
+    double p50Ms = 0.0, p90Ms = 0.0, p99Ms = 0.0, p999Ms = 0.0, maxMs = 0.0;
+    double atrasoGeradorMaxMs = 0.0;
+    std::vector<double> medidoMs;         // um por meta de SLO
+    bool sloOk = true;
+    std::vector<uint64_t> porWorker;
+    uint64_t roubadas = 0;
+
+    bool sustentavel() const { return sloOk && vazao >= VAZAO_MINIMA * taxaOferecida; }
+};
+
+const char* nomeModelo(ModeloChegada modelo) {
+    return modelo == ModeloChegada::POISSON ? "Poisson" : "rajadas";
+}
+
+// Horários de chegada em ns desde o início, sorteados antes da execução
+std::vector<int64_t> gerarChegadas(const ConfigCarga& config, uint64_t semente) {
+    std::mt19937_64 gen(semente);
+    std::vector<int64_t> chegadas;
+    if (config.modelo == ModeloChegada::POISSON) {
+        std::exponential_distribution<double> intervalo(config.taxa);
+        for (double t = intervalo(gen); t < config.duracaoS; t += intervalo(gen)) {
+            chegadas.push_back(static_cast<int64_t>(t * 1e9));
+        }
+    } else {
+        // Poisson a taxa × FATOR no "tempo ON"; cada trecho ON de cada período é então
+        // colocado no relógio real, deixando o resto do período em silêncio
+        std::exponential_distribution<double> intervalo(config.taxa * FATOR_RAJADA);
+        const double on = PERIODO_RAJADA_S / FATOR_RAJADA;
+        const double tempoOn = config.duracaoS / FATOR_RAJADA;
+        for (double t = intervalo(gen); t < tempoOn; t += intervalo(gen)) {
+            const double periodo = std::floor(t / on);
+            chegadas.push_back(static_cast<int64_t>((periodo * PERIODO_RAJADA_S + (t - periodo * on)) * 1e9));
+        }
+    }
+    return chegadas;
+}
+
+// Trabalho de uma requisição HTTP simulada: CPU variável e I/O ocasional
+double processarRequisicao(std::mt19937& gen, int req) {
+    std::uniform_int_distribution<int> tempoProcessamento(100, 1000);
+    std::uniform_real_distribution<double> cargaProcessamento(1.0, 10.0);
+
+    double carga = cargaProcessamento(gen);
+    double resultado = 0.0;
+
+    // Processamento variável por requisição
+    int iteracoes = tempoProcessamento(gen);
+    for (int i = 0; i < iteracoes; ++i) {
+        resultado += std::sin(carga * i) * std::cos(carga * i);
+        resultado = std::sqrt(resultado * resultado + 1.0);
+    }
+
+    // Simular tempo de I/O ocasional
+    if (req % 50 == 0) {
+        std::this_thread::sleep_for(std::chrono::microseconds(100));
+    }
+    return resultado;
+}
+
+ResultadoCarga executarCargaAberta(const ConfigCarga& config) {
+    const std::vector<int64_t> chegadas = gerarChegadas(config, 42);
+    const int total = static_cast<int>(chegadas.size());
+    const bool log = config.log;
+    ResultadoCarga resultado;
+    resultado.requisicoes = chegadas.size();
+    resultado.taxaOferecida = chegadas.size() / config.duracaoS;
+    if (total == 0) return resultado;
+
+    // Declarados antes do pool: o destrutor do pool espera a última tarefa, que ainda os usa
+    HistogramaHdr histograma;
+    std::atomic<int> concluidas{0};
+    std::atomic<int> concluidasNaJanela{0};
+    Sinal todasConcluidas;
+    PoolRouboTrabalho pool(config.workers);
+
+    typedef std::chrono::steady_clock Relogio;
+    const Relogio::time_point inicio = Relogio::now() + std::chrono::milliseconds(1);
+    const Relogio::time_point fimJanela = inicio + std::chrono::duration_cast<Relogio::duration>(
+        std::chrono::duration<double>(config.duracaoS));
+    int64_t atrasoMaxNs = 0;
+    size_t proxima = 0;
+    // Envia tudo o que já venceu e dorme até a próxima chegada; um envio atrasado ainda
+    // mede a latência a partir do horário previsto
+    while (proxima < chegadas.size()) {
+        const Relogio::time_point agora = Relogio::now();
+        for (; proxima < chegadas.size(); ++proxima) {
+            const Relogio::time_point prevista = inicio + std::chrono::nanoseconds(chegadas[proxima]);
+            if (prevista > agora) break;
+            atrasoMaxNs = std::max<int64_t>(atrasoMaxNs, std::chrono::duration_cast<std::chrono::nanoseconds>(agora - prevista).count());
+            const int req = static_cast<int>(proxima);
+            pool.lancar([req, prevista, fimJanela, total, log, &histograma, &concluidas, &concluidasNaJanela, &todasConcluidas]() {
+                static thread_local std::mt19937 gen(std::random_device{}());
+                processarRequisicao(gen, req);
+                const Relogio::time_point fim = Relogio::now();
+                histograma.registrar(static_cast<uint64_t>(
+                    std::chrono::duration_cast<std::chrono::nanoseconds>(fim - prevista).count()));
+                if (fim <= fimJanela) concluidasNaJanela++;
+
                 contadorGlobal++;
-                
+                const int n = ++concluidas;
+
                 // Log periódico
-                if (req % 200 == 0 && req > 0) {
+                if (log && n % 1000 == 0) {
                     std::lock_guard<std::mutex> lock(consoleMutex);
-                    std::cout << "  Worker " << workerId << " processou " << req 
-                              << " requisições (total global: " << requisicoesConcluidas.load() << ")" << std::endl;
-                }
-                
-                // Simular tempo de I/O ocasional
-                if (req % 50 == 0) {
-                    std::this_thread::sleep_for(std::chrono::microseconds(100));
+                    std::cout << "  Worker " << PoolRouboTrabalho::indiceWorkerAtual() << " concluiu a requisição nº "
+                              << n << std::endl;
                 }
-            }
-            
-            std::lock_guard<std::mutex> lock(consoleMutex);
-            std::cout << "✓ Worker " << workerId << " finalizou todas as requisições!" << std::endl;
-        });
+                if (n == total) todasConcluidas.disparar();
+            });
+        }
+        if (proxima < chegadas.size()) {
+            std::this_thread::sleep_until(inicio + std::chrono::nanoseconds(chegadas[proxima]));
+        }
     }
-    
-    // Aguardar todos os workers
-    for (auto& worker : workers) {
-        worker.join();
+    pool.esperar(todasConcluidas);
+    const double tempoTotalS = std::chrono::duration<double>(Relogio::now() - inicio).count();
+
+    const double NS_POR_MS = 1e6;
+    resultado.tempoTotalS = tempoTotalS;
+    resultado.vazao = concluidasNaJanela.load() / config.duracaoS;
+    resultado.p50Ms = histograma.percentil(50.0) / NS_POR_MS;
+    resultado.p90Ms = histograma.percentil(90.0) / NS_POR_MS;
+    resultado.p99Ms = histograma.percentil(99.0) / NS_POR_MS;
+    resultado.p999Ms = histograma.percentil(99.9) / NS_POR_MS;
+    resultado.maxMs = histograma.percentil(100.0) / NS_POR_MS;
+    resultado.atrasoGeradorMaxMs = atrasoMaxNs / NS_POR_MS;
+    for (const MetaSlo& meta : config.metas) {
+        const double medido = histograma.percentil(meta.percentil) / NS_POR_MS;
+        resultado.medidoMs.push_back(medido);
+        resultado.sloOk = resultado.sloOk && medido <= meta.limiteMs;
+    }
+    for (size_t w = 0; w < pool.tamanho(); ++w) resultado.porWorker.push_back(pool.executadasPorWorker(w));
+    resultado.roubadas = pool.estatisticas().roubadas;
+    return resultado;
+}
+
+void imprimirSlo(const ConfigCarga& config, const ResultadoCarga& resultado) {
+    std::cout << "SLO (latência desde a chegada prevista):" << std::endl;
+    for (size_t i = 0; i < config.metas.size(); ++i) {
+        const MetaSlo& meta = config.metas[i];
+        const bool ok = resultado.medidoMs[i] <= meta.limiteMs;
+        std::ostringstream nome;
+        nome << "p" << meta.percentil << " <= " << std::fixed << std::setprecision(3) << meta.limiteMs << " ms";
+        std::cout << "  " << std::left << std::setw(22) << nome.str() << std::right << std::fixed << std::setprecision(3)
+                  << std::setw(10) << resultado.medidoMs[i] << " ms  " << (ok ? "OK" : "FALHOU") << std::endl;
+    }
+    std::cout << "  Veredito: " << (resultado.sloOk ? "SLO cumprido" : "SLO violado") << std::endl;
+}
+
+void cabecalhoVarredura() {
+    std::cout << std::right << std::setw(12) << "taxa alvo" << std::setw(12) << "oferecida" << std::setw(larguraUtf8("vazão", 12)) << "vazão"
+              << std::setw(10) << "p50 ms" << std::setw(10) << "p99 ms" << std::setw(11) << "p99.9 ms"
+              << std::setw(10) << "max ms" << "  SLO" << std::endl;
+}
+
+void linhaVarredura(double taxa, const ResultadoCarga& r) {
+    std::cout << std::right << std::fixed << std::setprecision(0) << std::setw(12) << taxa << std::setw(12)
+              << r.taxaOferecida << std::setw(12) << r.vazao << std::setprecision(3) << std::setw(10) << r.p50Ms
+              << std::setw(10) << r.p99Ms << std::setw(11) << r.p999Ms << std::setw(10) << r.maxMs << "  "
+              << (r.sustentavel() ? "OK" : (r.sloOk ? "VAZÃO" : "FALHOU")) << std::endl;
+}
+
+// Dobra a taxa até falhar e depois bissecta até 5% de resolução
+void varreduraCapacidade(ConfigCarga config) {
+    std::cout << "\n=== VARREDURA: MAIOR TAXA SUSTENTÁVEL (" << nomeModelo(config.modelo) << ", " << config.workers
+              << " workers, " << config.duracaoS << " s por tentativa) ===" << std::endl;
+    std::cout << "Sustentável = todas as metas de SLO e vazão >= " << VAZAO_MINIMA * 100 << "% da taxa oferecida" << std::endl;
+    cabecalhoVarredura();
+    config.log = false;
+    auto tentar = [&config](double taxa) {
+        config.taxa = taxa;
+        const ResultadoCarga r = executarCargaAberta(config);
+        linhaVarredura(taxa, r);
+        return r.sustentavel();
+    };
+
+    const double TAXA_INICIAL = 1000.0, TAXA_LIMITE = 2e6;
+    double aprovada = 0.0, reprovada = 0.0;
+    for (double taxa = TAXA_INICIAL; taxa <= TAXA_LIMITE; taxa *= 2) {
+        if (!tentar(taxa)) {
+            reprovada = taxa;
+            break;
+        }
+        aprovada = taxa;
+    }
+    if (aprovada == 0.0) {
+        std::cout << "Nem " << TAXA_INICIAL << " req/s cumpre o SLO" << std::endl;
+        return;
+    }
+    if (reprovada == 0.0) {
+        std::cout << "Não saturou até " << aprovada << " req/s" << std::endl;
+        return;
     }
+    while (reprovada - aprovada > 0.05 * aprovada) {
+        const double meio = (aprovada + reprovada) / 2;
+        if (tentar(meio)) aprovada = meio;
+        else reprovada = meio;
+    }
+    std::cout << std::setprecision(0) << "Maior taxa sustentável: ~" << aprovada << " req/s (falha em "
+              << reprovada << " req/s)" << std::endl;
+}
+
+// Argumentos: [taxa] [poisson|rajadas] [pNN=ms ...]; metas dadas substituem as padrão
+bool lerArgumentosCarga(int argc, char* argv[], int primeiro, ConfigCarga& config) {
+    std::vector<MetaSlo> metas;
+    for (int i = primeiro; i < argc; ++i) {
+        const std::string arg = argv[i];
+        const size_t igual = arg.find('=');
+        try {
+            if (arg == "poisson") {
+                config.modelo = ModeloChegada::POISSON;
+            } else if (arg == "rajadas") {
+                config.modelo = ModeloChegada::RAJADAS;
+            } else if (arg.size() > 1 && arg[0] == 'p' && igual != std::string::npos) {
+                const MetaSlo meta = { std::stod(arg.substr(1, igual - 1)), std::stod(arg.substr(igual + 1)) };
+                if (meta.percentil <= 0.0 || meta.percentil > 100.0 || meta.limiteMs <= 0.0) return false;
+                metas.push_back(meta);
+            } else {
+                config.taxa = std::stod(arg);
+                if (config.taxa <= 0.0) return false;
+            }
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+    if (!metas.empty()) config.metas = metas;
+    return true;
+}
+
+// Servidor simulado sob carga em malha aberta: latências por requisição e SLO
+void executarSimulacaoServidor(const ConfigCarga& config) {
+    std::cout << "Cenário do servidor:" << std::endl;
+    std::cout << "- Workers no pool: " << config.workers << std::endl;
+    std::cout << "- Chegadas: " << nomeModelo(config.modelo) << ", " << std::fixed << std::setprecision(0) << config.taxa
+              << " req/s por " << std::setprecision(2) << config.duracaoS << " s" << std::endl;
+    std::cout << "- Uma tarefa por requisição, repartidas por roubo de trabalho" << std::endl;
+    std::cout << std::endl;
     
-    auto fimTempo = std::chrono::high_resolution_clock::now();
-    auto duracao = std::chrono::duration_cast<std::chrono::milliseconds>(fimTempo - inicioTempo);
+    const ResultadoCarga resultado = executarCargaAberta(config);
     
     std::cout << std::endl;
     std::cout << "RESULTADOS SIMULAÇÃO SERVIDOR:" << std::endl;
-    std::cout << "- Tempo total: " << duracao.count() << " ms" << std::endl;
-    std::cout << "- Requisições processadas: " << requisicoesConcluidas.load() << std::endl;
-    std::cout << "- Throughput: " << (requisicoesConcluidas.load() * 1000.0 / duracao.count()) << " req/s" << std::endl;
+    std::cout << "- Tempo total: " << std::setprecision(0) << resultado.tempoTotalS * 1000 << " ms" << std::endl;
+    std::cout << "- Requisições processadas: " << resultado.requisicoes << std::endl;
+    std::cout << "- Taxa oferecida: " << resultado.taxaOferecida << " req/s, throughput: " << resultado.vazao << " req/s" << std::endl;
+    std::cout << "- Latência (ms): p50 " << std::setprecision(3) << resultado.p50Ms << ", p90 " << resultado.p90Ms
+              << ", p99 " << resultado.p99Ms << ", p99.9 " << resultado.p999Ms << ", max " << resultado.maxMs << std::endl;
+    std::cout << "- Maior atraso do gerador de carga: " << resultado.atrasoGeradorMaxMs << " ms (já incluído nas latências)" << std::endl;
+    std::cout << "- Requisições por worker:";
+    for (uint64_t n : resultado.porWorker) std::cout << " " << n;
+    std::cout << std::endl;
+    std::cout << "- Tarefas roubadas entre workers: " << resultado.roubadas << std::endl;
+    imprimirSlo(config, resultado);
+}
+
+// Simulação de processamento de servidor web multithread
+void simulacaoServidorWeb() {
+    std::cout << "\n=== SIMULAÇÃO: SERVIDOR WEB MULTITHREAD ===" << std::endl;
+    std::cout << "Simulando requisições HTTP que chegam em horários próprios (malha aberta)..." << std::endl;
+    
+    contadorGlobal = 0;
+    ConfigCarga config;
+    config.log = true;
+    executarSimulacaoServidor(config);
+}
+
+// =====================================================================================
+// REDUÇÃO PARALELA DETERMINÍSTICA
+// =====================================================================================
+//
+// Soma de ponto flutuante não é associativa: (a + b) + c pode diferir de a + (b + c)
+// no último bit. A soma paralela usual (cada thread soma um trecho contíguo e o
+// resultado vai para um total compartilhado) muda a ordem das somas com o número
+// de threads (tamanho dos trechos) e com o escalonamento (ordem de chegada ao
+// total), então o resultado varia de uma execução para outra.
+//
+// A versão determinística fixa a forma da conta, não a execução:
+// - Os dados são divididos em blocos de BLOCO_REDUCAO elementos, sempre os mesmos
+// - Cada bloco é somado com 8 acumuladores (lane k soma os elementos k, k+8, ...),
+//   combinados numa árvore fixa; o resultado é gravado na posição do bloco
+// - As somas dos blocos são reduzidas por uma árvore binária fixa, em ordem de bloco
+// Qualquer thread pode somar qualquer bloco em qualquer ordem: os bits do
+// resultado dependem só dos dados. O custo extra é um vetor de somas parciais
+// (um double por bloco) e uma árvore sobre ele, desprezíveis perto dos dados.
+
+const size_t BLOCO_REDUCAO = 8192;
+
+// Soma de um bloco com forma fixa; os 8 acumuladores independentes também deixam
+// o compilador usar SIMD sem reordenar nada
+double somarBloco(const double* dados, size_t n) {
+    double acc[8] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+        for (int k = 0; k < 8; ++k) acc[k] += dados[i + k];
+    }
+    for (; i < n; ++i) acc[i % 8] += dados[i];
+    return ((acc[0] + acc[1]) + (acc[2] + acc[3])) + ((acc[4] + acc[5]) + (acc[6] + acc[7]));
+}
+
+// Árvore binária fixa sobre [inicio, fim): a forma depende só de quantos valores há
+double reduzirEmArvore(const std::vector<double>& parciais, size_t inicio, size_t fim) {
+    if (fim - inicio == 1) return parciais[inicio];
+    size_t meio = inicio + (fim - inicio) / 2;
+    return reduzirEmArvore(parciais, inicio, meio) + reduzirEmArvore(parciais, meio, fim);
+}
+
+// Bit a bit o mesmo resultado para qualquer numThreads
+double somaParalelaDeterministica(const std::vector<double>& dados, int numThreads) {
+    if (dados.empty()) return 0.0;
+    size_t numBlocos = (dados.size() + BLOCO_REDUCAO - 1) / BLOCO_REDUCAO;
+    std::vector<double> parciais(numBlocos);
+
+    // Cada thread fica com uma faixa contígua de blocos (mesma localidade da versão usual)
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        size_t primeiro = numBlocos * t / numThreads;
+        size_t ultimo = numBlocos * (t + 1) / numThreads;
+        threads.emplace_back([&dados, &parciais, primeiro, ultimo]() {
+            for (size_t b = primeiro; b < ultimo; ++b) {
+                size_t inicio = b * BLOCO_REDUCAO;
+                parciais[b] = somarBloco(dados.data() + inicio, std::min(BLOCO_REDUCAO, dados.size() - inicio));
+            }
+        });
+    }
+    for (auto& t : threads) t.join();
+
+    return reduzirEmArvore(parciais, 0, numBlocos);
+}
+
+// Versão usual, para comparação: trecho contíguo por thread e total sob mutex,
+// na ordem em que as threads terminam
+double somaParalelaNaoDeterministica(const std::vector<double>& dados, int numThreads) {
+    double total = 0.0;
+    std::mutex totalMutex;
+    std::vector<std::thread> threads;
+    for (int t = 0; t < numThreads; ++t) {
+        size_t inicio = dados.size() * t / numThreads;
+        size_t fim = dados.size() * (t + 1) / numThreads;
+        threads.emplace_back([&dados, &total, &totalMutex, inicio, fim]() {
+            double parcial = somarBloco(dados.data() + inicio, fim - inicio);
+            std::lock_guard<std::mutex> lock(totalMutex);
+            total += parcial;
+        });
+    }
+    for (auto& t : threads) t.join();
+    return total;
+}
+
+void demonstracaoReducaoDeterministica() {
+    std::cout << "\n=== DEMONSTRAÇÃO: REDUÇÃO PARALELA DETERMINÍSTICA ===" << std::endl;
+
+    // Magnitudes de 1e-8 a 1e8 com sinais misturados: a ordem das somas aparece no resultado
+    const size_t NUM_ELEMENTOS = 1 << 23;
+    const int REPETICOES = 5;
+    const int CONTAGENS_THREADS[] = { 1, 2, 3, 4, 8, 16 };
+    std::vector<double> dados(NUM_ELEMENTOS);
+    std::mt19937_64 gen(2024);
+    std::uniform_real_distribution<double> mantissa(-1.0, 1.0), expoente(-8.0, 8.0);
+    for (double& d : dados) d = mantissa(gen) * std::pow(10.0, expoente(gen));
+
+    std::cout << "Dados: " << NUM_ELEMENTOS << " doubles (" << NUM_ELEMENTOS * sizeof(double) / (1024 * 1024)
+              << " MB), blocos de " << BLOCO_REDUCAO << " elementos, melhor de " << REPETICOES << " execuções" << std::endl;
+    std::cout << std::left << std::setw(9) << "Threads" << std::right << std::setw(14) << "usual M/s"
+              << std::setw(26) << "soma usual" << std::setw(14) << "determ. M/s" << std::setw(27) << "soma determinística"
+              << std::endl;
+
+    std::set<double> resultadosUsual, resultadosDeterministicos;
+    double tempoUsual = 0.0, tempoDeterministico = 0.0;
+    for (int numThreads : CONTAGENS_THREADS) {
+        double melhorUsual = 1e9, melhorDeterministico = 1e9;
+        double somaUsual = 0.0, somaDeterministica = 0.0;
+        // Alterna as versões para que as duas vejam o mesmo estado de cache e de CPU
+        for (int r = 0; r < REPETICOES; ++r) {
+            auto inicio = std::chrono::high_resolution_clock::now();
+            somaUsual = somaParalelaNaoDeterministica(dados, numThreads);
+            auto meio = std::chrono::high_resolution_clock::now();
+            somaDeterministica = somaParalelaDeterministica(dados, numThreads);
+            auto fim = std::chrono::high_resolution_clock::now();
+            melhorUsual = std::min(melhorUsual, std::chrono::duration<double>(meio - inicio).count());
+            melhorDeterministico = std::min(melhorDeterministico, std::chrono::duration<double>(fim - meio).count());
+            resultadosUsual.insert(somaUsual);
+            resultadosDeterministicos.insert(somaDeterministica);
+        }
+        tempoUsual += melhorUsual;
+        tempoDeterministico += melhorDeterministico;
+        std::cout << std::left << std::setw(9) << numThreads << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(14) << NUM_ELEMENTOS / melhorUsual / 1e6 << std::setw(26) << std::setprecision(12)
+                  << somaUsual << std::setprecision(0) << std::setw(14) << NUM_ELEMENTOS / melhorDeterministico / 1e6
+                  << std::setw(26) << std::setprecision(12) << somaDeterministica << std::endl;
+    }
+
+    std::cout << std::endl;
+    std::cout << "RESULTADOS REDUÇÃO:" << std::endl;
+    std::cout << "- Resultados distintos, versão usual: " << resultadosUsual.size() << std::endl;
+    std::cout << "- Resultados distintos, versão determinística: " << resultadosDeterministicos.size()
+              << (resultadosDeterministicos.size() == 1 ? " (bit a bit igual)" : " (ERRO: deveria ser 1)") << std::endl;
+    std::cout << "- Vazão determinística / usual: " << std::setprecision(1)
+              << 100.0 * tempoUsual / tempoDeterministico << "%" << std::endl;
+}
+
+// =====================================================================================
+// POOL COM ROUBO DE TRABALHO: TESTES E CUSTO POR TAREFA
+// =====================================================================================
+
+// Uma tarefa por chamada recursiva: exercita criação no deque local, roubo e espera ajudando
+long long fibonacciPool(PoolRouboTrabalho& pool, int n) {
+    if (n < 2) return n;
+    FuturoPool<long long> menos1 = pool.submeter([&pool, n]() { return fibonacciPool(pool, n - 1); });
+    const long long menos2 = fibonacciPool(pool, n - 2);
+    return menos1.obter() + menos2;
+}
+
+// Trabalho curto (alguns microssegundos), como o de uma requisição pequena
+double trabalhoCurto(int semente) {
+    double valor = 1.0 + semente % 7;
+    for (int j = 0; j < 100; ++j) valor = std::sin(valor) * std::cos(valor) + 1.0;
+    return valor;
+}
+
+// Lote de tarefas lançadas com lancar(); compartilhado porque a última tarefa ainda
+// toca o sinal depois de dispará-lo
+struct LoteTarefas {
+    std::atomic<int> restantes;
+    Sinal sinal;
+    explicit LoteTarefas(int n) : restantes(n) {}
+    void concluirUma() {
+        if (restantes.fetch_sub(1, std::memory_order_acq_rel) == 1) sinal.disparar();
+    }
+};
+
+template <typename F>
+double medirNsPorItem(int itens, F f) {
+    auto inicio = std::chrono::high_resolution_clock::now();
+    f();
+    auto fim = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double, std::nano>(fim - inicio).count() / itens;
+}
+
+bool reportarTestePool(const char* nome, bool ok) {
+    std::cout << "  [" << (ok ? "OK" : "ERRO") << "] " << nome << std::endl;
+    return ok;
+}
+
+bool testarPoolRouboTrabalho() {
+    std::cout << "TESTES (pool de 4 workers):" << std::endl;
+    PoolRouboTrabalho pool(4);
+    bool tudoOk = true;
+
+    const size_t N = 1000003;
+    std::vector<uint8_t> visitas(N, 0);
+    pool.paraleloPara(0, N, 1000, [&visitas](size_t i0, size_t i1) {
+        for (size_t i = i0; i < i1; ++i) visitas[i]++;
+    });
+    tudoOk &= reportarTestePool("paraleloPara visita cada índice exatamente uma vez",
+                                std::count(visitas.begin(), visitas.end(), 1) == static_cast<long>(N));
+
+    const long long fib = pool.submeter([&pool]() { return fibonacciPool(pool, 22); }).obter();
+    tudoOk &= reportarTestePool("fibonacci(22) com uma tarefa por chamada = 17711", fib == 17711);
+
+    FuturoPool<int> cadeia = pool.submeter([]() { return 0; });
+    for (int i = 0; i < 100; ++i) cadeia = cadeia.entao([](const int& v) { return v + 1; });
+    tudoOk &= reportarTestePool("100 continuações encadeadas com entao()", cadeia.obter() == 100);
+
+    FuturoPool<int> falha = pool.submeter([]() -> int { throw std::runtime_error("falha na tarefa"); });
+    FuturoPool<int> depois = falha.entao([](const int& v) { return v + 1; });
+    bool relancou = false;
+    try {
+        depois.obter();
+    } catch (const std::runtime_error&) {
+        relancou = true;
+    }
+    tudoOk &= reportarTestePool("exceção atravessa a continuação e volta em obter()", relancou);
+
+    // Quatro threads externas publicando ao mesmo tempo na fila de injeção
+    const int POR_THREAD = 50000;
+    std::shared_ptr<LoteTarefas> lote = std::make_shared<LoteTarefas>(4 * POR_THREAD);
+    std::atomic<long long> soma{0};
+    std::vector<std::thread> produtores;
+    for (int p = 0; p < 4; ++p) {
+        produtores.emplace_back([&pool, lote, &soma, p, POR_THREAD]() {
+            for (int i = 0; i < POR_THREAD; ++i) {
+                const long long valor = static_cast<long long>(p) * POR_THREAD + i;
+                pool.lancar([lote, &soma, valor]() {
+                    soma.fetch_add(valor, std::memory_order_relaxed);
+                    lote->concluirUma();
+                });
+            }
+        });
+    }
+    for (auto& t : produtores) t.join();
+    pool.esperar(lote->sinal);
+    const long long total = 4LL * POR_THREAD;
+    tudoOk &= reportarTestePool("200000 tarefas de 4 produtores externos, cada uma executada uma vez",
+                                soma.load() == total * (total - 1) / 2);
+
+    const PoolRouboTrabalho::Estatisticas e = pool.estatisticas();
+    std::cout << "  Tarefas executadas: " << e.executadas << ", roubadas: " << e.roubadas
+              << ", vezes que um worker dormiu: " << e.dormidas << std::endl;
+    return tudoOk;
+}
+
+void demonstracaoPoolRouboTrabalho() {
+    std::cout << "\n=== DEMONSTRAÇÃO: POOL COM ROUBO DE TRABALHO ===" << std::endl;
+    const bool testesOk = testarPoolRouboTrabalho();
+    std::cout << std::endl;
+
+    const unsigned numWorkers = std::max(2u, std::thread::hardware_concurrency());
+    PoolRouboTrabalho pool(numWorkers);
+    const int N_THREADS = 2000;     // std::thread e std::async: uma thread do SO por tarefa
+    const int N_POOL = 200000;
+
+    std::cout << "CUSTO POR TAREFA VAZIA (criar + executar + esperar), pool de " << numWorkers << " workers:" << std::endl;
+    std::cout << std::left << std::setw(48) << "Mecanismo" << std::right << std::setw(10) << "tarefas"
+              << std::setw(14) << "ns/tarefa" << std::endl;
+    auto linha = [](const char* nome, int n, double ns) {
+        std::cout << std::left << std::setw(larguraUtf8(nome, 48)) << nome << std::right << std::setw(10) << n << std::fixed
+                  << std::setprecision(0) << std::setw(14) << ns << std::endl;
+    };
+
+    const double nsThread = medirNsPorItem(N_THREADS, [N_THREADS]() {
+        std::vector<std::thread> threads;
+        for (int i = 0; i < N_THREADS; ++i) threads.emplace_back([]() {});
+        for (auto& t : threads) t.join();
+    });
+    linha("std::thread + join", N_THREADS, nsThread);
+
+    const double nsAsync = medirNsPorItem(N_THREADS, [N_THREADS]() {
+        std::vector<std::future<void>> futuros;
+        for (int i = 0; i < N_THREADS; ++i) futuros.push_back(std::async(std::launch::async, []() {}));
+        for (auto& f : futuros) f.get();
+    });
+    linha("std::async(launch::async) + get", N_THREADS, nsAsync);
+
+    const double nsExterno = medirNsPorItem(N_POOL, [&pool, N_POOL]() {
+        std::shared_ptr<LoteTarefas> lote = std::make_shared<LoteTarefas>(N_POOL);
+        for (int i = 0; i < N_POOL; ++i) pool.lancar([lote]() { lote->concluirUma(); });
+        pool.esperar(lote->sinal);
+    });
+    linha("pool.lancar de fora (fila de injeção)", N_POOL, nsExterno);
+
+    const double nsInterno = medirNsPorItem(N_POOL, [&pool, N_POOL]() {
+        pool.submeter([&pool, N_POOL]() {
+            std::shared_ptr<LoteTarefas> lote = std::make_shared<LoteTarefas>(N_POOL);
+            for (int i = 0; i < N_POOL; ++i) pool.lancar([lote]() { lote->concluirUma(); });
+            pool.esperar(lote->sinal);
+            return 0;
+        }).obter();
+    });
+    linha("pool.lancar dentro de um worker (deque local)", N_POOL, nsInterno);
+
+    const double nsFuturo = medirNsPorItem(N_POOL, [&pool, N_POOL]() {
+        pool.submeter([&pool, N_POOL]() {
+            std::vector<FuturoPool<int>> futuros;
+            futuros.reserve(N_POOL);
+            for (int i = 0; i < N_POOL; ++i) futuros.push_back(pool.submeter([i]() { return i; }));
+            long long soma = 0;
+            for (auto& f : futuros) soma += f.obter();
+            return soma;
+        }).obter();
+    });
+    linha("pool.submeter + obter (futuro)", N_POOL, nsFuturo);
+
+    const double nsParaleloPara = medirNsPorItem(N_POOL, [&pool, N_POOL]() {
+        pool.paraleloPara(0, N_POOL, 1, [](size_t, size_t) {});
+    });
+    linha("pool.paraleloPara, grão 1", N_POOL, nsParaleloPara);
+
+    std::cout << std::endl;
+    std::cout << "VAZÃO COM TAREFAS CURTAS (~100 sin/cos cada):" << std::endl;
+    std::cout << std::left << std::setw(48) << "Mecanismo" << std::right << std::setw(10) << "tarefas"
+              << std::setw(14) << "tarefas/s" << std::endl;
+    auto linhaVazao = [](const char* nome, int n, double ns) {
+        std::cout << std::left << std::setw(larguraUtf8(nome, 48)) << nome << std::right << std::setw(10) << n << std::fixed
+                  << std::setprecision(0) << std::setw(14) << 1e9 / ns << std::endl;
+    };
+    const int N_CURTAS = 50000;
+    std::vector<double> saida(N_CURTAS);
+
+    linhaVazao("serial (uma thread)", N_CURTAS, medirNsPorItem(N_CURTAS, [&saida, N_CURTAS]() {
+        for (int i = 0; i < N_CURTAS; ++i) saida[i] = trabalhoCurto(i);
+    }));
+    linhaVazao("std::async por tarefa", N_THREADS, medirNsPorItem(N_THREADS, [&saida, N_THREADS]() {
+        std::vector<std::future<void>> futuros;
+        for (int i = 0; i < N_THREADS; ++i) {
+            futuros.push_back(std::async(std::launch::async, [&saida, i]() { saida[i] = trabalhoCurto(i); }));
+        }
+        for (auto& f : futuros) f.get();
+    }));
+    linhaVazao("pool.lancar por tarefa", N_CURTAS, medirNsPorItem(N_CURTAS, [&pool, &saida, N_CURTAS]() {
+        std::shared_ptr<LoteTarefas> lote = std::make_shared<LoteTarefas>(N_CURTAS);
+        for (int i = 0; i < N_CURTAS; ++i) {
+            pool.lancar([lote, &saida, i]() {
+                saida[i] = trabalhoCurto(i);
+                lote->concluirUma();
+            });
+        }
+        pool.esperar(lote->sinal);
+    }));
+    linhaVazao("pool.paraleloPara, grão 64", N_CURTAS, medirNsPorItem(N_CURTAS, [&pool, &saida, N_CURTAS]() {
+        pool.paraleloPara(0, N_CURTAS, 64, [&saida](size_t i0, size_t i1) {
+            for (size_t i = i0; i < i1; ++i) saida[i] = trabalhoCurto(static_cast<int>(i));
+        });
+    }));
+
+    const PoolRouboTrabalho::Estatisticas e = pool.estatisticas();
+    std::cout << std::endl;
+    std::cout << "RESULTADOS POOL:" << std::endl;
+    std::cout << "- Testes: " << (testesOk ? "todos OK" : "FALHARAM") << std::endl;
+    std::cout << "- Criar uma tarefa no pool custa " << std::setprecision(0) << nsAsync / nsInterno
+              << "x menos que std::async e " << nsThread / nsInterno << "x menos que std::thread" << std::endl;
+    std::cout << "- Tarefas executadas: " << e.executadas << ", roubadas: " << e.roubadas
+              << ", vezes que um worker dormiu no futex: " << e.dormidas << std::endl;
 }
 
 // Função principal de demonstração
@@ -276,8 +1469,10 @@ void executarDemonstracao() {
     
     std::cout << "CENÁRIOS DE ANÁLISE:" << std::endl;
     std::cout << "1. Threads básicas (std::thread) - Processamento matemático" << std::endl;
-    std::cout << "2. Tarefas assíncronas (std::async) - Simulação de processamento" << std::endl;
-    std::cout << "3. Simulação de servidor web - Pool de workers" << std::endl;
+    std::cout << "2. Tarefas assíncronas (pool com roubo de trabalho) - Simulação de processamento" << std::endl;
+    std::cout << "3. Simulação de servidor web - Pool de workers, carga em malha aberta e SLO" << std::endl;
+    std::cout << "4. Redução paralela determinística - Mesma soma com qualquer número de threads" << std::endl;
+    std::cout << "5. Pool com roubo de trabalho - Testes e custo por tarefa vs std::thread/std::async" << std::endl;
     std::cout << std::endl;
     
     std::cout << "ANÁLISE ESPERADA NO PROFILER:" << std::endl;
@@ -300,10 +1495,45 @@ void executarDemonstracao() {
     demonstracaoThreadsBasicas();
     demonstracaoAsyncFuture();
     simulacaoServidorWeb();
+    demonstracaoReducaoDeterministica();
+    demonstracaoPoolRouboTrabalho();
 }
 
-int main() {
+// Uso: example4-multithread           todas as demonstrações
+//      example4-multithread reducao   só a redução paralela determinística
+//      example4-multithread pool      só os testes e medições do pool com roubo de trabalho
+//      example4-multithread servidor [taxa] [poisson|rajadas] [pNN=ms ...]
+//                                     uma execução em malha aberta, com metas de SLO próprias
+//      example4-multithread varredura [poisson|rajadas] [pNN=ms ...]
+//                                     maior taxa que cumpre o SLO
+int main(int argc, char* argv[]) {
     try {
+        if (argc >= 2 && (std::string(argv[1]) == "servidor" || std::string(argv[1]) == "varredura")) {
+            ConfigCarga config;
+            if (!lerArgumentosCarga(argc, argv, 2, config)) {
+                std::cerr << "Uso: " << argv[0] << " servidor [taxa] [poisson|rajadas] [pNN=ms ...]" << std::endl;
+                std::cerr << "     " << argv[0] << " varredura [poisson|rajadas] [pNN=ms ...]" << std::endl;
+                std::cerr << "Ex.: " << argv[0] << " servidor 30000 rajadas p99=2 p99.9=10" << std::endl;
+                return 1;
+            }
+            if (std::string(argv[1]) == "servidor") {
+                std::cout << "\n=== SIMULAÇÃO: SERVIDOR WEB EM MALHA ABERTA ===" << std::endl;
+                executarSimulacaoServidor(config);
+            } else {
+                config.duracaoS = 1.0;
+                varreduraCapacidade(config);
+            }
+            return 0;
+        }
+        if (argc >= 2 && std::string(argv[1]) == "reducao") {
+            demonstracaoReducaoDeterministica();
+            return 0;
+        }
+        if (argc >= 2 && std::string(argv[1]) == "pool") {
+            demonstracaoPoolRouboTrabalho();
+            return 0;
+        }
+
         std::cout << "DEMONSTRAÇÃO MULTITHREAD - SAMPLING PROFILER" << std::endl;
         std::cout << "============================================" << std::endl;
         std::cout << std::endl;
@@ -31,6 +31,11 @@
 #include <atomic>
 #include <future>
 #include <array>
+#include <stdexcept>
+#include <iomanip>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 using namespace std;
 using namespace std::chrono;
@@ -63,44 +68,194 @@ double nested_level_3(double x, int depth) noexcept;
 double nested_level_4(double x, int depth) noexcept;
 double nested_level_5(double x, int depth) noexcept;
 
-// Optimized mathematical operations with lookup tables
-class OptimizedMathCache {
+// Interpolating lookup tables for sin/cos/sqrt with a requested accuracy
+//
+// Each function is tabulated on one primary interval and every input is first
+// reduced into it:
+// - sin/cos: x mod 2*pi with Cody-Waite two-part reduction (x - k * hi - k * lo, with
+//   k * hi exact), then the pi/2 phase for cos; the reduced angle is good to ~1e-15
+//   for |x| < 2^21 * 2*pi (~1.3e7), beyond that the error grows as |x| * 2^-53
+// - sqrt: x = m * 4^k with m in [1, 4), sqrt(x) = sqrt(m) * 2^k (relative error)
+// Between nodes the table interpolates linearly or with cubic Hermite polynomials
+// (node values and exact derivatives). The node spacing h comes from the classic
+// error bounds, applied to half the requested error so that reduction and rounding
+// fit in the other half:
+//   linear: |err| <= h^2 / 8 * max|f''|      cubic: |err| <= h^4 / 384 * max|f''''|
+// Each interval stores its polynomial coefficients (2 or 4 doubles), so lookup and
+// evaluation are the same Horner loop for both modes. sin_batch/cos_batch evaluate
+// arrays with AVX2 gathers, four inputs per instruction (scalar loop otherwise).
+enum class Interpolation { LINEAR, CUBIC };
+
+class InterpolatingTable {
 private:
-    static constexpr int CACHE_SIZE = 1000;
-    array<double, CACHE_SIZE> sin_cache;
-    array<double, CACHE_SIZE> cos_cache;
-    array<double, CACHE_SIZE> sqrt_cache;
-    
+    double lo;
+    double step;
+    double inv_step;
+    size_t intervals;
+    Interpolation mode;
+    vector<double> coeff[4];   // per interval: f(lo + (i + s) * h) = c0 + c1 s + c2 s^2 + c3 s^3
+
 public:
-    OptimizedMathCache() {
-        // Precompute common values using array for better performance
-        for (int i = 0; i < CACHE_SIZE; ++i) {
-            const double val = i * 0.01;
-            sin_cache[i] = sin(val);
-            cos_cache[i] = cos(val);
-            sqrt_cache[i] = sqrt(val + 1);
+    static constexpr size_t MAX_INTERVALS = size_t(1) << 22;
+
+    // max_derivative bounds |f''| (linear) or |f''''| (cubic) on [low, high]
+    template <typename F, typename DF>
+    InterpolatingTable(F f, DF df, double low, double high, double max_derivative, double max_error,
+                       Interpolation interpolation)
+        : lo(low), mode(interpolation) {
+        if (max_error <= 0.0) throw invalid_argument("max_error must be positive");
+        const double h = interpolation == Interpolation::LINEAR ? sqrt(8.0 * max_error / max_derivative)
+                                                                : pow(384.0 * max_error / max_derivative, 0.25);
+        const double needed = ceil((high - low) / h);
+        if (needed > static_cast<double>(MAX_INTERVALS)) throw invalid_argument("max_error too small for a table");
+        intervals = max<size_t>(1, static_cast<size_t>(needed));
+        step = (high - low) / intervals;
+        inv_step = 1.0 / step;
+
+        const int terms = interpolation == Interpolation::LINEAR ? 2 : 4;
+        for (int c = 0; c < terms; ++c) coeff[c].resize(intervals);
+        for (size_t i = 0; i < intervals; ++i) {
+            const double x0 = low + i * step, x1 = low + (i + 1) * step;
+            const double p0 = f(x0), p1 = f(x1);
+            coeff[0][i] = p0;
+            if (interpolation == Interpolation::LINEAR) {
+                coeff[1][i] = p1 - p0;
+            } else {
+                const double m0 = df(x0) * step, m1 = df(x1) * step;
+                coeff[1][i] = m0;
+                coeff[2][i] = 3.0 * (p1 - p0) - 2.0 * m0 - m1;
+                coeff[3][i] = 2.0 * (p0 - p1) + m0 + m1;
+            }
         }
     }
-    
-    // Use constexpr and const for better optimization
-    constexpr double fast_sin(double x) const noexcept {
-        const int index = static_cast<int>(x * 100) % CACHE_SIZE;
-        return sin_cache[index];
+
+    // t must lie in [lo, lo + intervals * step]
+    double eval(double t) const noexcept {
+        const double u = (t - lo) * inv_step;
+        const size_t i = min(static_cast<size_t>(u), intervals - 1);
+        const double s = u - static_cast<double>(i);
+        if (mode == Interpolation::LINEAR) return coeff[0][i] + s * coeff[1][i];
+        return coeff[0][i] + s * (coeff[1][i] + s * (coeff[2][i] + s * coeff[3][i]));
     }
-    
-    constexpr double fast_cos(double x) const noexcept {
-        const int index = static_cast<int>(x * 100) % CACHE_SIZE;
-        return cos_cache[index];
+
+    size_t size() const noexcept { return intervals; }
+    size_t bytes() const noexcept { return intervals * sizeof(double) * (mode == Interpolation::LINEAR ? 2 : 4); }
+    double origin() const noexcept { return lo; }
+    double scale() const noexcept { return inv_step; }
+    Interpolation interpolation() const noexcept { return mode; }
+    const double* coefficients(int c) const noexcept { return coeff[c].data(); }
+};
+
+class LutMathApproximator {
+private:
+    static constexpr double TWO_PI = 6.283185307179586476925;
+    static constexpr double HALF_PI = 1.570796326794896619231;
+    // 2*pi = REDUCE_HI + REDUCE_LO; REDUCE_HI has 31 significant bits, so k * REDUCE_HI
+    // is exact for |k| < 2^22 and x - k * REDUCE_HI cancels without error
+    static constexpr double REDUCE_HI = 6.28318530693650245667;     // 0x1.921fb544p+2
+    static constexpr double REDUCE_LO = 2.43084020260247689973e-10;
+    InterpolatingTable sin_table;    // [0, 2*pi)
+    InterpolatingTable sqrt_table;   // [1, 4)
+
+    // Reduction to [0, 2*pi) before the phase is added (x + phase would round at the
+    // scale of x), scaled to table units; rounding can leave the angle a hair outside the
+    // period, which the clamp turns into a tiny extrapolation of the edge cell
+    double periodic_one(double x, double phase) const noexcept {
+        const double units = static_cast<double>(sin_table.size());
+        const double periods = floor(x * (1.0 / TWO_PI));
+        const double reduced = (x - periods * REDUCE_HI) - periods * REDUCE_LO;
+        double u = (reduced + phase) * (units / TWO_PI);
+        if (u >= units) u -= units;
+        const double cell = max(0.0, min(floor(u), units - 1.0));
+        const double s = u - cell;
+        const size_t k = static_cast<size_t>(cell);
+        const double c0 = sin_table.coefficients(0)[k], c1 = sin_table.coefficients(1)[k];
+        if (sin_table.interpolation() == Interpolation::LINEAR) return c0 + s * c1;
+        return c0 + s * (c1 + s * (sin_table.coefficients(2)[k] + s * sin_table.coefficients(3)[k]));
     }
-    
-    constexpr double fast_sqrt(double x) const noexcept {
-        const int index = static_cast<int>(x * 100) % CACHE_SIZE;
-        return sqrt_cache[index];
+
+    // Same reduction as periodic_one, four lanes at a time with gathers
+    void periodic_batch(const double* x, double* out, size_t n, double phase) const noexcept {
+        size_t i = 0;
+#ifdef __AVX2__
+        const double* c0 = sin_table.coefficients(0);
+        const double* c1 = sin_table.coefficients(1);
+        const double* c2 = sin_table.coefficients(2);
+        const double* c3 = sin_table.coefficients(3);
+        const bool cubic = sin_table.interpolation() == Interpolation::CUBIC;
+        const double units = static_cast<double>(sin_table.size());
+        const __m256d zero = _mm256_setzero_pd(), all = _mm256_castsi256_pd(_mm256_set1_epi64x(-1));
+        const auto gather = [zero, all](const double* base, __m128i idx) {
+            return _mm256_mask_i32gather_pd(zero, base, idx, all, 8);
+        };
+        const __m256d v_phase = _mm256_set1_pd(phase), v_inv_period = _mm256_set1_pd(1.0 / TWO_PI);
+        const __m256d v_hi = _mm256_set1_pd(REDUCE_HI), v_lo = _mm256_set1_pd(REDUCE_LO);
+        const __m256d v_to_units = _mm256_set1_pd(units / TWO_PI);
+        const __m256d v_units = _mm256_set1_pd(units), v_last = _mm256_set1_pd(units - 1.0);
+        for (const size_t vector_end = n & ~size_t(3); i < vector_end; i += 4) {
+            const __m256d xv = _mm256_loadu_pd(x + i);
+            const __m256d periods = _mm256_floor_pd(_mm256_mul_pd(xv, v_inv_period));
+            const __m256d reduced = _mm256_sub_pd(_mm256_sub_pd(xv, _mm256_mul_pd(periods, v_hi)),
+                                                  _mm256_mul_pd(periods, v_lo));
+            __m256d u = _mm256_mul_pd(_mm256_add_pd(reduced, v_phase), v_to_units);
+            u = _mm256_sub_pd(u, _mm256_and_pd(_mm256_cmp_pd(u, v_units, _CMP_GE_OQ), v_units));
+            const __m256d cell = _mm256_max_pd(_mm256_min_pd(_mm256_floor_pd(u), v_last), zero);
+            const __m256d s = _mm256_sub_pd(u, cell);
+            const __m128i idx = _mm256_cvttpd_epi32(cell);
+            __m256d r;
+            if (cubic) {
+                r = gather(c3, idx);
+                r = _mm256_add_pd(_mm256_mul_pd(r, s), gather(c2, idx));
+                r = _mm256_add_pd(_mm256_mul_pd(r, s), gather(c1, idx));
+            } else {
+                r = gather(c1, idx);
+            }
+            r = _mm256_add_pd(_mm256_mul_pd(r, s), gather(c0, idx));
+            _mm256_storeu_pd(out + i, r);
+        }
+#endif
+        for (; i < n; ++i) out[i] = periodic_one(x[i], phase);
+    }
+
+public:
+    // max_error: absolute for sin/cos, relative for sqrt; the tables get half of it
+    LutMathApproximator(double max_error, Interpolation mode)
+        : sin_table([](double t) { return sin(t); }, [](double t) { return cos(t); }, 0.0, TWO_PI, 1.0,
+                    0.5 * max_error, mode),
+          sqrt_table([](double m) { return sqrt(m); }, [](double m) { return 0.5 / sqrt(m); }, 1.0, 4.0,
+                     mode == Interpolation::LINEAR ? 0.25 : 15.0 / 16.0, 0.5 * max_error, mode) {}
+
+    double fast_sin(double x) const noexcept {
+        return periodic_one(x, 0.0);
+    }
+
+    double fast_cos(double x) const noexcept {
+        return periodic_one(x, HALF_PI);
     }
+
+    // x >= 0
+    double fast_sqrt(double x) const noexcept {
+        if (x == 0.0) return 0.0;
+        int e;
+        double m = frexp(x, &e) * 2.0;   // x = m * 2^(e - 1), m in [1, 2)
+        e -= 1;
+        if (e & 1) {
+            m *= 2.0;
+            e -= 1;
+        }
+        return ldexp(sqrt_table.eval(m), e / 2);
+    }
+
+    void sin_batch(const double* x, double* out, size_t n) const noexcept { periodic_batch(x, out, n, 0.0); }
+    void cos_batch(const double* x, double* out, size_t n) const noexcept { periodic_batch(x, out, n, HALF_PI); }
+
+    size_t table_bytes() const noexcept { return sin_table.bytes() + sqrt_table.bytes(); }
+    size_t sin_entries() const noexcept { return sin_table.size(); }
 };
 
-// Global optimized math cache
-const OptimizedMathCache math_cache;
+// Global math tables: 1e-9 with cubic interpolation (tables sized for 5e-10) needs 301 sin
+// intervals x 4 doubles (~9.4 KB) plus ~4.4 KB for sqrt, ~13.8 KB in total (see table_bytes())
+const LutMathApproximator math_cache(1e-9, Interpolation::CUBIC);
 
 /*
  * SCENARIO 1: Optimized Performance Functions
@@ -412,6 +567,83 @@ double nested_level_5(double x, int depth) noexcept {
     return result + sin(x) + depth;
 }
 
+/*
+ * LOOKUP TABLE MATH - accuracy and speed against the direct computation
+ */
+
+// Best of three timings of `body`, in nanoseconds per element
+template <typename Body>
+double time_per_element(size_t count, Body body) {
+    double best = 1e30;
+    for (int run = 0; run < 3; ++run) {
+        const auto start = high_resolution_clock::now();
+        body();
+        best = min(best, duration<double, nano>(high_resolution_clock::now() - start).count() / count);
+    }
+    return best;
+}
+
+void benchmark_lut_math() {
+    cout << "=== LOOKUP TABLE MATH (range reduction + interpolation) ===" << endl;
+    const size_t N = size_t(1) << 20;
+    mt19937_64 bench_gen(7);
+    uniform_real_distribution<double> angle(0.0, 1000.0), far_angle(-1e7, 1e7), exponent(-6.0, 6.0);
+    vector<double> angles(N), far_angles(N), radicands(N), out(N), reference(N), far_reference(N);
+    for (size_t i = 0; i < N; ++i) {
+        angles[i] = angle(bench_gen);
+        far_angles[i] = far_angle(bench_gen);
+        far_reference[i] = sin(far_angles[i]);
+        radicands[i] = pow(10.0, exponent(bench_gen));
+    }
+    double sink = 0.0;
+
+    const double libm_sin_ns = time_per_element(N, [&]() { for (size_t i = 0; i < N; ++i) reference[i] = sin(angles[i]); });
+    const double libm_sqrt_ns = time_per_element(N, [&]() { for (size_t i = 0; i < N; ++i) out[i] = sqrt(radicands[i]); });
+    sink += out[N / 2];
+#ifdef __AVX2__
+    cout << "Batch path: AVX2 gathers (4 per instruction)" << endl;
+#else
+    cout << "Batch path: scalar loop (compile with -mavx2 for gathers)" << endl;
+#endif
+    cout << "sin: x in [0, 1000) (far: |x| < 1e7), absolute error | sqrt: x in [1e-6, 1e6], relative error | libm sin "
+         << fixed << setprecision(2) << libm_sin_ns << " ns, sqrt " << libm_sqrt_ns << " ns" << endl;
+    cout << left << setw(8) << "Interp" << right << setw(10) << "Requested" << setw(10) << "Entries" << setw(9) << "KB"
+         << setw(12) << "sin err" << setw(12) << "far err" << setw(12) << "sqrt err" << setw(10) << "sin ns"
+         << setw(10) << "batch ns"
+         << setw(10) << "speedup" << setw(10) << "sqrt ns" << endl;
+
+    for (const Interpolation mode : { Interpolation::LINEAR, Interpolation::CUBIC }) {
+        for (const double requested : { 1e-4, 1e-7, 1e-10 }) {
+            const LutMathApproximator lut(requested, mode);
+
+            const double scalar_ns = time_per_element(N, [&]() { for (size_t i = 0; i < N; ++i) out[i] = lut.fast_sin(angles[i]); });
+            double sin_error = 0.0;
+            for (size_t i = 0; i < N; ++i) sin_error = max(sin_error, fabs(out[i] - reference[i]));
+            const double batch_ns = time_per_element(N, [&]() { lut.sin_batch(angles.data(), out.data(), N); });
+            for (size_t i = 0; i < N; ++i) sin_error = max(sin_error, fabs(out[i] - reference[i]));
+            sink += out[N / 2];
+            double far_error = 0.0;
+            lut.sin_batch(far_angles.data(), out.data(), N);
+            for (size_t i = 0; i < N; ++i) far_error = max(far_error, fabs(out[i] - far_reference[i]));
+            for (size_t i = 0; i < N; ++i) far_error = max(far_error, fabs(lut.fast_sin(far_angles[i]) - far_reference[i]));
+
+            const double sqrt_ns = time_per_element(N, [&]() { for (size_t i = 0; i < N; ++i) out[i] = lut.fast_sqrt(radicands[i]); });
+            double sqrt_error = 0.0;
+            for (size_t i = 0; i < N; ++i) sqrt_error = max(sqrt_error, fabs(out[i] / sqrt(radicands[i]) - 1.0));
+
+            cout << left << setw(8) << (mode == Interpolation::LINEAR ? "linear" : "cubic") << right
+                 << scientific << setprecision(0) << setw(10) << requested << setw(10) << lut.sin_entries()
+                 << fixed << setprecision(1) << setw(9) << lut.table_bytes() / 1024.0
+                 << scientific << setprecision(2) << setw(12) << sin_error << setw(12) << far_error << setw(12) << sqrt_error
+                 << fixed << setprecision(2) << setw(10) << scalar_ns << setw(10) << batch_ns
+                 << setw(9) << libm_sin_ns / batch_ns << "x" << setw(10) << sqrt_ns << endl;
+        }
+    }
+    cout << "Errors stay below the requested bound; the table grows as error^-1/2 (linear) or error^-1/4 (cubic)." << endl;
+    cout << "Hardware sqrt is a single instruction: the table only pays off for sin/cos." << endl;
+    cout << "(checksum " << sink << ")" << endl << endl;
+}
+
 /*
  * OPTIMIZED THREADING - Efficient thread usage
  */
@@ -625,7 +857,14 @@ void start_optimized_threads() {
     cout << "All optimized threads completed! Performance session finished." << endl;
 }
 
-int main() {
+// Usage: solve-1        full profiling session (threads run for 30 seconds)
+//        solve-1 lut    lookup table accuracy/speed report only
+int main(int argc, char* argv[]) {
+    if (argc >= 2 && string(argv[1]) == "lut") {
+        benchmark_lut_math();
+        return 0;
+    }
+
     cout << "=== OPTIMIZED PROFILING SOLUTION ===" << endl;
     cout << "NOTE: This program uses " << OPTIMAL_THREAD_COUNT << " optimized threads!" << endl;
     cout << "Each thread focuses on optimized scenarios:" << endl;
@@ -654,6 +893,8 @@ int main() {
     
     cout << "Global data initialized efficiently." << endl;
     cout << endl;
+
+    benchmark_lut_math();
     
     // START OPTIMIZED THREADS
     start_optimized_threads();
@@ -7,6 +7,8 @@
  * - Tail recursion optimization
  * - Insertion sort for small arrays
  * - Three-way partitioning for duplicates
+ * - Parallel sample sort for large arrays
+ * - AVX2 sorting networks for small partitions (build with -mavx2 or /arch:AVX2)
  * 
  * OBJECTIVES:
  * - Demonstrate optimization techniques for QuickSort
@@ -25,6 +27,17 @@
 #include <chrono>
 #include <random>
 #include <algorithm>
+#include <thread>
+#include <atomic>
+#include <string>
+#include <iomanip>
+#include <limits>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
 
 using namespace std;
 using namespace std::chrono;
@@ -38,6 +51,13 @@ const int ARRAY_SIZE = 5000;              // Array size for profiling (same as p
 const int TEST_ITERATIONS = 3;            // Number of test iterations
 const int RANDOM_SEED = 42;               // Random seed for reproducible results
 const int INSERTION_SORT_THRESHOLD = 10;  // Threshold for switching to insertion sort
+const int SORTING_NETWORK_THRESHOLD = 64; // Largest partition handed to the AVX2 sorting network
+const int NETWORK_ARRAY_SIZE = 1000000;   // Array size for the sorting network benchmark
+
+// Parallel Sample Sort Configuration
+const size_t PARALLEL_ARRAY_SIZE = 10000000;  // Default size for the parallel sort benchmark
+const size_t SAMPLE_SORT_OVERSAMPLING = 64;   // Samples drawn per bucket when choosing splitters
+const size_t SAMPLE_SORT_MIN_SIZE = 1 << 16;  // Below this, thread startup costs more than it saves
 
 // Performance Tracking
 long long totalComparisons = 0;
@@ -47,6 +67,14 @@ int currentRecursionDepth = 0;
 
 // ============================================================================
 
+// Helpers are defined after the algorithms that use them
+int medianOfThree(vector<int>& arr, int low, int high);
+int partitionOptimized(vector<int>& arr, int low, int high);
+void insertionSort(vector<int>& arr, int low, int high);
+pair<int, int> partitionThreeWay(vector<int>& arr, int low, int high);
+void sortSmallPartition(vector<int>& arr, int low, int high);
+int smallPartitionLimit();
+
 /*
  * SCENARIO 1: Optimized QuickSort Implementation
  * Demonstrates efficient pivot selection and O(n log n) average case
@@ -58,9 +86,9 @@ void quickSortOptimized(vector<int>& arr, int low, int high) {
     maxRecursionDepth = max(maxRecursionDepth, currentRecursionDepth);
 
     if (low < high) {
-        // OPTIMIZED: Use insertion sort for small arrays
-        if (high - low + 1 < INSERTION_SORT_THRESHOLD) {
-            insertionSort(arr, low, high);
+        // OPTIMIZED: Sorting network (or insertion sort) for small arrays
+        if (high - low + 1 <= smallPartitionLimit()) {
+            sortSmallPartition(arr, low, high);
             currentRecursionDepth--;
             return;
         }
@@ -201,6 +229,485 @@ pair<int, int> partitionThreeWay(vector<int>& arr, int low, int high) {
     return make_pair(lt, gt);
 }
 
+/*
+ * SCENARIO 4: Parallel Sample Sort
+ * Demonstrates spreading one large sort across all cores
+ *
+ * 1. Oversampled splitters: draw SAMPLE_SORT_OVERSAMPLING elements per bucket, sort
+ *    the sample and keep every SAMPLE_SORT_OVERSAMPLING-th one, so buckets come out
+ *    nearly the same size whatever the input distribution
+ * 2. Classification: each thread walks its own slice of the input and finds each
+ *    element's bucket by descending a complete tree of splitters without branches,
+ *    recording the bucket and counting bucket sizes locally
+ * 3. Prefix sums over the (bucket, thread) counts give every thread its own output
+ *    ranges, so the scatter pass needs no locks or atomics
+ * 4. Buckets are independent: threads take them from a shared counter and sort them
+ * 5. Equality buckets (as in IPS4o): when the sample repeats a splitter, splitters are
+ *    deduplicated and every bucket gets a twin holding the elements equal to its upper
+ *    splitter. One comparison per element fills it, and it is already sorted, so a
+ *    duplicate-heavy input no longer ends up in a single bucket sorted by one thread
+ */
+
+// Runs worker(threadId) on numThreads threads (the caller is thread 0) and waits for all
+template <typename Worker>
+void runOnThreads(int numThreads, Worker worker) {
+    vector<thread> threads;
+    for (int t = 1; t < numThreads; t++) {
+        threads.emplace_back(worker, t);
+    }
+    worker(0);
+    for (auto& th : threads) {
+        th.join();
+    }
+}
+
+// OPTIMIZED: Parallel sample sort for large arrays (any type with operator<)
+template <typename T>
+void parallelSampleSort(vector<T>& data, int numThreads) {
+    const size_t n = data.size();
+    numThreads = max(numThreads, 1);
+    if (n < SAMPLE_SORT_MIN_SIZE) {
+        sort(data.begin(), data.end());
+        return;
+    }
+
+    // OPTIMIZED: Power-of-two bucket count (complete splitter tree), 8 buckets per thread for load balance
+    int logBuckets = 4;
+    while ((1 << logBuckets) < 8 * numThreads && logBuckets < 8) {
+        logBuckets++;
+    }
+    const size_t numBuckets = size_t(1) << logBuckets;
+
+    // OPTIMIZED: Oversampled splitter selection
+    mt19937_64 sampleGen(RANDOM_SEED);
+    uniform_int_distribution<size_t> pick(0, n - 1);
+    vector<T> sample(SAMPLE_SORT_OVERSAMPLING * numBuckets);
+    for (T& s : sample) {
+        s = data[pick(sampleGen)];
+    }
+    sort(sample.begin(), sample.end());
+
+    // Splitter b is the upper bound of bucket b: bucket b holds splitters[b-1] < x <= splitters[b]
+    vector<T> splitters(numBuckets - 1);
+    for (size_t b = 0; b + 1 < numBuckets; b++) {
+        splitters[b] = sample[(b + 1) * SAMPLE_SORT_OVERSAMPLING];
+    }
+    // OPTIMIZED: Equal adjacent splitters mean a heavily repeated key: keep each splitter
+    // once (padding with the largest, which leaves empty buckets) and split every bucket
+    // into "below its splitter" (2b) and "equal to it" (2b + 1)
+    bool equalityBuckets = false;
+    for (size_t b = 1; b < splitters.size(); b++) {
+        equalityBuckets = equalityBuckets || !(splitters[b - 1] < splitters[b]);
+    }
+    if (equalityBuckets) {
+        auto last = unique(splitters.begin(), splitters.end(), [](const T& a, const T& b) { return !(a < b); });
+        fill(last, splitters.end(), *(last - 1));
+    }
+    const size_t numClasses = equalityBuckets ? 2 * numBuckets : numBuckets;
+
+    // Tree node j (1 <= j < numBuckets) separates the lower and upper half of its bucket
+    // range; its children are 2j and 2j+1, and leaf j stands for bucket j - numBuckets
+    vector<T> tree(numBuckets);
+    for (size_t j = 1; j < numBuckets; j++) {
+        int level = 0;
+        while ((size_t(2) << level) <= j) {
+            level++;
+        }
+        const size_t width = numBuckets >> level;
+        const size_t firstBucket = (j - (size_t(1) << level)) * width;
+        tree[j] = splitters[firstBucket + width / 2 - 1];
+    }
+
+    // OPTIMIZED: Per-thread classification with local counts
+    const size_t chunk = (n + numThreads - 1) / numThreads;
+    vector<uint16_t> bucketOf(n);
+    vector<size_t> counts(numThreads * numClasses, 0);
+    runOnThreads(numThreads, [&](int t) {
+        const size_t begin = min(n, t * chunk);
+        const size_t end = min(n, begin + chunk);
+        vector<size_t> localCounts(numClasses, 0);
+        for (size_t i = begin; i < end; i++) {
+            size_t j = 1;
+            for (int level = 0; level < logBuckets; level++) {
+                j = 2 * j + (tree[j] < data[i]);   // no branch: the comparison is the next bit
+            }
+            size_t bucket = j - numBuckets;
+            if (equalityBuckets) {
+                // x <= splitters[bucket] already holds, so !(x < splitter) means equal;
+                // the last bucket has no upper splitter and no twin
+                bucket = 2 * bucket + (bucket + 1 < numBuckets && !(data[i] < splitters[bucket]));
+            }
+            bucketOf[i] = static_cast<uint16_t>(bucket);
+            localCounts[bucket]++;
+        }
+        copy(localCounts.begin(), localCounts.end(), counts.begin() + t * numClasses);
+    });
+
+    // Bucket b holds every thread's elements of b, thread 0 first
+    vector<size_t> offsets(numThreads * numClasses);
+    vector<size_t> bucketStart(numClasses + 1);
+    size_t position = 0;
+    for (size_t b = 0; b < numClasses; b++) {
+        bucketStart[b] = position;
+        for (int t = 0; t < numThreads; t++) {
+            offsets[t * numClasses + b] = position;
+            position += counts[t * numClasses + b];
+        }
+    }
+    bucketStart[numClasses] = n;
+
+    // OPTIMIZED: Lock-free scatter into disjoint output ranges
+    vector<T> output(n);
+    runOnThreads(numThreads, [&](int t) {
+        const size_t begin = min(n, t * chunk);
+        const size_t end = min(n, begin + chunk);
+        size_t* next = &offsets[t * numClasses];
+        for (size_t i = begin; i < end; i++) {
+            output[next[bucketOf[i]]++] = data[i];
+        }
+    });
+
+    // OPTIMIZED: Buckets sorted in parallel, handed out dynamically; equality buckets are skipped
+    atomic<size_t> nextBucket(0);
+    runOnThreads(numThreads, [&](int) {
+        for (size_t b = nextBucket++; b < numClasses; b = nextBucket++) {
+            if (equalityBuckets && b % 2 == 1) {
+                continue;
+            }
+            sort(output.begin() + bucketStart[b], output.begin() + bucketStart[b + 1]);
+        }
+    });
+    data.swap(output);
+}
+
+// Order-independent fingerprint: equal for any permutation of the same values
+template <typename T>
+uint64_t multisetChecksum(const vector<T>& values) {
+    uint64_t sum = 0;
+    uint64_t mixed = 0;
+    for (const T& v : values) {
+        uint64_t bits = 0;
+        memcpy(&bits, &v, sizeof(T));
+        sum += bits;
+        mixed += (bits ^ (bits >> 29)) * 0xBF58476D1CE4E5B9ULL;
+    }
+    return sum ^ (mixed << 1);
+}
+
+template <typename T, typename SortFunction>
+double timeSortMs(const vector<T>& original, vector<T>& work, SortFunction sortFunction, bool& correct) {
+    work = original;
+    auto start = high_resolution_clock::now();
+    sortFunction(work);
+    auto end = high_resolution_clock::now();
+    correct = is_sorted(work.begin(), work.end()) && multisetChecksum(work) == multisetChecksum(original);
+    return duration<double, milli>(end - start).count();
+}
+
+void printSortRow(const string& algorithm, int threads, double ms, double quickSortMs, double stdSortMs, bool correct) {
+    cout << "  " << left << setw(22) << algorithm << right << setw(8) << threads << fixed << setprecision(1)
+         << setw(12) << ms << setw(14);
+    if (quickSortMs >= 0) cout << setprecision(2) << quickSortMs / ms;
+    else cout << "n/a";
+    cout << setw(14) << setprecision(2) << stdSortMs / ms << "   " << (correct ? "sorted" : "WRONG") << endl;
+}
+
+// quickSortMs < 0: no quickSortOptimized baseline for this type
+template <typename T>
+void benchmarkSampleSortOn(const string& label, const vector<T>& original, double quickSortMs, bool quickSortCorrect,
+                           int maxThreads) {
+    vector<int> threadCounts;
+    for (int t = 1; t < maxThreads; t *= 2) {
+        threadCounts.push_back(t);
+    }
+    threadCounts.push_back(maxThreads);
+
+    cout << label << " (" << original.size() << " elements, " << original.size() * sizeof(T) / (1024 * 1024) << " MB):" << endl;
+    cout << "  " << left << setw(22) << "Algorithm" << right << setw(8) << "Threads" << setw(12) << "Time (ms)"
+         << setw(14) << "vs quickSort" << setw(14) << "vs std::sort" << endl;
+
+    vector<T> work;
+    bool correct = false;
+    const double stdSortMs = timeSortMs(original, work, [](vector<T>& v) { sort(v.begin(), v.end()); }, correct);
+    if (quickSortMs >= 0) {
+        printSortRow("quickSortOptimized", 1, quickSortMs, quickSortMs, stdSortMs, quickSortCorrect);
+    }
+    printSortRow("std::sort", 1, stdSortMs, quickSortMs, stdSortMs, correct);
+    for (int threads : threadCounts) {
+        const double ms = timeSortMs(original, work, [threads](vector<T>& v) { parallelSampleSort(v, threads); }, correct);
+        printSortRow("parallelSampleSort", threads, ms, quickSortMs, stdSortMs, correct);
+    }
+    cout << endl;
+}
+
+// maxThreads = 0: one thread per hardware thread
+void benchmarkParallelSampleSort(size_t size, int maxThreads = 0) {
+    if (maxThreads <= 0) {
+        maxThreads = max(1, static_cast<int>(thread::hardware_concurrency()));
+    }
+    cout << "=== PARALLEL SAMPLE SORT ===" << endl;
+    cout << "This demonstrates splitting one large sort across all cores" << endl;
+    cout << "Hardware threads: " << thread::hardware_concurrency() << ", testing up to " << maxThreads << endl;
+    cout << endl;
+
+    mt19937_64 gen(RANDOM_SEED);
+    {
+        uniform_int_distribution<int> dis(0, numeric_limits<int>::max());
+        vector<int> integers(size);
+        for (int& v : integers) {
+            v = dis(gen);
+        }
+        vector<int> work;
+        bool quickSortCorrect = false;
+        totalComparisons = 0;
+        totalSwaps = 0;
+        maxRecursionDepth = 0;
+        currentRecursionDepth = 0;
+        const double quickSortMs = timeSortMs(integers, work, [](vector<int>& v) {
+            quickSortOptimized(v, 0, static_cast<int>(v.size()) - 1);
+        }, quickSortCorrect);
+        benchmarkSampleSortOn("Random integers", integers, quickSortMs, quickSortCorrect, maxThreads);
+    }
+    {
+        uniform_real_distribution<double> dis(-1e6, 1e6);
+        vector<double> doubles(size);
+        for (double& v : doubles) {
+            v = dis(gen);
+        }
+        benchmarkSampleSortOn("Random doubles (quickSortOptimized is int-only)", doubles, -1.0, false, maxThreads);
+    }
+    {
+        // Fewer distinct keys than buckets: most splitters repeat, so equality buckets take over.
+        // No quickSortOptimized row: its two-way partition is quadratic here (see three-way quicksort)
+        uniform_int_distribution<int> dis(0, 3);
+        vector<int> duplicates(size);
+        for (int& v : duplicates) {
+            v = dis(gen);
+        }
+        benchmarkSampleSortOn("Duplicate-heavy integers (4 distinct values)", duplicates, -1.0, false, maxThreads);
+    }
+}
+
+/*
+ * SCENARIO 5: SIMD Sorting Networks for Small Partitions
+ * Demonstrates replacing the branchy insertion sort base case with branch-free code
+ *
+ * Insertion sort mispredicts on almost every element of a random partition. A sorting
+ * network does a fixed sequence of compare-exchanges, whatever the data: with AVX2,
+ * one min + max pair compares 8 lanes at once and nothing depends on the outcome.
+ * - Up to 64 ints are loaded into 1, 2, 4 or 8 registers, padded with INT_MAX
+ * - Each register is sorted on its own with an 8-lane bitonic network (6 steps of
+ *   shuffle + min/max + blend)
+ * - Sorted runs are merged pairwise with bitonic merges: reverse one run, min/max
+ *   against the other, then clean each half, until one run of 8 * registers remains
+ * Vector compare-exchanges are not counted in totalComparisons/totalSwaps.
+ * Without AVX2 (e.g. MSVC without /arch:AVX2) the base case stays insertion sort.
+ */
+
+bool useSortingNetworks = true;   // false: insertion sort base case (for comparison)
+
+#ifdef __AVX2__
+// One compare-exchange step at lane distance 1, 2 or 4; lanes set in MAX_LANES keep the larger value
+template <int DISTANCE, int MAX_LANES>
+inline __m256i compareExchangeLanes(__m256i v) {
+    __m256i partner;
+    if (DISTANCE == 1) partner = _mm256_shuffle_epi32(v, _MM_SHUFFLE(2, 3, 0, 1));
+    else if (DISTANCE == 2) partner = _mm256_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2));
+    else partner = _mm256_permute2x128_si256(v, v, 0x01);
+    return _mm256_blend_epi32(_mm256_min_epi32(v, partner), _mm256_max_epi32(v, partner), MAX_LANES);
+}
+
+// Bitonic sort of the 8 lanes of one register
+inline __m256i sortLanes(__m256i v) {
+    v = compareExchangeLanes<1, 0x66>(v);   // pairs: up, down, up, down
+    v = compareExchangeLanes<2, 0x3C>(v);   // halves of 4: up, down
+    v = compareExchangeLanes<1, 0x5A>(v);
+    v = compareExchangeLanes<4, 0xF0>(v);   // all 8 up
+    v = compareExchangeLanes<2, 0xCC>(v);
+    return compareExchangeLanes<1, 0xAA>(v);
+}
+
+// Sorts a bitonic register ascending
+inline __m256i cleanLanes(__m256i v) {
+    v = compareExchangeLanes<4, 0xF0>(v);
+    v = compareExchangeLanes<2, 0xCC>(v);
+    return compareExchangeLanes<1, 0xAA>(v);
+}
+
+inline void compareExchangeRegisters(__m256i& low, __m256i& high) {
+    const __m256i smaller = _mm256_min_epi32(low, high);
+    high = _mm256_max_epi32(low, high);
+    low = smaller;
+}
+
+// Merges the sorted runs run[0..count) and run[count..2*count) into one sorted run
+template <int COUNT>
+inline void mergeRuns(__m256i* run) {
+    const __m256i reverse = _mm256_setr_epi32(7, 6, 5, 4, 3, 2, 1, 0);
+    __m256i* upper = run + COUNT;
+    for (int i = 0; i < COUNT / 2; i++) {
+        swap(upper[i], upper[COUNT - 1 - i]);
+    }
+    for (int i = 0; i < COUNT; i++) {
+        upper[i] = _mm256_permutevar8x32_epi32(upper[i], reverse);
+        compareExchangeRegisters(run[i], upper[i]);
+    }
+    // Both halves are now bitonic: halve the distance across registers, then within each
+    for (int distance = COUNT / 2; distance >= 1; distance /= 2) {
+        for (int i = 0; i < 2 * COUNT; i++) {
+            if ((i & distance) == 0) compareExchangeRegisters(run[i], run[i + distance]);
+        }
+    }
+    for (int i = 0; i < 2 * COUNT; i++) {
+        run[i] = cleanLanes(run[i]);
+    }
+}
+
+// Sorts n <= 8 * REGISTERS ints in place
+template <int REGISTERS>
+void sortingNetworkSort(int* data, int n) {
+    alignas(32) int buffer[8 * REGISTERS];
+    memcpy(buffer, data, n * sizeof(int));
+    fill(buffer + n, buffer + 8 * REGISTERS, numeric_limits<int>::max());
+
+    __m256i run[REGISTERS];
+    for (int i = 0; i < REGISTERS; i++) {
+        run[i] = sortLanes(_mm256_load_si256(reinterpret_cast<const __m256i*>(buffer + 8 * i)));
+    }
+    if (REGISTERS >= 2) for (int i = 0; i < REGISTERS; i += 2) mergeRuns<1>(run + i);
+    if (REGISTERS >= 4) for (int i = 0; i < REGISTERS; i += 4) mergeRuns<2>(run + i);
+    if (REGISTERS >= 8) mergeRuns<4>(run);
+
+    for (int i = 0; i < REGISTERS; i++) {
+        _mm256_store_si256(reinterpret_cast<__m256i*>(buffer + 8 * i), run[i]);
+    }
+    memcpy(data, buffer, n * sizeof(int));
+}
+#endif
+
+// OPTIMIZED: Base case for small partitions (smallest network that fits, padding included)
+void sortSmallPartition(vector<int>& arr, int low, int high) {
+#ifdef __AVX2__
+    const int n = high - low + 1;
+    if (useSortingNetworks && n <= SORTING_NETWORK_THRESHOLD) {
+        int* data = arr.data() + low;
+        if (n <= 8) sortingNetworkSort<1>(data, n);
+        else if (n <= 16) sortingNetworkSort<2>(data, n);
+        else if (n <= 32) sortingNetworkSort<4>(data, n);
+        else sortingNetworkSort<8>(data, n);
+        return;
+    }
+#endif
+    insertionSort(arr, low, high);
+}
+
+// Size that sends a partition to the base case
+int smallPartitionLimit() {
+#ifdef __AVX2__
+    if (useSortingNetworks) return SORTING_NETWORK_THRESHOLD;
+#endif
+    return INSERTION_SORT_THRESHOLD - 1;
+}
+
+// Every size from 1 to 64 against std::sort, on random and low-cardinality data
+bool checkSortingNetworks() {
+    mt19937 gen(RANDOM_SEED);
+    for (int n = 1; n <= SORTING_NETWORK_THRESHOLD; n++) {
+        for (int trial = 0; trial < 200; trial++) {
+            vector<int> values(n);
+            for (int& v : values) {
+                v = trial % 2 ? static_cast<int>(gen()) : static_cast<int>(gen() % 4);
+            }
+            vector<int> expected = values;
+            sort(expected.begin(), expected.end());
+            sortSmallPartition(values, 0, n - 1);
+            if (values != expected) return false;
+        }
+    }
+    return true;
+}
+
+double timeQuickSortMs(const vector<int>& original, vector<int>& work, bool& correct) {
+    double best = 1e30;
+    for (int run = 0; run < 3; run++) {
+        work = original;
+        totalComparisons = 0;
+        totalSwaps = 0;
+        maxRecursionDepth = 0;
+        currentRecursionDepth = 0;
+        auto start = high_resolution_clock::now();
+        quickSortOptimized(work, 0, static_cast<int>(work.size()) - 1);
+        auto end = high_resolution_clock::now();
+        best = min(best, duration<double, milli>(end - start).count());
+    }
+    correct = is_sorted(work.begin(), work.end());
+    return best;
+}
+
+void benchmarkSortingNetworks(int size) {
+    cout << "=== SIMD SORTING NETWORKS FOR SMALL PARTITIONS ===" << endl;
+    cout << "This demonstrates a branch-free base case for quickSortOptimized" << endl;
+#ifndef __AVX2__
+    (void)size;
+    cout << "Built without AVX2: the base case is insertion sort (compile with -mavx2 or /arch:AVX2)" << endl;
+    cout << endl;
+    return;
+#else
+    useSortingNetworks = true;
+    cout << "Network self-check (sizes 1-" << SORTING_NETWORK_THRESHOLD << " vs std::sort): "
+         << (checkSortingNetworks() ? "passed" : "FAILED") << endl;
+    cout << "Array size: " << size << ", best of 3 runs" << endl;
+    cout << "Base case: insertion sort below " << INSERTION_SORT_THRESHOLD << " elements vs AVX2 network up to "
+         << SORTING_NETWORK_THRESHOLD << endl;
+    cout << endl;
+
+    // No organ pipe input: median-of-three goes quadratic on it and the recursion overflows the stack
+    struct Distribution {
+        const char* name;
+        int kind;
+    };
+    const Distribution distributions[] = {
+        { "random", 0 }, { "sorted", 1 }, { "reversed", 2 }, { "nearly sorted (1% swaps)", 3 },
+        { "many duplicates (n/64 values)", 4 },
+    };
+    cout << "  " << left << setw(32) << "Distribution" << right << setw(14) << "insertion ms" << setw(14) << "network ms"
+         << setw(10) << "speedup" << setw(14) << "std::sort ms" << endl;
+
+    mt19937 gen(RANDOM_SEED);
+    vector<int> original(size), work;
+    for (const Distribution& d : distributions) {
+        for (int i = 0; i < size; i++) {
+            switch (d.kind) {
+                case 0: original[i] = static_cast<int>(gen() >> 1); break;
+                case 1: case 3: original[i] = i; break;
+                case 2: original[i] = size - i; break;
+                default: original[i] = static_cast<int>(gen() % max(1, size / 64)); break;
+            }
+        }
+        if (d.kind == 3) {
+            for (int s = 0; s < size / 100; s++) {
+                swap(original[gen() % size], original[gen() % size]);
+            }
+        }
+
+        bool insertionCorrect = false, networkCorrect = false;
+        useSortingNetworks = false;
+        const double insertionMs = timeQuickSortMs(original, work, insertionCorrect);
+        useSortingNetworks = true;
+        const double networkMs = timeQuickSortMs(original, work, networkCorrect);
+        work = original;
+        auto start = high_resolution_clock::now();
+        sort(work.begin(), work.end());
+        const double stdSortMs = duration<double, milli>(high_resolution_clock::now() - start).count();
+
+        cout << "  " << left << setw(32) << d.name << right << fixed << setprecision(1) << setw(14) << insertionMs
+             << setw(14) << networkMs << setw(9) << setprecision(2) << insertionMs / networkMs << "x" << setw(14)
+             << setprecision(1) << stdSortMs << ((insertionCorrect && networkCorrect) ? "" : "   WRONG") << endl;
+    }
+    cout << endl;
+#endif
+}
+
 /*
  * SCENARIO 3: Performance Testing Functions
  */
@@ -422,7 +929,38 @@ void compareAllQuickSortVariants() {
     cout << endl;
 }
 
-int main() {
+// Usage: quicksort-optimized             all scenarios
+//        quicksort-optimized sample [n] [max threads]
+//                                        parallel sample sort benchmark only (default n = 10M,
+//                                        threads up to the hardware count)
+//        quicksort-optimized network [n] sorting network base case benchmark only (default n = 1M)
+int main(int argc, char* argv[]) {
+    if (argc >= 2 && string(argv[1]) == "network") {
+        const int size = argc >= 3 ? atoi(argv[2]) : NETWORK_ARRAY_SIZE;
+        if (size <= 0) {
+            cerr << "Usage: " << argv[0] << " network [number of elements]" << endl;
+            return 1;
+        }
+        benchmarkSortingNetworks(size);
+        return 0;
+    }
+    if (argc >= 2 && string(argv[1]) == "sample") {
+        size_t size = PARALLEL_ARRAY_SIZE;
+        int maxThreads = 0;
+        if (argc >= 3) {
+            size = strtoull(argv[2], nullptr, 10);
+        }
+        if (argc >= 4) {
+            maxThreads = atoi(argv[3]);
+        }
+        if (size == 0 || (argc >= 4 && maxThreads <= 0)) {
+            cerr << "Usage: " << argv[0] << " sample [number of elements] [max threads]" << endl;
+            return 1;
+        }
+        benchmarkParallelSampleSort(size, maxThreads);
+        return 0;
+    }
+
     cout << "=== OPTIMIZED QUICKSORT PERFORMANCE SOLUTION ===" << endl;
     cout << "This program demonstrates optimized QuickSort implementations:" << endl;
     cout << "1. Optimized QuickSort with median-of-three pivot selection" << endl;
@@ -430,6 +968,8 @@ int main() {
     cout << "3. Insertion sort optimization for small arrays" << endl;
     cout << "4. Tail recursion optimization" << endl;
     cout << "5. Performance comparison between variants" << endl;
+    cout << "6. Parallel sample sort across all cores (" << PARALLEL_ARRAY_SIZE << " elements)" << endl;
+    cout << "7. AVX2 sorting networks as the small-partition base case" << endl;
     cout << endl;
     cout << "Array size: " << ARRAY_SIZE << " elements" << endl;
     cout << "This will demonstrate significant sorting performance improvements!" << endl;
@@ -441,6 +981,8 @@ int main() {
     testWithWorstCaseInput();
     testWithDifferentArraySizes();
     compareAllQuickSortVariants();
+    benchmarkParallelSampleSort(PARALLEL_ARRAY_SIZE);
+    benchmarkSortingNetworks(NETWORK_ARRAY_SIZE);
 
     cout << "=== OVERALL OPTIMIZATION ANALYSIS ===" << endl;
     cout << "1. Run this with Visual Studio Profiler in INSTRUMENTATION mode" << endl;
@@ -457,6 +999,8 @@ int main() {
     cout << "- Insertion sort for small arrays: Optimizes small subproblems" << endl;
     cout << "- Tail recursion optimization: Reduces stack usage" << endl;
     cout << "- Three-way partitioning: Efficient handling of duplicates" << endl;
+    cout << "- Parallel sample sort: Oversampled splitters, per-thread classification, parallel buckets" << endl;
+    cout << "- Sorting networks: Branch-free SIMD base case instead of insertion sort" << endl;
     cout << "- Time complexity improvement: O(n²) -> O(n log n) average case" << endl;
     cout << "- Space complexity optimization: Reduced recursion depth" << endl;
     cout << "- Reduced comparisons: Minimize unnecessary comparisons" << endl;
@@ -11,6 +11,8 @@
  * - Demonstrate compact data formats (JSON vs Binary formats)
  * - Illustrate payload optimization and header minimization
  * - Compare different compression algorithms (gzip, custom)
+ * - Add an entropy coding stage (Huffman) for skewed, non-repetitive data
+ * - Generate binary/JSON serializers from compile-time field descriptors
  * - Show benefits: lower bandwidth, faster loading, energy savings
  *
  * What this demonstrates:
@@ -36,6 +38,17 @@
 #include <thread>
 #include <chrono>
 #include <map>
+#include <queue>
+#include <functional>
+#include <algorithm>
+#include <random>
+#include <iomanip>
+#include <cstdio>
+#include <cstddef>
+#include <tuple>
+#include <utility>
+#include <type_traits>
+#include <initializer_list>
 
 #ifdef _WIN32
 #define _WINSOCK_DEPRECATED_NO_WARNINGS
@@ -54,8 +67,10 @@
 // CONFIGURATION - EASY TOGGLE FOR CLASSROOM DEMONSTRATION
 // =====================================================================================
 
-// Optimization modes: 0=no optimization, 1=deduplication, 2=binary format, 3=compression, 4=all
-int OPTIMIZATION_MODE = 4;  // Set to 0-4 to test different optimization levels
+// Optimization modes: 0=no optimization, 1=deduplication, 2=binary format, 3=compression, 4=all,
+//                     5=entropy coding (Huffman), 6=all + entropy coding, 7=generated binary
+int OPTIMIZATION_MODE = 4;  // Set to 0-7 to test different optimization levels
+const int OPTIMIZATION_MODE_COUNT = 8;
 
 const int SERVER_PORT = 8888;
 const int BUFFER_SIZE = 65536;  // 64KB buffer
@@ -188,6 +203,299 @@ std::vector<uint8_t> decompress(const std::vector<uint8_t>& compressedData) {
     return decompressed;
 }
 
+// =====================================================================================
+// ENTROPY CODING STAGE (canonical Huffman, 4 interleaved streams)
+// =====================================================================================
+//
+// Entropy-coded payload layout (little-endian):
+//   [uint32 originalSize]
+//   [128 bytes: code length of each byte value, two 4-bit lengths per byte]
+//   [uint32 size of stream 0][uint32 size of stream 1][uint32 size of stream 2]
+//   stream 0 | stream 1 | stream 2 | stream 3
+//
+// The input is cut into four equal segments and each one gets its own bit stream.
+// The decoder advances all four streams in the same loop, so the CPU overlaps four
+// independent table lookups instead of waiting on a single serial bit position.
+// Codes are limited to HUFFMAN_MAX_BITS so one table lookup decodes one symbol.
+// Works standalone or after simpleCompress (RLE removes runs, Huffman removes skew).
+
+const int HUFFMAN_MAX_BITS = 11;
+const int HUFFMAN_STREAMS = 4;
+const size_t HUFFMAN_HEADER_SIZE = 4 + 128 + 4 * (HUFFMAN_STREAMS - 1);
+
+struct HuffmanDecodeEntry {
+    uint8_t symbol;
+    uint8_t length;
+};
+
+// Builds code lengths from byte frequencies; flattens the counts until every code fits
+void buildHuffmanCodeLengths(const uint64_t* frequencies, uint8_t* lengths) {
+    std::vector<uint64_t> counts(frequencies, frequencies + 256);
+
+    while (true) {
+        memset(lengths, 0, 256);
+
+        // Leaves are 0..255, internal nodes are numbered from 256 upwards
+        typedef std::pair<uint64_t, int> Node;
+        std::priority_queue<Node, std::vector<Node>, std::greater<Node>> heap;
+        for (int s = 0; s < 256; s++) {
+            if (counts[s] > 0) heap.push(Node(counts[s], s));
+        }
+
+        if (heap.empty()) return;
+        if (heap.size() == 1) {
+            lengths[heap.top().second] = 1;
+            return;
+        }
+
+        std::vector<int> parent(512, -1);
+        int nextNode = 256;
+        while (heap.size() > 1) {
+            Node a = heap.top(); heap.pop();
+            Node b = heap.top(); heap.pop();
+            parent[a.second] = nextNode;
+            parent[b.second] = nextNode;
+            heap.push(Node(a.first + b.first, nextNode++));
+        }
+
+        int maxLength = 0;
+        for (int s = 0; s < 256; s++) {
+            if (counts[s] == 0) continue;
+            int depth = 0;
+            for (int n = s; parent[n] != -1; n = parent[n]) depth++;
+            lengths[s] = static_cast<uint8_t>(std::min(depth, 255));
+            maxLength = std::max(maxLength, depth);
+        }
+
+        if (maxLength <= HUFFMAN_MAX_BITS) return;
+
+        for (auto& count : counts) {
+            if (count > 0) count = (count + 1) / 2;
+        }
+    }
+}
+
+// Canonical codes, stored bit-reversed because streams are written LSB first
+void buildHuffmanCodes(const uint8_t* lengths, uint16_t* codes) {
+    int lengthCount[HUFFMAN_MAX_BITS + 1] = { 0 };
+    for (int s = 0; s < 256; s++) {
+        if (lengths[s] > 0) lengthCount[lengths[s]]++;
+    }
+
+    uint16_t nextCode[HUFFMAN_MAX_BITS + 1] = { 0 };
+    uint16_t code = 0;
+    for (int len = 1; len <= HUFFMAN_MAX_BITS; len++) {
+        code = static_cast<uint16_t>((code + lengthCount[len - 1]) << 1);
+        nextCode[len] = code;
+    }
+
+    for (int s = 0; s < 256; s++) {
+        codes[s] = 0;
+        int len = lengths[s];
+        if (len == 0) continue;
+
+        uint16_t canonical = nextCode[len]++;
+        uint16_t reversed = 0;
+        for (int b = 0; b < len; b++) {
+            reversed = static_cast<uint16_t>((reversed << 1) | ((canonical >> b) & 1));
+        }
+        codes[s] = reversed;
+    }
+}
+
+class HuffmanBitWriter {
+private:
+    std::vector<uint8_t>& out;
+    uint64_t bits;
+    int bitCount;
+
+public:
+    explicit HuffmanBitWriter(std::vector<uint8_t>& target) : out(target), bits(0), bitCount(0) {}
+
+    void write(uint32_t code, int length) {
+        bits |= static_cast<uint64_t>(code) << bitCount;
+        bitCount += length;
+        if (bitCount >= 32) {
+            for (int i = 0; i < 4; i++) {
+                out.push_back(static_cast<uint8_t>(bits >> (8 * i)));
+            }
+            bits >>= 32;
+            bitCount -= 32;
+        }
+    }
+
+    void flush() {
+        while (bitCount > 0) {
+            out.push_back(static_cast<uint8_t>(bits));
+            bits >>= 8;
+            bitCount -= 8;
+        }
+        bitCount = 0;
+    }
+};
+
+struct HuffmanBitReader {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+    uint64_t bits;
+    int bitCount;
+
+    HuffmanBitReader() : data(nullptr), size(0), pos(0), bits(0), bitCount(0) {}
+    HuffmanBitReader(const uint8_t* src, size_t srcSize) : data(src), size(srcSize), pos(0), bits(0), bitCount(0) {}
+
+    // Tops the bit buffer up to at least 56 bits (zero-padded past the end of the stream)
+    void refill() {
+        if (pos + 8 <= size) {
+            uint64_t word;
+            memcpy(&word, data + pos, 8);
+            bits |= word << bitCount;
+            pos += (63 - bitCount) >> 3;
+            bitCount |= 56;
+        } else {
+            while (bitCount <= 56) {
+                uint64_t byte = pos < size ? data[pos] : 0;
+                bits |= byte << bitCount;
+                pos++;
+                bitCount += 8;
+            }
+        }
+    }
+};
+
+inline uint8_t decodeHuffmanSymbol(HuffmanBitReader& reader, const HuffmanDecodeEntry* table) {
+    const HuffmanDecodeEntry& entry = table[reader.bits & ((1u << HUFFMAN_MAX_BITS) - 1)];
+    reader.bits >>= entry.length;
+    reader.bitCount -= entry.length;
+    return entry.symbol;
+}
+
+std::vector<uint8_t> huffmanEncode(const std::vector<uint8_t>& data) {
+    uint64_t frequencies[256] = { 0 };
+    for (uint8_t byte : data) frequencies[byte]++;
+
+    uint8_t lengths[256];
+    uint16_t codes[256];
+    buildHuffmanCodeLengths(frequencies, lengths);
+    buildHuffmanCodes(lengths, codes);
+
+    std::vector<uint8_t> encoded(HUFFMAN_HEADER_SIZE, 0);
+    uint32_t originalSize = static_cast<uint32_t>(data.size());
+    memcpy(encoded.data(), &originalSize, 4);
+    for (int s = 0; s < 256; s += 2) {
+        encoded[4 + s / 2] = static_cast<uint8_t>(lengths[s] | (lengths[s + 1] << 4));
+    }
+
+    // Four segments, one bit stream each
+    size_t segment = (data.size() + HUFFMAN_STREAMS - 1) / HUFFMAN_STREAMS;
+    size_t streamStart = encoded.size();
+    for (int k = 0; k < HUFFMAN_STREAMS; k++) {
+        size_t begin = std::min(data.size(), k * segment);
+        size_t end = std::min(data.size(), begin + segment);
+
+        HuffmanBitWriter writer(encoded);
+        for (size_t i = begin; i < end; i++) {
+            writer.write(codes[data[i]], lengths[data[i]]);
+        }
+        writer.flush();
+
+        if (k < HUFFMAN_STREAMS - 1) {
+            uint32_t streamSize = static_cast<uint32_t>(encoded.size() - streamStart);
+            memcpy(encoded.data() + 4 + 128 + 4 * k, &streamSize, 4);
+        }
+        streamStart = encoded.size();
+    }
+
+    return encoded;
+}
+
+bool huffmanDecode(const std::vector<uint8_t>& encoded, std::vector<uint8_t>& output) {
+    if (encoded.size() < HUFFMAN_HEADER_SIZE) return false;
+
+    uint32_t originalSize;
+    memcpy(&originalSize, encoded.data(), 4);
+
+    // Code table from the header; reject lengths that over-subscribe the code space
+    uint8_t lengths[256];
+    uint32_t kraft = 0;
+    for (int s = 0; s < 256; s += 2) {
+        lengths[s] = encoded[4 + s / 2] & 0x0F;
+        lengths[s + 1] = encoded[4 + s / 2] >> 4;
+    }
+    for (int s = 0; s < 256; s++) {
+        if (lengths[s] > HUFFMAN_MAX_BITS) return false;
+        if (lengths[s] > 0) kraft += 1u << (HUFFMAN_MAX_BITS - lengths[s]);
+    }
+    if (kraft > (1u << HUFFMAN_MAX_BITS)) return false;
+
+    uint16_t codes[256];
+    buildHuffmanCodes(lengths, codes);
+
+    // Unused slots (only possible with a single-symbol table) decode as 1-bit zeros
+    std::vector<HuffmanDecodeEntry> table(1u << HUFFMAN_MAX_BITS, HuffmanDecodeEntry{ 0, 1 });
+    for (int s = 0; s < 256; s++) {
+        if (lengths[s] == 0) continue;
+        for (uint32_t fill = codes[s]; fill < table.size(); fill += 1u << lengths[s]) {
+            table[fill].symbol = static_cast<uint8_t>(s);
+            table[fill].length = lengths[s];
+        }
+    }
+
+    // Locate the four streams
+    size_t streamOffset[HUFFMAN_STREAMS];
+    size_t streamSize[HUFFMAN_STREAMS];
+    size_t offset = HUFFMAN_HEADER_SIZE;
+    for (int k = 0; k < HUFFMAN_STREAMS - 1; k++) {
+        uint32_t size;
+        memcpy(&size, encoded.data() + 4 + 128 + 4 * k, 4);
+        streamOffset[k] = offset;
+        streamSize[k] = size;
+        offset += size;
+    }
+    if (offset > encoded.size()) return false;
+    streamOffset[HUFFMAN_STREAMS - 1] = offset;
+    streamSize[HUFFMAN_STREAMS - 1] = encoded.size() - offset;
+
+    output.resize(originalSize);
+    size_t segment = (originalSize + HUFFMAN_STREAMS - 1) / HUFFMAN_STREAMS;
+
+    HuffmanBitReader readers[HUFFMAN_STREAMS];
+    uint8_t* out[HUFFMAN_STREAMS];
+    size_t segmentLength[HUFFMAN_STREAMS];
+    for (int k = 0; k < HUFFMAN_STREAMS; k++) {
+        readers[k] = HuffmanBitReader(encoded.data() + streamOffset[k], streamSize[k]);
+        size_t begin = std::min<size_t>(originalSize, k * segment);
+        segmentLength[k] = std::min<size_t>(originalSize, begin + segment) - begin;
+        out[k] = output.data() + begin;
+    }
+
+    // Hot loop: one refill covers 5 symbols of at most 11 bits for every stream
+    size_t common = segmentLength[HUFFMAN_STREAMS - 1];
+    size_t i = 0;
+    for (; i + 5 <= common; i += 5) {
+        readers[0].refill();
+        readers[1].refill();
+        readers[2].refill();
+        readers[3].refill();
+        for (int j = 0; j < 5; j++) {
+            out[0][i + j] = decodeHuffmanSymbol(readers[0], table.data());
+            out[1][i + j] = decodeHuffmanSymbol(readers[1], table.data());
+            out[2][i + j] = decodeHuffmanSymbol(readers[2], table.data());
+            out[3][i + j] = decodeHuffmanSymbol(readers[3], table.data());
+        }
+    }
+
+    // Tails: the last segment can be shorter than the others
+    for (int k = 0; k < HUFFMAN_STREAMS; k++) {
+        for (size_t t = i; t < segmentLength[k]; t++) {
+            if (readers[k].bitCount < HUFFMAN_MAX_BITS) readers[k].refill();
+            out[k][t] = decodeHuffmanSymbol(readers[k], table.data());
+        }
+    }
+
+    return true;
+}
+
 // =====================================================================================
 // DATA FORMAT CONVERTERS
 // =====================================================================================
@@ -235,7 +543,7 @@ std::vector<uint8_t> userDataToBinary(const std::vector<UserData>& users) {
         
         // Department length + department
         uint32_t deptLen = static_cast<uint32_t>(user.department.length());
-        binary.insert(binary.end(), (uint8_t*)&emailLen, (uint8_t*)&emailLen + 4);
+        binary.insert(binary.end(), (uint8_t*)&deptLen, (uint8_t*)&deptLen + 4);
         binary.insert(binary.end(), user.department.begin(), user.department.end());
         
         // Salary (8 bytes)
@@ -283,6 +591,256 @@ std::vector<uint8_t> userDataToOptimizedBinary(const std::vector<UserData>& user
     return binary;
 }
 
+// =====================================================================================
+// GENERATED SERIALIZERS (compile-time field descriptors)
+// =====================================================================================
+//
+// Each record type lists its fields once in a RecordDescriptor specialization.
+// Encoders, decoders and the JSON writer are generated from that list, so a field
+// can no longer be written with the wrong length (see the old deptLen bug).
+//
+// Generated wire layout per record:
+//   [fixed run: every fixed-size field back to back, size known at compile time]
+//   [variable fields: varint length + bytes, in declaration order]
+// The fixed run is grown with a single resize and filled with memcpy, and the decoder
+// bounds-checks it once per record instead of once per field.
+
+template<typename T, typename M>
+struct FixedField {
+    static constexpr bool isFixed = true;
+    static constexpr size_t wireSize = sizeof(M);
+    const char* name;
+    M T::*member;
+};
+
+template<typename T>
+struct StringField {
+    static constexpr bool isFixed = false;
+    static constexpr size_t wireSize = 0;
+    const char* name;
+    std::string T::*member;
+};
+
+template<typename T, typename M>
+constexpr FixedField<T, M> field(const char* name, M T::*member) {
+    return FixedField<T, M>{ name, member };
+}
+
+template<typename T>
+constexpr StringField<T> field(const char* name, std::string T::*member) {
+    return StringField<T>{ name, member };
+}
+
+template<typename T>
+struct RecordDescriptor;  // specialized per record type below
+
+template<>
+struct RecordDescriptor<UserData> {
+    static const auto& fields() {
+        static const auto list = std::make_tuple(
+            field("id", &UserData::id),
+            field("name", &UserData::name),
+            field("email", &UserData::email),
+            field("department", &UserData::department),
+            field("salary", &UserData::salary),
+            field("active", &UserData::active));
+        return list;
+    }
+};
+
+template<>
+struct RecordDescriptor<OptimizedUserData> {
+    static const auto& fields() {
+        static const auto list = std::make_tuple(
+            field("id", &OptimizedUserData::id),
+            field("name_id", &OptimizedUserData::name_id),
+            field("email_id", &OptimizedUserData::email_id),
+            field("dept_id", &OptimizedUserData::dept_id),
+            field("salary", &OptimizedUserData::salary),
+            field("active", &OptimizedUserData::active));
+        return list;
+    }
+};
+
+constexpr size_t sumWireSizes(std::initializer_list<size_t> sizes) {
+    size_t total = 0;
+    for (size_t size : sizes) total += size;
+    return total;
+}
+
+template<typename Tuple>
+struct FixedRunSize;
+
+template<typename... Fields>
+struct FixedRunSize<std::tuple<Fields...>> {
+    static constexpr size_t value = sumWireSizes({ Fields::wireSize..., 0 });
+};
+
+template<typename Tuple, typename F, size_t... I>
+void forEachFieldImpl(const Tuple& fields, F&& func, std::index_sequence<I...>) {
+    int expand[] = { 0, (func(std::get<I>(fields)), 0)... };
+    (void)expand;
+}
+
+template<typename... Fields, typename F>
+void forEachField(const std::tuple<Fields...>& fields, F&& func) {
+    forEachFieldImpl(fields, func, std::index_sequence_for<Fields...>());
+}
+
+inline void writeVarint(std::vector<uint8_t>& out, uint64_t value) {
+    while (value >= 0x80) {
+        out.push_back(static_cast<uint8_t>(value | 0x80));
+        value >>= 7;
+    }
+    out.push_back(static_cast<uint8_t>(value));
+}
+
+inline bool readVarint(const uint8_t*& p, const uint8_t* end, uint64_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 64 && p < end; shift += 7) {
+        uint8_t byte = *p++;
+        value |= static_cast<uint64_t>(byte & 0x7F) << shift;
+        if ((byte & 0x80) == 0) return true;
+    }
+    return false;
+}
+
+// Fixed fields: raw memcpy (bool is normalized to 0/1 so decoding never creates an invalid bool)
+template<typename T, typename M>
+void writeFixedField(const FixedField<T, M>& f, const T& record, uint8_t*& p) {
+    memcpy(p, &(record.*f.member), sizeof(M));
+    p += sizeof(M);
+}
+
+template<typename T>
+void writeFixedField(const FixedField<T, bool>& f, const T& record, uint8_t*& p) {
+    *p++ = (record.*f.member) ? 1 : 0;
+}
+
+template<typename T>
+void writeFixedField(const StringField<T>&, const T&, uint8_t*&) {}
+
+template<typename T, typename M>
+void readFixedField(const FixedField<T, M>& f, T& record, const uint8_t*& p) {
+    memcpy(&(record.*f.member), p, sizeof(M));
+    p += sizeof(M);
+}
+
+template<typename T>
+void readFixedField(const FixedField<T, bool>& f, T& record, const uint8_t*& p) {
+    record.*f.member = (*p++ != 0);
+}
+
+template<typename T>
+void readFixedField(const StringField<T>&, T&, const uint8_t*&) {}
+
+// Variable fields: varint length prefix + bytes
+template<typename T, typename M>
+void writeVariableField(const FixedField<T, M>&, const T&, std::vector<uint8_t>&) {}
+
+template<typename T>
+void writeVariableField(const StringField<T>& f, const T& record, std::vector<uint8_t>& out) {
+    const std::string& value = record.*f.member;
+    writeVarint(out, value.size());
+    out.insert(out.end(), value.begin(), value.end());
+}
+
+template<typename T, typename M>
+bool readVariableField(const FixedField<T, M>&, T&, const uint8_t*&, const uint8_t*) { return true; }
+
+template<typename T>
+bool readVariableField(const StringField<T>& f, T& record, const uint8_t*& p, const uint8_t* end) {
+    uint64_t length;
+    if (!readVarint(p, end, length) || length > static_cast<uint64_t>(end - p)) return false;
+    (record.*f.member).assign(reinterpret_cast<const char*>(p), static_cast<size_t>(length));
+    p += length;
+    return true;
+}
+
+template<typename T>
+void encodeRecord(const T& record, std::vector<uint8_t>& out) {
+    const auto& fields = RecordDescriptor<T>::fields();
+    const size_t fixedSize = FixedRunSize<typename std::decay<decltype(fields)>::type>::value;
+
+    size_t start = out.size();
+    out.resize(start + fixedSize);
+    uint8_t* p = out.data() + start;
+    forEachField(fields, [&](const auto& f) { writeFixedField(f, record, p); });
+    forEachField(fields, [&](const auto& f) { writeVariableField(f, record, out); });
+}
+
+template<typename T>
+bool decodeRecord(const uint8_t*& p, const uint8_t* end, T& record) {
+    const auto& fields = RecordDescriptor<T>::fields();
+    const size_t fixedSize = FixedRunSize<typename std::decay<decltype(fields)>::type>::value;
+
+    if (static_cast<size_t>(end - p) < fixedSize) return false;
+    forEachField(fields, [&](const auto& f) { readFixedField(f, record, p); });
+
+    bool ok = true;
+    forEachField(fields, [&](const auto& f) { ok = ok && readVariableField(f, record, p, end); });
+    return ok;
+}
+
+template<typename T>
+std::vector<uint8_t> encodeRecords(const std::vector<T>& records) {
+    std::vector<uint8_t> out;
+    out.reserve(records.size() * (FixedRunSize<typename std::decay<decltype(RecordDescriptor<T>::fields())>::type>::value + 32));
+    writeVarint(out, records.size());
+    for (const auto& record : records) {
+        encodeRecord(record, out);
+    }
+    return out;
+}
+
+template<typename T>
+bool decodeRecords(const std::vector<uint8_t>& data, std::vector<T>& records) {
+    const uint8_t* p = data.data();
+    const uint8_t* end = p + data.size();
+
+    uint64_t count;
+    if (!readVarint(p, end, count) || count > data.size()) return false;
+
+    records.resize(static_cast<size_t>(count));
+    for (auto& record : records) {
+        if (!decodeRecord(p, end, record)) return false;
+    }
+    return p == end;
+}
+
+// JSON values, formatted exactly like the hand-written userDataToJSON
+inline void appendJsonValue(std::string& json, bool value) { json += value ? "true" : "false"; }
+inline void appendJsonValue(std::string& json, const std::string& value) { json += "\"" + value + "\""; }
+
+template<typename M>
+void appendJsonValue(std::string& json, const M& value) { json += std::to_string(value); }
+
+template<typename T>
+std::string recordsToJSON(const std::vector<T>& records, const char* arrayName) {
+    std::string json = "{\"";
+    json += arrayName;
+    json += "\":[";
+
+    const auto& fields = RecordDescriptor<T>::fields();
+    for (size_t i = 0; i < records.size(); i++) {
+        if (i > 0) json += ",";
+        json += "{";
+        bool first = true;
+        forEachField(fields, [&](const auto& f) {
+            if (!first) json += ",";
+            first = false;
+            json += "\"";
+            json += f.name;
+            json += "\":";
+            appendJsonValue(json, records[i].*f.member);
+        });
+        json += "}";
+    }
+
+    json += "]}";
+    return json;
+}
+
 // =====================================================================================
 // NETWORK UTILITIES
 // =====================================================================================
@@ -381,7 +939,7 @@ int createClientSocket() {
 
 void runServer() {
     std::cout << "\n=== DATA OPTIMIZATION DEMO SERVER ===" << std::endl;
-    std::cout << "Mode: " << OPTIMIZATION_MODE << " (0=None, 1=Dedup, 2=Binary, 3=Compress, 4=All)" << std::endl;
+    std::cout << "Mode: " << OPTIMIZATION_MODE << " (0=None, 1=Dedup, 2=Binary, 3=Compress, 4=All, 5=Entropy, 6=All+Entropy, 7=Generated)" << std::endl;
     std::cout << "Listening on port: " << SERVER_PORT << std::endl;
     std::cout << "Monitor with Wireshark on 127.0.0.1:" << SERVER_PORT << std::endl;
     std::cout << "=====================================" << std::endl;
@@ -459,6 +1017,18 @@ void runServer() {
             std::cout << "Mode: ALL OPTIMIZATIONS" << std::endl;
             std::cout << "Maximum optimization applied!" << std::endl;
             break;
+        case 5:
+            std::cout << "Mode: ENTROPY CODING" << std::endl;
+            std::cout << "Skewed byte distribution has been Huffman coded!" << std::endl;
+            break;
+        case 6:
+            std::cout << "Mode: ALL OPTIMIZATIONS + ENTROPY CODING" << std::endl;
+            std::cout << "RLE output has been Huffman coded!" << std::endl;
+            break;
+        case 7:
+            std::cout << "Mode: GENERATED BINARY SERIALIZER" << std::endl;
+            std::cout << "Encoder was generated from compile-time field descriptors!" << std::endl;
+            break;
     }
 
     close(clientSocket);
@@ -493,7 +1063,7 @@ std::vector<UserData> generateTestData() {
 
 void runClient() {
     std::cout << "\n=== DATA OPTIMIZATION DEMO CLIENT ===" << std::endl;
-    std::cout << "Mode: " << OPTIMIZATION_MODE << " (0=None, 1=Dedup, 2=Binary, 3=Compress, 4=All)" << std::endl;
+    std::cout << "Mode: " << OPTIMIZATION_MODE << " (0=None, 1=Dedup, 2=Binary, 3=Compress, 4=All, 5=Entropy, 6=All+Entropy, 7=Generated)" << std::endl;
     std::cout << "Connecting to server on port: " << SERVER_PORT << std::endl;
     std::cout << "====================================" << std::endl;
 
@@ -564,8 +1134,9 @@ void runClient() {
             std::cout << "Compressed size: " << dataToSend.size() << " bytes" << std::endl;
             break;
         }
-        case 4: { // All optimizations
-            std::cout << "\nUsing ALL optimizations..." << std::endl;
+        case 4:   // All optimizations
+        case 6: { // All optimizations + entropy coding
+            std::cout << "\nUsing ALL optimizations" << (OPTIMIZATION_MODE == 6 ? " + entropy coding" : "") << "..." << std::endl;
             std::string json = userDataToJSON(users);
             originalSize = json.length();
             
@@ -589,12 +1160,39 @@ void runClient() {
             combined.insert(combined.end(), binary.begin(), binary.end());
             
             dataToSend = simpleCompress(combined);
+            if (OPTIMIZATION_MODE == 6) {
+                std::cout << "RLE size before entropy coding: " << dataToSend.size() << " bytes" << std::endl;
+                dataToSend = huffmanEncode(dataToSend);
+            }
             
             std::cout << "Original JSON size: " << originalSize << " bytes" << std::endl;
             std::cout << "Fully optimized size: " << dataToSend.size() << " bytes" << std::endl;
             std::cout << "Dictionary entries: " << dedup.getDictionarySize() << std::endl;
             break;
         }
+        case 5: { // Entropy coding only
+            std::cout << "\nUsing entropy coding (Huffman) optimization..." << std::endl;
+            std::string json = userDataToJSON(users);
+            originalSize = json.length();
+            std::vector<uint8_t> jsonBytes(json.begin(), json.end());
+            dataToSend = huffmanEncode(jsonBytes);
+            
+            std::cout << "Original size: " << originalSize << " bytes" << std::endl;
+            std::cout << "Huffman coded size: " << dataToSend.size() << " bytes (includes "
+                      << HUFFMAN_HEADER_SIZE << "-byte code table header)" << std::endl;
+            break;
+        }
+        case 7: { // Generated binary serializer
+            std::cout << "\nUsing generated binary serializer..." << std::endl;
+            std::string json = userDataToJSON(users);
+            originalSize = json.length();
+            dataToSend = encodeRecords(users);
+            
+            std::cout << "JSON size: " << originalSize << " bytes" << std::endl;
+            std::cout << "Hand-written binary size: " << userDataToBinary(users).size() << " bytes" << std::endl;
+            std::cout << "Generated binary size: " << dataToSend.size() << " bytes" << std::endl;
+            break;
+        }
     }
 
     // Connect to server and send data
@@ -636,6 +1234,255 @@ void runClient() {
     close(clientSocket);
 }
 
+// =====================================================================================
+// ENTROPY CODING BENCHMARK
+// =====================================================================================
+
+std::vector<uint8_t> generateTextCorpus(size_t size) {
+    static const char* words[] = {
+        "the", "of", "and", "to", "in", "a", "is", "that", "for", "it", "as", "was", "with",
+        "network", "bandwidth", "latency", "compression", "payload", "header", "server",
+        "client", "request", "response", "profiling", "performance", "optimization"
+    };
+    const size_t wordCount = sizeof(words) / sizeof(words[0]);
+
+    std::mt19937 rng(42);
+    // Skewed word choice: low indexes (common words) are picked far more often
+    std::geometric_distribution<int> wordDist(0.15);
+    std::uniform_int_distribution<int> sentenceDist(6, 18);
+
+    std::string text;
+    text.reserve(size + 64);
+    while (text.size() < size) {
+        int sentenceLength = sentenceDist(rng);
+        for (int w = 0; w < sentenceLength; w++) {
+            text += words[std::min<size_t>(wordDist(rng), wordCount - 1)];
+            text += (w + 1 < sentenceLength) ? " " : ". ";
+        }
+    }
+    text.resize(size);
+    return std::vector<uint8_t>(text.begin(), text.end());
+}
+
+std::vector<uint8_t> generateJsonCorpus(size_t size) {
+    std::vector<std::string> departments = {"Engineering", "Marketing", "Sales", "HR", "Finance"};
+    std::vector<std::string> domains = {"company.com", "corp.net", "business.org"};
+
+    std::vector<UserData> users;
+    std::string json;
+    for (int i = 1; json.size() < size; i++) {
+        UserData user;
+        user.id = i;
+        user.name = "User" + std::to_string(i);
+        user.email = "user" + std::to_string(i) + "@" + domains[i % domains.size()];
+        user.department = departments[i % departments.size()];
+        user.salary = 50000.0 + (i % 500) * 137.5;
+        user.active = (i % 10 != 0);
+        users.push_back(user);
+
+        if (users.size() == 1000) {
+            json += userDataToJSON(users);
+            users.clear();
+        }
+    }
+    json.resize(size);
+    return std::vector<uint8_t>(json.begin(), json.end());
+}
+
+std::vector<uint8_t> generateNumericTableCorpus(size_t size) {
+    std::mt19937 rng(7);
+    std::normal_distribution<double> priceDist(100.0, 15.0);
+    std::uniform_int_distribution<int> qtyDist(1, 500);
+
+    std::string table = "timestamp,price,quantity,side\n";
+    long long timestamp = 1700000000000LL;
+    char line[96];
+    while (table.size() < size) {
+        timestamp += qtyDist(rng) % 20;
+        snprintf(line, sizeof(line), "%lld,%.2f,%d,%s\n", timestamp, priceDist(rng), qtyDist(rng),
+            (qtyDist(rng) & 1) ? "BUY" : "SELL");
+        table += line;
+    }
+    table.resize(size);
+    return std::vector<uint8_t>(table.begin(), table.end());
+}
+
+void runEntropyCodingBenchmark() {
+    const size_t corpusSize = 8 * 1024 * 1024;  // 8MB per corpus
+    const int iterations = 5;
+
+    std::cout << "\n=== ENTROPY CODING BENCHMARK (Huffman, 4 interleaved streams) ===" << std::endl;
+    std::cout << "Corpus size: " << (corpusSize / (1024 * 1024)) << " MB, decode time is best of "
+              << iterations << " runs" << std::endl;
+    std::cout << "\nCorpus       | RLE ratio | Huffman ratio | RLE+Huffman ratio | Encode MB/s | Decode GB/s" << std::endl;
+    std::cout << "-------------+-----------+---------------+-------------------+-------------+------------" << std::endl;
+
+    struct Corpus {
+        const char* name;
+        std::vector<uint8_t> data;
+    };
+    std::vector<Corpus> corpora;
+    corpora.push_back({ "text", generateTextCorpus(corpusSize) });
+    corpora.push_back({ "json", generateJsonCorpus(corpusSize) });
+    corpora.push_back({ "numeric csv", generateNumericTableCorpus(corpusSize) });
+
+    for (const auto& corpus : corpora) {
+        const std::vector<uint8_t>& data = corpus.data;
+
+        std::vector<uint8_t> rle = simpleCompress(data);
+        std::vector<uint8_t> rleHuffman = huffmanEncode(rle);
+
+        auto start = std::chrono::high_resolution_clock::now();
+        std::vector<uint8_t> huffman = huffmanEncode(data);
+        double encodeSeconds = std::chrono::duration<double>(
+            std::chrono::high_resolution_clock::now() - start).count();
+
+        double bestDecode = 1e9;
+        bool verified = true;
+        std::vector<uint8_t> decoded;
+        for (int it = 0; it < iterations; it++) {
+            start = std::chrono::high_resolution_clock::now();
+            bool ok = huffmanDecode(huffman, decoded);
+            bestDecode = std::min(bestDecode, std::chrono::duration<double>(
+                std::chrono::high_resolution_clock::now() - start).count());
+            verified = verified && ok && decoded == data;
+        }
+
+        std::vector<uint8_t> rleRestored;
+        verified = verified && huffmanDecode(rleHuffman, rleRestored) && rleRestored == rle;
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << std::left << std::setw(12) << corpus.name << std::right << " | "
+                  << std::setw(8) << (100.0 * rle.size() / data.size()) << "% | "
+                  << std::setw(12) << (100.0 * huffman.size() / data.size()) << "% | "
+                  << std::setw(16) << (100.0 * rleHuffman.size() / data.size()) << "% | "
+                  << std::setw(11) << (data.size() / (1024.0 * 1024.0) / encodeSeconds) << " | "
+                  << std::setprecision(2)
+                  << std::setw(10) << (data.size() / 1e9 / bestDecode)
+                  << (verified ? "" : "  MISMATCH!") << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+    }
+
+    std::cout << "\nRatios are compressed size as % of the original (lower is better)." << std::endl;
+    std::cout << "RLE barely helps non-repetitive data; Huffman exploits the skewed byte distribution." << std::endl;
+}
+
+// =====================================================================================
+// SERIALIZER BENCHMARK (hand-written vs generated)
+// =====================================================================================
+
+std::vector<UserData> generateLargeTestData(int count) {
+    std::vector<std::string> departments = {"Engineering", "Marketing", "Sales", "HR", "Finance"};
+    std::vector<std::string> domains = {"company.com", "corp.net", "business.org"};
+
+    std::vector<UserData> users;
+    users.reserve(count);
+    for (int i = 1; i <= count; i++) {
+        UserData user;
+        user.id = i;
+        user.name = "User" + std::to_string(i);
+        user.email = "user" + std::to_string(i) + "@" + domains[i % domains.size()];
+        user.department = departments[i % departments.size()];
+        user.salary = 50000.0 + (i * 1000.0);
+        user.active = (i % 10 != 0);
+        users.push_back(user);
+    }
+    return users;
+}
+
+std::vector<OptimizedUserData> toOptimizedUserData(const std::vector<UserData>& users, DeduplicationManager& dedup) {
+    std::vector<OptimizedUserData> optimized;
+    optimized.reserve(users.size());
+    for (const auto& user : users) {
+        OptimizedUserData record;
+        record.id = user.id;
+        record.name_id = dedup.addString(user.name);
+        record.email_id = dedup.addString(user.email);
+        record.dept_id = dedup.addString(user.department);
+        record.salary = user.salary;
+        record.active = user.active;
+        optimized.push_back(record);
+    }
+    return optimized;
+}
+
+template<typename F>
+double bestOfMs(int iterations, F&& func) {
+    double best = 1e300;
+    for (int it = 0; it < iterations; it++) {
+        auto start = std::chrono::high_resolution_clock::now();
+        func();
+        best = std::min(best, std::chrono::duration<double, std::milli>(
+            std::chrono::high_resolution_clock::now() - start).count());
+    }
+    return best;
+}
+
+void printSerializerRow(const char* name, double handMs, size_t handBytes, double generatedMs, size_t generatedBytes) {
+    std::cout << std::fixed << std::setprecision(2)
+              << std::left << std::setw(22) << name << std::right
+              << " | " << std::setw(9) << handMs << " ms " << std::setw(9) << handBytes << " B"
+              << " | " << std::setw(9) << generatedMs << " ms " << std::setw(9) << generatedBytes << " B"
+              << " | " << std::setw(5) << (handMs / generatedMs) << "x" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+}
+
+void runSerializerBenchmark() {
+    const int recordCount = 100000;
+    const int iterations = 5;
+
+    std::cout << "\n=== SERIALIZER BENCHMARK (hand-written vs generated from field descriptors) ===" << std::endl;
+    std::cout << recordCount << " records, best of " << iterations << " runs" << std::endl;
+
+    std::vector<UserData> users = generateLargeTestData(recordCount);
+    DeduplicationManager dedup;
+    std::vector<OptimizedUserData> optimized = toOptimizedUserData(users, dedup);  // warms the dictionary
+
+    std::cout << "\nFormat                 |    Hand-written encode    |     Generated encode      | Speedup" << std::endl;
+    std::cout << "-----------------------+---------------------------+---------------------------+--------" << std::endl;
+
+    std::string handJson, generatedJson;
+    double handJsonMs = bestOfMs(iterations, [&]() { handJson = userDataToJSON(users); });
+    double generatedJsonMs = bestOfMs(iterations, [&]() { generatedJson = recordsToJSON(users, "users"); });
+    printSerializerRow("UserData JSON", handJsonMs, handJson.size(), generatedJsonMs, generatedJson.size());
+
+    std::vector<uint8_t> handBinary, generatedBinary;
+    double handBinaryMs = bestOfMs(iterations, [&]() { handBinary = userDataToBinary(users); });
+    double generatedBinaryMs = bestOfMs(iterations, [&]() { generatedBinary = encodeRecords(users); });
+    printSerializerRow("UserData binary", handBinaryMs, handBinary.size(), generatedBinaryMs, generatedBinary.size());
+
+    std::vector<uint8_t> handOptimized, generatedOptimized;
+    double handOptimizedMs = bestOfMs(iterations, [&]() { handOptimized = userDataToOptimizedBinary(users, dedup); });
+    double generatedOptimizedMs = bestOfMs(iterations, [&]() {
+        generatedOptimized = encodeRecords(toOptimizedUserData(users, dedup));
+    });
+    printSerializerRow("OptimizedUserData", handOptimizedMs, handOptimized.size(), generatedOptimizedMs, generatedOptimized.size());
+
+    // Generated decoders (the hand-written formats never had one)
+    std::vector<UserData> decodedUsers;
+    std::vector<OptimizedUserData> decodedOptimized;
+    bool usersOk = false, optimizedOk = false;
+    double decodeUsersMs = bestOfMs(iterations, [&]() { usersOk = decodeRecords(generatedBinary, decodedUsers); });
+    double decodeOptimizedMs = bestOfMs(iterations, [&]() { optimizedOk = decodeRecords(generatedOptimized, decodedOptimized); });
+
+    for (size_t i = 0; usersOk && i < users.size(); i++) {
+        usersOk = decodedUsers[i].id == users[i].id && decodedUsers[i].name == users[i].name &&
+                  decodedUsers[i].email == users[i].email && decodedUsers[i].department == users[i].department &&
+                  decodedUsers[i].salary == users[i].salary && decodedUsers[i].active == users[i].active;
+    }
+    for (size_t i = 0; optimizedOk && i < optimized.size(); i++) {
+        optimizedOk = memcmp(&decodedOptimized[i], &optimized[i], offsetof(OptimizedUserData, active)) == 0 &&
+                      decodedOptimized[i].active == optimized[i].active;
+    }
+
+    std::cout << "\nGenerated decode: UserData " << decodeUsersMs << " ms ("
+              << (usersOk ? "round-trip OK" : "MISMATCH!") << "), OptimizedUserData " << decodeOptimizedMs << " ms ("
+              << (optimizedOk ? "round-trip OK" : "MISMATCH!") << ")" << std::endl;
+    std::cout << "Generated JSON identical to hand-written JSON: " << (generatedJson == handJson ? "YES" : "NO") << std::endl;
+    std::cout << "\nThe generated binary format groups fixed-size fields into one memcpy run per record" << std::endl;
+    std::cout << "and uses varint length prefixes instead of 4-byte lengths." << std::endl;
+}
+
 // =====================================================================================
 // MAIN PROGRAM
 // =====================================================================================
@@ -655,17 +1502,22 @@ int main() {
     std::cout << "- Show benefits: lower bandwidth, faster loading, energy savings" << std::endl;
     std::cout << std::endl;
     std::cout << "CURRENT MODE: " << OPTIMIZATION_MODE << std::endl;
-    std::cout << "To change mode, modify OPTIMIZATION_MODE variable at line 57" << std::endl;
+    std::cout << "To change mode, modify OPTIMIZATION_MODE variable at line 66" << std::endl;
     std::cout << "  - Mode 0: No optimization (JSON baseline)" << std::endl;
     std::cout << "  - Mode 1: Deduplication (eliminate redundant data)" << std::endl;
     std::cout << "  - Mode 2: Binary format (more efficient than text)" << std::endl;
     std::cout << "  - Mode 3: Compression (reduce data size)" << std::endl;
     std::cout << "  - Mode 4: All optimizations combined" << std::endl;
+    std::cout << "  - Mode 5: Entropy coding (Huffman on JSON)" << std::endl;
+    std::cout << "  - Mode 6: All optimizations + entropy coding" << std::endl;
+    std::cout << "  - Mode 7: Generated binary serializer (field descriptors)" << std::endl;
     std::cout << std::endl;
     std::cout << "CONTROLS:" << std::endl;
     std::cout << "- Press ENTER to send a package" << std::endl;
     std::cout << "- Type 'quit' and press ENTER to exit" << std::endl;
     std::cout << "- Type 'mode' and press ENTER to cycle through optimization modes" << std::endl;
+    std::cout << "- Type 'entropy' and press ENTER to run the entropy coding benchmark" << std::endl;
+    std::cout << "- Type 'serialize' and press ENTER to compare hand-written and generated serializers" << std::endl;
     std::cout << std::endl;
     std::cout << "WIRESHARK MONITORING:" << std::endl;
     std::cout << "- Monitor loopback interface (127.0.0.1)" << std::endl;
@@ -694,13 +1546,24 @@ int main() {
             break;
         }
         else if (userInput == "mode") {
-            OPTIMIZATION_MODE = (OPTIMIZATION_MODE + 1) % 5;
+            OPTIMIZATION_MODE = (OPTIMIZATION_MODE + 1) % OPTIMIZATION_MODE_COUNT;
             std::cout << "Mode changed to: " << OPTIMIZATION_MODE << std::endl;
             std::cout << "  - Mode 0: No optimization" << std::endl;
             std::cout << "  - Mode 1: Deduplication" << std::endl;
             std::cout << "  - Mode 2: Binary format" << std::endl;
             std::cout << "  - Mode 3: Compression" << std::endl;
             std::cout << "  - Mode 4: All optimizations" << std::endl;
+            std::cout << "  - Mode 5: Entropy coding" << std::endl;
+            std::cout << "  - Mode 6: All optimizations + entropy coding" << std::endl;
+            std::cout << "  - Mode 7: Generated binary serializer" << std::endl;
+            continue;
+        }
+        else if (userInput == "entropy") {
+            runEntropyCodingBenchmark();
+            continue;
+        }
+        else if (userInput == "serialize") {
+            runSerializerBenchmark();
             continue;
         }
         else if (userInput.empty() || userInput == "send") {
@@ -710,7 +1573,7 @@ int main() {
             std::cout << "--- PACKAGE #" << packageCount << " COMPLETE ---" << std::endl;
         }
         else {
-            std::cout << "Invalid command. Use ENTER to send, 'quit' to exit, or 'mode' to cycle." << std::endl;
+            std::cout << "Invalid command. Use ENTER to send, 'quit' to exit, 'mode' to cycle, 'entropy' or 'serialize'." << std::endl;
         }
     }
 
@@ -730,6 +1593,7 @@ int main() {
     std::cout << "- Deduplication eliminates redundant data" << std::endl;
     std::cout << "- Binary formats are more efficient than text formats" << std::endl;
     std::cout << "- Compression can significantly reduce data size" << std::endl;
+    std::cout << "- Entropy coding helps skewed data that has no long runs" << std::endl;
     std::cout << "- Multiple optimization techniques can be combined" << std::endl;
     std::cout << "- Optimized data reduces bandwidth usage and improves performance" << std::endl;
     std::cout << "=====================================================================================" << std::endl;
@@ -16,7 +16,9 @@
  * What this demonstrates:
  * - DNS queries can take 50-100ms without cache
  * - Local caching reduces query time to <1ms (99%+ improvement)
- * - Different DNS servers have different performance
+ * - A bounded, sharded cache with refresh-ahead keeps popular names from ever missing
+ * - Pipelining many queries on one UDP socket resolves batches far faster than one-by-one
+ * - Different DNS servers have different performance, and the fastest one changes over time
  * - Cache hit rates significantly impact application performance
  * - Proper DNS configuration is essential for network performance
  *
@@ -25,22 +27,47 @@
  * - Run: ./dns_optimization_demo
  * - Monitor with Wireshark on network interface
  * - Filter: dns (to see DNS queries on port 53)
+ * - Run "./dns_optimization_demo cachebench" for the Zipf cache benchmark
+ * - Run "./dns_optimization_demo batchbench" for pipelined UDP resolution against a stub server
+ * - Run "./dns_optimization_demo upstreambench" for EWMA upstream ranking with hedged queries
+ * - Run "./dns_optimization_demo snapshotbench" for cold vs warm start with a cache snapshot
+ * - Add "--snapshot" (or "--snapshot=<path>") to save the cache to dns_cache.snapshot every
+ *   10 s and on exit, and reload it at startup; without it nothing is written to disk
  *
  * =====================================================================================
  */
 
 #include <iostream>
+#include <iomanip>
 #include <string>
 #include <vector>
 #include <map>
 #include <chrono>
 #include <thread>
 #include <cstdlib>
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <cmath>
+#include <list>
+#include <deque>
+#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>
+#include <random>
+#include <queue>
+#include <memory>
+#include <cctype>
+#include <cerrno>
 
 #ifdef _WIN32
 #include <winsock2.h>
 #include <ws2tcpip.h>
 #include <windns.h>
+#include <io.h>
 #pragma comment(lib, "ws2_32.lib")
 #pragma comment(lib, "dnsapi.lib")
 #else
@@ -49,6 +76,9 @@
 #include <netdb.h>
 #include <arpa/inet.h>
 #include <netinet/in.h>
+#include <sys/select.h>
+#include <fcntl.h>
+#include <unistd.h>
 #endif
 
  // =====================================================================================
@@ -75,58 +105,1598 @@ const std::vector<std::pair<std::string, std::string>> DNS_SERVERS = {
 // =====================================================================================
 // DNS CACHE STRUCTURE
 // =====================================================================================
+//
+// Sharded, bounded LRU cache:
+// - Keys are spread over DNS_CACHE_SHARDS shards, each with its own lock, so
+//   concurrent lookups rarely contend
+// - Each shard holds at most capacity / shards entries and evicts the least
+//   recently used one when full
+// - Expiration is driven by a hierarchical timing wheel per shard (4 levels of
+//   64 slots, 10 ms ticks) advanced by a maintenance thread; lookups never scan
+// - Refresh-ahead: when an entry that has been used since it was fetched reaches
+//   80% of its TTL, a background worker re-resolves it before it expires
+// - Serve-stale (RFC 8767): after expiry the old answer is still returned for a
+//   grace period while a refresh is in flight
+
+const size_t DNS_CACHE_SHARDS = 16;
+const int DNS_WHEEL_TICK_MS = 10;
 
 struct CachedDNSRecord {
     std::string domain;
     std::string ipAddress;
-    std::chrono::system_clock::time_point timestamp;
-    int ttl; // Time to live in seconds
+    int ttl;                   // Time to live in seconds
+    uint64_t expiresTick;      // end of the TTL
+    uint64_t staleUntilTick;   // end of the serve-stale window; the entry is removed here
+    uint64_t generation;       // bumped on every (re)insert, invalidates old timers
+    uint32_t hits;             // lookups since the answer was fetched
+    bool refreshing;
 };
 
-class DNSCache {
+struct DNSCacheConfig {
+    size_t capacity = 10000;
+    bool refreshAhead = true;
+    double refreshAtFraction = 0.8;   // refresh popular entries at 80% of their TTL
+    uint32_t refreshMinHits = 2;      // "popular" = at least this many hits since fetch
+    bool serveStale = true;
+    int staleSeconds = 30;
+};
+
+enum DNSLookupStatus { DNS_CACHE_MISS, DNS_CACHE_HIT, DNS_CACHE_STALE };
+
+// Hierarchical timing wheel: level L covers deltas below 64^(L+1) ticks; timers
+// in higher levels cascade down as the wheel turns, so scheduling and firing are O(1)
+class TimingWheel {
+public:
+    struct Timer {
+        std::string key;
+        uint64_t generation;
+        uint64_t deadline;
+    };
+
 private:
-    std::map<std::string, CachedDNSRecord> cache;
+    static const int LEVELS = 4;
+    static const int SLOT_BITS = 6;
+    static const uint64_t SLOTS = 1 << SLOT_BITS;
+    static const uint64_t SLOT_MASK = SLOTS - 1;
+
+    std::vector<Timer> slots[LEVELS][SLOTS];
+    std::vector<Timer> pending;  // scratch list for timers fired early by clamping
+    uint64_t currentTick;
+
+    void place(Timer&& timer) {
+        uint64_t delta = timer.deadline > currentTick ? timer.deadline - currentTick : 0;
+        int level = 0;
+        while (level < LEVELS - 1 && delta >= (SLOTS << (SLOT_BITS * level))) level++;
+        // Deltas beyond the top level are clamped; the timer is re-placed when it fires early
+        uint64_t deadline = std::min(timer.deadline, currentTick + (SLOTS << (SLOT_BITS * level)) - 1);
+        if (deadline <= currentTick) deadline = currentTick + 1;
+        slots[level][(deadline >> (SLOT_BITS * level)) & SLOT_MASK].push_back(std::move(timer));
+    }
+
+    void cascade(int level) {
+        std::vector<Timer> pending;
+        pending.swap(slots[level][(currentTick >> (SLOT_BITS * level)) & SLOT_MASK]);
+        for (auto& timer : pending) place(std::move(timer));
+    }
 
 public:
-    void addRecord(const std::string& domain, const std::string& ip, int ttl) {
-        CachedDNSRecord record;
-        record.domain = domain;
+    explicit TimingWheel(uint64_t startTick = 0) : currentTick(startTick) {}
+
+    void schedule(const std::string& key, uint64_t generation, uint64_t deadline) {
+        place(Timer{ key, generation, deadline });
+    }
+
+    // Turns the wheel up to `tick`, appending every timer that came due
+    void advance(uint64_t tick, std::vector<Timer>& expired) {
+        while (currentTick < tick) {
+            currentTick++;
+            for (int level = 1; level < LEVELS; level++) {
+                if (((currentTick >> (SLOT_BITS * (level - 1))) & SLOT_MASK) != 0) break;
+                cascade(level);
+            }
+
+            std::vector<Timer>& due = slots[0][currentTick & SLOT_MASK];
+            for (auto& timer : due) {
+                if (timer.deadline <= currentTick) {
+                    expired.push_back(std::move(timer));
+                } else {
+                    pending.push_back(std::move(timer));
+                }
+            }
+            due.clear();
+            for (auto& timer : pending) place(std::move(timer));
+            pending.clear();
+        }
+    }
+};
+
+class DNSCache {
+public:
+    // Resolves a domain for background refreshes: returns false on failure
+    using Resolver = std::function<bool(const std::string& domain, std::string& ip, int& ttlSeconds)>;
+
+    struct Stats {
+        uint64_t hits, staleHits, misses, refreshes, evictions, expirations;
+    };
+
+private:
+    struct Shard {
+        std::mutex mutex;
+        std::list<CachedDNSRecord> lru;  // front = most recently used
+        std::unordered_map<std::string, std::list<CachedDNSRecord>::iterator> index;
+        TimingWheel wheel;
+        uint64_t nextGeneration = 1;
+    };
+
+    DNSCacheConfig config;
+    Shard shards[DNS_CACHE_SHARDS];
+    std::chrono::steady_clock::time_point epoch;
+
+    Resolver resolver;
+    std::mutex resolverMutex;
+
+    std::atomic<uint64_t> hitCount{ 0 }, staleHitCount{ 0 }, missCount{ 0 };
+    std::atomic<uint64_t> refreshCount{ 0 }, evictionCount{ 0 }, expirationCount{ 0 };
+
+    // Background threads: one turns the timing wheels, one runs refreshes. They
+    // start with the first entry, so a cache that stays empty (the global one in
+    // most modes) costs no threads and no wakeups, even as a static object.
+    std::once_flag startOnce;
+    std::thread maintenanceThread;
+    std::thread refreshThread;
+    std::mutex workMutex;
+    std::condition_variable workCondition;
+    std::deque<std::string> refreshQueue;
+    bool stopping = false;
+
+    uint64_t nowTick() const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - epoch).count()) / DNS_WHEEL_TICK_MS;
+    }
+
+    static uint64_t secondsToTicks(double seconds) {
+        return static_cast<uint64_t>(seconds * 1000.0 / DNS_WHEEL_TICK_MS);
+    }
+
+    Shard& shardFor(const std::string& domain) {
+        return shards[std::hash<std::string>()(domain) % DNS_CACHE_SHARDS];
+    }
+
+    void ensureStarted() {
+        std::call_once(startOnce, [this]() {
+            maintenanceThread = std::thread(&DNSCache::maintenanceLoop, this);
+            refreshThread = std::thread(&DNSCache::refreshLoop, this);
+        });
+    }
+
+    void requestRefresh(const std::string& domain) {
+        {
+            std::lock_guard<std::mutex> lock(workMutex);
+            refreshQueue.push_back(domain);
+        }
+        workCondition.notify_all();
+    }
+
+    void eraseLocked(Shard& shard, std::list<CachedDNSRecord>::iterator entry) {
+        shard.index.erase(entry->domain);
+        shard.lru.erase(entry);
+    }
+
+    void maintenanceLoop() {
+        std::vector<TimingWheel::Timer> expired;
+        std::vector<std::string> refreshes;
+        std::unique_lock<std::mutex> lock(workMutex);
+        while (!stopping) {
+            workCondition.wait_for(lock, std::chrono::milliseconds(DNS_WHEEL_TICK_MS));
+            lock.unlock();
+
+            uint64_t tick = nowTick();
+            for (auto& shard : shards) {
+                std::lock_guard<std::mutex> shardLock(shard.mutex);
+                shard.wheel.advance(tick, expired);
+                for (auto& timer : expired) {
+                    auto it = shard.index.find(timer.key);
+                    if (it == shard.index.end() || it->second->generation != timer.generation) continue;  // cancelled
+
+                    CachedDNSRecord& record = *it->second;
+                    if (tick >= record.staleUntilTick) {
+                        eraseLocked(shard, it->second);
+                        expirationCount++;
+                        continue;
+                    }
+                    // Refresh-ahead point reached: re-resolve popular entries, then wait for the hard expiry
+                    if (config.refreshAhead && !record.refreshing && record.hits >= config.refreshMinHits) {
+                        record.refreshing = true;
+                        refreshes.push_back(record.domain);
+                    }
+                    shard.wheel.schedule(record.domain, record.generation, record.staleUntilTick);
+                }
+                expired.clear();
+            }
+            for (auto& domain : refreshes) requestRefresh(domain);
+            refreshes.clear();
+
+            lock.lock();
+        }
+    }
+
+    void refreshLoop() {
+        std::unique_lock<std::mutex> lock(workMutex);
+        while (true) {
+            workCondition.wait(lock, [this]() { return stopping || !refreshQueue.empty(); });
+            if (stopping) return;
+            std::string domain = std::move(refreshQueue.front());
+            refreshQueue.pop_front();
+            lock.unlock();
+
+            Resolver resolve;
+            {
+                std::lock_guard<std::mutex> resolverLock(resolverMutex);
+                resolve = resolver;
+            }
+            std::string ip;
+            int ttl = 0;
+            if (resolve && resolve(domain, ip, ttl)) {
+                // Entries evicted while the refresh was in flight stay evicted
+                if (storeRecord(domain, ip, ttl, true)) refreshCount++;
+            } else {
+                // Failed refresh: keep serving the old answer until the stale window ends
+                Shard& shard = shardFor(domain);
+                std::lock_guard<std::mutex> shardLock(shard.mutex);
+                auto it = shard.index.find(domain);
+                if (it != shard.index.end()) it->second->refreshing = false;
+            }
+            lock.lock();
+        }
+    }
+
+    // ttlTicks is separate from ttl so snapshot restores can use the remaining lifetime
+    bool insertRecord(const std::string& domain, const std::string& ip, int ttl, uint64_t ttlTicks, bool onlyIfPresent) {
+        ensureStarted();
+        uint64_t now = nowTick();
+        uint64_t refreshTick = now + std::max<uint64_t>(1, static_cast<uint64_t>(ttlTicks * config.refreshAtFraction));
+        uint64_t staleTicks = config.serveStale ? secondsToTicks(config.staleSeconds) : 0;
+
+        Shard& shard = shardFor(domain);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.index.find(domain);
+        if (it != shard.index.end()) {
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+        } else if (onlyIfPresent) {
+            return false;
+        } else {
+            size_t shardCapacity = std::max<size_t>(1, config.capacity / DNS_CACHE_SHARDS);
+            if (shard.lru.size() >= shardCapacity) {
+                eraseLocked(shard, std::prev(shard.lru.end()));
+                evictionCount++;
+            }
+            shard.lru.push_front(CachedDNSRecord());
+            shard.lru.front().domain = domain;
+            shard.index[domain] = shard.lru.begin();
+        }
+
+        CachedDNSRecord& record = shard.lru.front();
         record.ipAddress = ip;
-        record.timestamp = std::chrono::system_clock::now();
         record.ttl = ttl;
-        cache[domain] = record;
+        record.expiresTick = now + ttlTicks;
+        record.staleUntilTick = record.expiresTick + staleTicks;
+        record.generation = shard.nextGeneration++;
+        record.hits = 0;
+        record.refreshing = false;
+
+        uint64_t firstTimer = config.refreshAhead ? std::min(refreshTick, record.staleUntilTick) : record.staleUntilTick;
+        shard.wheel.schedule(domain, record.generation, firstTimer);
+        return true;
     }
 
-    bool lookup(const std::string& domain, std::string& ip) {
-        auto it = cache.find(domain);
-        if (it == cache.end()) {
-            return false; // Cache miss
+public:
+    explicit DNSCache(const DNSCacheConfig& cacheConfig = DNSCacheConfig(), Resolver cacheResolver = nullptr)
+        : config(cacheConfig), epoch(std::chrono::steady_clock::now()), resolver(std::move(cacheResolver)) {}
+
+    ~DNSCache() {
+        {
+            std::lock_guard<std::mutex> lock(workMutex);
+            stopping = true;
         }
+        workCondition.notify_all();
+        if (maintenanceThread.joinable()) maintenanceThread.join();
+        if (refreshThread.joinable()) refreshThread.join();
+    }
 
-        // Check if record is still valid (TTL not expired)
-        auto now = std::chrono::system_clock::now();
-        auto elapsed = std::chrono::duration_cast<std::chrono::seconds>(now - it->second.timestamp);
+    DNSCache(const DNSCache&) = delete;
+    DNSCache& operator=(const DNSCache&) = delete;
 
-        if (elapsed.count() > it->second.ttl) {
-            cache.erase(it); // Expired, remove from cache
-            return false;
+    void setResolver(Resolver cacheResolver) {
+        std::lock_guard<std::mutex> lock(resolverMutex);
+        resolver = std::move(cacheResolver);
+    }
+
+    void addRecord(const std::string& domain, const std::string& ip, int ttl) {
+        storeRecord(domain, ip, ttl, false);
+    }
+
+    // Inserts or replaces an entry; with onlyIfPresent a missing entry is left missing
+    bool storeRecord(const std::string& domain, const std::string& ip, int ttl, bool onlyIfPresent) {
+        return insertRecord(domain, ip, ttl, std::max<uint64_t>(1, secondsToTicks(ttl)), onlyIfPresent);
+    }
+
+    // Re-inserts an entry from a snapshot with only the part of its TTL that is left
+    void restoreRecord(const std::string& domain, const std::string& ip, int ttl, int64_t remainingMs) {
+        insertRecord(domain, ip, ttl, std::max<uint64_t>(1, static_cast<uint64_t>(remainingMs) / DNS_WHEEL_TICK_MS), false);
+    }
+
+    struct SnapshotEntry {
+        std::string domain;
+        std::string ipAddress;
+        int ttl;
+        int64_t remainingMs;
+    };
+
+    // Unexpired entries, least recently used first, so restoring them in order rebuilds the LRU order
+    std::vector<SnapshotEntry> snapshotEntries() {
+        std::vector<SnapshotEntry> entries;
+        uint64_t now = nowTick();
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            for (auto it = shard.lru.rbegin(); it != shard.lru.rend(); ++it) {
+                if (it->expiresTick <= now) continue;  // stale answers are not worth persisting
+                entries.push_back(SnapshotEntry{ it->domain, it->ipAddress, it->ttl,
+                                                 static_cast<int64_t>(it->expiresTick - now) * DNS_WHEEL_TICK_MS });
+            }
+        }
+        return entries;
+    }
+
+    DNSLookupStatus lookupWithStatus(const std::string& domain, std::string& ip) {
+        Shard& shard = shardFor(domain);
+        bool startRefresh = false;
+        DNSLookupStatus status;
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            auto it = shard.index.find(domain);
+            if (it == shard.index.end()) {
+                missCount++;
+                return DNS_CACHE_MISS;
+            }
+
+            CachedDNSRecord& record = *it->second;
+            uint64_t now = nowTick();
+            if (now >= record.staleUntilTick || (now >= record.expiresTick && !config.serveStale)) {
+                // Expired between wheel ticks
+                missCount++;
+                return DNS_CACHE_MISS;
+            }
+
+            shard.lru.splice(shard.lru.begin(), shard.lru, it->second);
+            record.hits++;
+            ip = record.ipAddress;
+            if (now < record.expiresTick) {
+                status = DNS_CACHE_HIT;
+                hitCount++;
+            } else {
+                status = DNS_CACHE_STALE;
+                staleHitCount++;
+                if (!record.refreshing) {
+                    record.refreshing = true;
+                    startRefresh = true;
+                }
+            }
         }
+        if (startRefresh) requestRefresh(domain);
+        return status;
+    }
 
-        ip = it->second.ipAddress;
-        return true; // Cache hit
+    // Fresh or stale answer; false on a miss
+    bool lookup(const std::string& domain, std::string& ip) {
+        return lookupWithStatus(domain, ip) != DNS_CACHE_MISS;
     }
 
     void clear() {
-        cache.clear();
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            shard.lru.clear();
+            shard.index.clear();  // pending timers no longer match anything and are dropped
+        }
     }
 
-    size_t size() const {
-        return cache.size();
+    size_t size() {
+        size_t total = 0;
+        for (auto& shard : shards) {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            total += shard.lru.size();
+        }
+        return total;
+    }
+
+    Stats stats() const {
+        return Stats{ hitCount.load(), staleHitCount.load(), missCount.load(),
+                      refreshCount.load(), evictionCount.load(), expirationCount.load() };
     }
 };
 
 DNSCache globalDNSCache;
 
+// =====================================================================================
+// DNS WIRE PROTOCOL (RFC 1035)
+// =====================================================================================
+
+#ifdef _WIN32
+typedef SOCKET DnsSocket;
+#define closeDnsSocket closesocket
+const DnsSocket INVALID_DNS_SOCKET = INVALID_SOCKET;
+#else
+typedef int DnsSocket;
+#define closeDnsSocket close
+const DnsSocket INVALID_DNS_SOCKET = -1;
+#endif
+
+const uint16_t DNS_TYPE_A_RECORD = 1;
+const uint16_t DNS_CLASS_IN = 1;
+const uint8_t DNS_RCODE_NOERROR = 0;
+const uint8_t DNS_RCODE_FORMERR = 1;
+const uint8_t DNS_RCODE_SERVFAIL = 2;
+const uint8_t DNS_RCODE_NXDOMAIN = 3;
+const size_t DNS_UDP_MAX_PAYLOAD = 512;  // without EDNS0
+const size_t DNS_HEADER_SIZE = 12;
+
+void appendUint16(std::vector<uint8_t>& out, uint16_t value) {
+    out.push_back(static_cast<uint8_t>(value >> 8));
+    out.push_back(static_cast<uint8_t>(value & 0xFF));
+}
+
+void appendUint32(std::vector<uint8_t>& out, uint32_t value) {
+    appendUint16(out, static_cast<uint16_t>(value >> 16));
+    appendUint16(out, static_cast<uint16_t>(value & 0xFFFF));
+}
+
+uint16_t readUint16(const uint8_t* p) {
+    return static_cast<uint16_t>((p[0] << 8) | p[1]);
+}
+
+uint32_t readUint32(const uint8_t* p) {
+    return (static_cast<uint32_t>(readUint16(p)) << 16) | readUint16(p + 2);
+}
+
+// Writes a domain as length-prefixed labels; false if a label or the name is too long
+bool encodeDNSName(std::vector<uint8_t>& out, const std::string& name) {
+    if (name.size() > 253) return false;
+    size_t start = 0;
+    while (start < name.size()) {
+        size_t dot = name.find('.', start);
+        if (dot == std::string::npos) dot = name.size();
+        size_t length = dot - start;
+        if (length == 0 || length > 63) return false;
+        out.push_back(static_cast<uint8_t>(length));
+        out.insert(out.end(), name.begin() + start, name.begin() + dot);
+        start = dot + 1;
+    }
+    out.push_back(0);
+    return true;
+}
+
+// Reads a (possibly compressed) name starting at offset; offset ends after the name
+bool decodeDNSName(const uint8_t* message, size_t size, size_t& offset, std::string& name) {
+    name.clear();
+    size_t position = offset;
+    bool jumped = false;
+    int jumps = 0;
+
+    while (true) {
+        if (position >= size) return false;
+        uint8_t length = message[position];
+        if ((length & 0xC0) == 0xC0) {
+            // Compression pointer to an earlier name
+            if (position + 1 >= size || ++jumps > 16) return false;
+            if (!jumped) offset = position + 2;
+            position = ((length & 0x3F) << 8) | message[position + 1];
+            jumped = true;
+            continue;
+        }
+        if (length & 0xC0) return false;
+        position++;
+        if (length == 0) break;
+        if (position + length > size) return false;
+        if (!name.empty()) name.push_back('.');
+        name.append(reinterpret_cast<const char*>(message + position), length);
+        if (name.size() > 253) return false;
+        position += length;
+    }
+    if (!jumped) offset = position;
+    return true;
+}
+
+bool sameDNSName(const std::string& a, const std::string& b) {
+    if (a.size() != b.size()) return false;
+    for (size_t i = 0; i < a.size(); i++) {
+        if (std::tolower(static_cast<unsigned char>(a[i])) != std::tolower(static_cast<unsigned char>(b[i]))) return false;
+    }
+    return true;
+}
+
+bool encodeDNSQuery(uint16_t id, const std::string& name, std::vector<uint8_t>& out) {
+    out.clear();
+    appendUint16(out, id);
+    appendUint16(out, 0x0100);  // standard query, recursion desired
+    appendUint16(out, 1);       // QDCOUNT
+    appendUint16(out, 0);
+    appendUint16(out, 0);
+    appendUint16(out, 0);
+    if (!encodeDNSName(out, name)) return false;
+    appendUint16(out, DNS_TYPE_A_RECORD);
+    appendUint16(out, DNS_CLASS_IN);
+    return true;
+}
+
+struct DNSMessage {
+    uint16_t id = 0;
+    bool isResponse = false;
+    bool truncated = false;
+    uint8_t rcode = 0;
+    std::string questionName;
+    uint16_t questionType = 0;
+    std::vector<uint32_t> addresses;  // A records (host byte order)
+    uint32_t minTtl = 0;
+};
+
+// Parses header, first question and A answers; other record types are skipped
+bool decodeDNSMessage(const uint8_t* data, size_t size, DNSMessage& message) {
+    if (size < DNS_HEADER_SIZE) return false;
+    message.id = readUint16(data);
+    uint16_t flags = readUint16(data + 2);
+    message.isResponse = (flags & 0x8000) != 0;
+    message.truncated = (flags & 0x0200) != 0;
+    message.rcode = static_cast<uint8_t>(flags & 0x000F);
+    uint16_t questionCount = readUint16(data + 4);
+    uint16_t answerCount = readUint16(data + 6);
+    message.addresses.clear();
+    message.minTtl = 0;
+
+    size_t offset = DNS_HEADER_SIZE;
+    for (uint16_t i = 0; i < questionCount; i++) {
+        std::string name;
+        if (!decodeDNSName(data, size, offset, name) || offset + 4 > size) return false;
+        if (i == 0) {
+            message.questionName = name;
+            message.questionType = readUint16(data + offset);
+        }
+        offset += 4;
+    }
+
+    for (uint16_t i = 0; i < answerCount; i++) {
+        std::string name;
+        if (!decodeDNSName(data, size, offset, name) || offset + 10 > size) return false;
+        uint16_t type = readUint16(data + offset);
+        uint16_t recordClass = readUint16(data + offset + 2);
+        uint32_t ttl = readUint32(data + offset + 4);
+        uint16_t dataLength = readUint16(data + offset + 8);
+        offset += 10;
+        if (offset + dataLength > size) return false;
+        if (type == DNS_TYPE_A_RECORD && recordClass == DNS_CLASS_IN && dataLength == 4) {
+            message.addresses.push_back(readUint32(data + offset));
+            message.minTtl = message.addresses.size() == 1 ? ttl : std::min(message.minTtl, ttl);
+        }
+        offset += dataLength;
+    }
+    return true;
+}
+
+// Builds a response for the stub server; answers use a pointer to the question name
+void encodeDNSResponse(uint16_t id, const std::string& name, uint8_t rcode, const std::vector<uint32_t>& addresses,
+                       uint32_t ttl, bool truncated, std::vector<uint8_t>& out) {
+    out.clear();
+    appendUint16(out, id);
+    appendUint16(out, static_cast<uint16_t>(0x8180 | (truncated ? 0x0200 : 0) | rcode));  // QR, RD, RA
+    appendUint16(out, 1);
+    appendUint16(out, truncated ? 0 : static_cast<uint16_t>(addresses.size()));
+    appendUint16(out, 0);
+    appendUint16(out, 0);
+    encodeDNSName(out, name);
+    appendUint16(out, DNS_TYPE_A_RECORD);
+    appendUint16(out, DNS_CLASS_IN);
+    if (truncated) return;
+    for (uint32_t address : addresses) {
+        appendUint16(out, 0xC00C);  // pointer to the question name at offset 12
+        appendUint16(out, DNS_TYPE_A_RECORD);
+        appendUint16(out, DNS_CLASS_IN);
+        appendUint32(out, ttl);
+        appendUint16(out, 4);
+        appendUint32(out, address);
+    }
+}
+
+std::string ipv4ToString(uint32_t address) {
+    return std::to_string(address >> 24) + "." + std::to_string((address >> 16) & 0xFF) + "." +
+           std::to_string((address >> 8) & 0xFF) + "." + std::to_string(address & 0xFF);
+}
+
+bool setSocketNonBlocking(DnsSocket socketHandle) {
+#ifdef _WIN32
+    u_long enabled = 1;
+    return ioctlsocket(socketHandle, FIONBIO, &enabled) == 0;
+#else
+    int flags = fcntl(socketHandle, F_GETFL, 0);
+    return flags >= 0 && fcntl(socketHandle, F_SETFL, flags | O_NONBLOCK) == 0;
+#endif
+}
+
+// Waits until the socket is readable (or writable) or the deadline passes
+bool waitForDnsSocket(DnsSocket socketHandle, bool forWrite, std::chrono::steady_clock::time_point deadline) {
+    long waitUs = static_cast<long>(
+        std::chrono::duration_cast<std::chrono::microseconds>(deadline - std::chrono::steady_clock::now()).count());
+    if (waitUs <= 0) return false;
+    fd_set socketSet;
+    FD_ZERO(&socketSet);
+    FD_SET(socketHandle, &socketSet);
+    timeval timeout;
+    timeout.tv_sec = waitUs / 1000000;
+    timeout.tv_usec = waitUs % 1000000;
+    return select(static_cast<int>(socketHandle) + 1, forWrite ? NULL : &socketSet, forWrite ? &socketSet : NULL, NULL,
+                  &timeout) > 0;
+}
+
+sockaddr_in makeIPv4Address(const std::string& ip, int port) {
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(static_cast<uint16_t>(port));
+    inet_pton(AF_INET, ip.c_str(), &address.sin_addr);
+    return address;
+}
+
+// =====================================================================================
+// NATIVE UDP RESOLVER (PIPELINED BATCHES)
+// =====================================================================================
+//
+// All queries of a batch share one UDP socket. Up to maxInFlight queries are
+// outstanding at once; responses are matched back by transaction id *and*
+// question name (so a late or spoofed datagram cannot answer the wrong query).
+// Unanswered queries are retransmitted with exponential backoff, and responses
+// with the TC (truncated) bit are retried over TCP.
+
+struct DNSQueryResult {
+    std::string name;
+    std::string ip;
+    uint32_t ttl = 0;
+    int rcode = -1;          // -1 = no answer (timeout or invalid name)
+    int attempts = 0;
+    bool viaTcp = false;
+    double latencyMs = 0.0;
+
+    bool ok() const { return rcode == DNS_RCODE_NOERROR && !ip.empty(); }
+};
+
+struct DNSResolverStats {
+    uint64_t sent = 0;
+    uint64_t retransmits = 0;
+    uint64_t timeouts = 0;
+    uint64_t tcpFallbacks = 0;
+    uint64_t ignoredResponses = 0;  // unknown id, wrong question or wrong source
+};
+
+class UdpDNSResolver {
+private:
+    std::string serverIp;
+    int serverPort;
+    int initialTimeoutMs;
+    int maxAttempts;
+    uint16_t nextId;
+    DNSResolverStats stats;
+
+    struct InFlightQuery {
+        size_t index;
+        std::vector<uint8_t> packet;
+        int attempts;
+        int timeoutMs;
+        std::chrono::steady_clock::time_point firstSent;
+        std::chrono::steady_clock::time_point deadline;
+    };
+
+    void fillResult(DNSQueryResult& result, const DNSMessage& message) {
+        result.rcode = message.rcode;
+        if (!message.addresses.empty()) {
+            result.ip = ipv4ToString(message.addresses[0]);
+            result.ttl = message.minTtl;
+        }
+    }
+
+public:
+    UdpDNSResolver(const std::string& server, int port = 53, int timeoutMs = 500, int attempts = 3)
+        : serverIp(server), serverPort(port), initialTimeoutMs(timeoutMs), maxAttempts(attempts) {
+        std::random_device seed;
+        nextId = static_cast<uint16_t>(seed());
+    }
+
+    const DNSResolverStats& getStats() const { return stats; }
+
+    // Longest a query may take: what the UDP retransmissions would wait in total
+    int queryBudgetMs() const { return initialTimeoutMs * ((1 << maxAttempts) - 1); }
+
+    // DNS over TCP (RFC 1035 section 4.2.2): 2-byte length prefix, used after truncation.
+    // The socket is non-blocking and connect, send and receive share one deadline
+    // (queryBudgetMs), so a silent TCP upstream fails the name instead of stalling
+    // the caller.
+    bool queryOverTcp(const std::string& name, DNSQueryResult& result) {
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(queryBudgetMs());
+        std::vector<uint8_t> query;
+        if (!encodeDNSQuery(nextId++, name, query)) return false;
+
+        DnsSocket tcpSocket = socket(AF_INET, SOCK_STREAM, 0);
+        if (tcpSocket == INVALID_DNS_SOCKET) return false;
+        bool ok = setSocketNonBlocking(tcpSocket);
+        sockaddr_in server = makeIPv4Address(serverIp, serverPort);
+        if (ok && connect(tcpSocket, reinterpret_cast<sockaddr*>(&server), sizeof(server)) != 0) {
+#ifdef _WIN32
+            bool pending = WSAGetLastError() == WSAEWOULDBLOCK;
+#else
+            bool pending = errno == EINPROGRESS;
+#endif
+            int error = 0;
+            socklen_t errorLength = sizeof(error);
+            ok = pending && waitForDnsSocket(tcpSocket, true, deadline) &&
+                 getsockopt(tcpSocket, SOL_SOCKET, SO_ERROR, reinterpret_cast<char*>(&error), &errorLength) == 0 && error == 0;
+        }
+
+        std::vector<uint8_t> framed;
+        appendUint16(framed, static_cast<uint16_t>(query.size()));
+        framed.insert(framed.end(), query.begin(), query.end());
+        size_t sent = 0;
+        while (ok && sent < framed.size()) {
+            int written = send(tcpSocket, reinterpret_cast<const char*>(framed.data() + sent),
+                               static_cast<int>(framed.size() - sent), 0);
+            if (written > 0) sent += static_cast<size_t>(written);
+            else ok = waitForDnsSocket(tcpSocket, true, deadline);
+        }
+
+        std::vector<uint8_t> response;
+        uint8_t buffer[4096];
+        while (ok && (response.size() < 2 || response.size() < 2u + readUint16(response.data()))) {
+            if (!waitForDnsSocket(tcpSocket, false, deadline)) {
+                ok = false;  // deadline passed: the name fails like a UDP timeout
+                break;
+            }
+            int received = recv(tcpSocket, reinterpret_cast<char*>(buffer), sizeof(buffer), 0);
+            if (received <= 0) break;
+            response.insert(response.end(), buffer, buffer + received);
+        }
+        closeDnsSocket(tcpSocket);
+
+        DNSMessage message;
+        if (!ok || response.size() < 2 || response.size() < 2u + readUint16(response.data()) ||
+            !decodeDNSMessage(response.data() + 2, readUint16(response.data()), message) ||
+            !message.isResponse || !sameDNSName(message.questionName, name)) {
+            result.rcode = -1;
+            return false;
+        }
+        fillResult(result, message);
+        result.viaTcp = true;
+        return true;
+    }
+
+    std::vector<DNSQueryResult> resolveBatch(const std::vector<std::string>& names, size_t maxInFlight = 256) {
+        std::vector<DNSQueryResult> results(names.size());
+        for (size_t i = 0; i < names.size(); i++) results[i].name = names[i];
+
+        DnsSocket udpSocket = socket(AF_INET, SOCK_DGRAM, 0);
+        if (udpSocket == INVALID_DNS_SOCKET) return results;
+        setSocketNonBlocking(udpSocket);
+        sockaddr_in server = makeIPv4Address(serverIp, serverPort);
+
+        std::unordered_map<uint16_t, InFlightQuery> inFlight;
+        size_t nextName = 0;
+        std::vector<uint8_t> buffer(65536);
+        maxInFlight = std::max<size_t>(1, std::min<size_t>(maxInFlight, 60000));
+
+        auto transmit = [&](InFlightQuery& query) {
+            sendto(udpSocket, reinterpret_cast<const char*>(query.packet.data()), static_cast<int>(query.packet.size()), 0,
+                   reinterpret_cast<sockaddr*>(&server), sizeof(server));
+            query.attempts++;
+            query.deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(query.timeoutMs);
+            stats.sent++;
+        };
+
+        while (nextName < names.size() || !inFlight.empty()) {
+            // Keep the pipeline full
+            while (inFlight.size() < maxInFlight && nextName < names.size()) {
+                uint16_t id = nextId++;
+                while (inFlight.count(id)) id = nextId++;
+                InFlightQuery query;
+                query.index = nextName++;
+                if (!encodeDNSQuery(id, names[query.index], query.packet)) {
+                    results[query.index].rcode = DNS_RCODE_FORMERR;
+                    continue;
+                }
+                query.attempts = 0;
+                query.timeoutMs = initialTimeoutMs;
+                query.firstSent = std::chrono::steady_clock::now();
+                transmit(inFlight.emplace(id, std::move(query)).first->second);
+            }
+            if (inFlight.empty()) continue;
+
+            // Wait until a response arrives or the earliest retransmit timer fires
+            auto now = std::chrono::steady_clock::now();
+            auto earliest = inFlight.begin()->second.deadline;
+            for (const auto& entry : inFlight) earliest = std::min(earliest, entry.second.deadline);
+            long waitUs = std::max<long>(0, static_cast<long>(
+                std::chrono::duration_cast<std::chrono::microseconds>(earliest - now).count()));
+
+            fd_set readSet;
+            FD_ZERO(&readSet);
+            FD_SET(udpSocket, &readSet);
+            timeval timeout;
+            timeout.tv_sec = waitUs / 1000000;
+            timeout.tv_usec = waitUs % 1000000;
+            int ready = select(static_cast<int>(udpSocket) + 1, &readSet, NULL, NULL, &timeout);
+
+            if (ready > 0) {
+                // Drain every queued datagram before looking at timers
+                while (true) {
+                    sockaddr_in from;
+                    socklen_t fromLength = sizeof(from);
+                    int received = recvfrom(udpSocket, reinterpret_cast<char*>(buffer.data()), static_cast<int>(buffer.size()), 0,
+                                            reinterpret_cast<sockaddr*>(&from), &fromLength);
+                    if (received <= 0) break;
+
+                    DNSMessage message;
+                    auto it = decodeDNSMessage(buffer.data(), static_cast<size_t>(received), message) && message.isResponse
+                                  ? inFlight.find(message.id) : inFlight.end();
+                    if (it == inFlight.end() || from.sin_addr.s_addr != server.sin_addr.s_addr || from.sin_port != server.sin_port ||
+                        !sameDNSName(message.questionName, names[it->second.index])) {
+                        stats.ignoredResponses++;
+                        continue;
+                    }
+
+                    DNSQueryResult& result = results[it->second.index];
+                    result.attempts = it->second.attempts;
+                    if (message.truncated) {
+                        // Rare path, done inline: stalls the pipeline for one TCP round trip,
+                        // at most queryBudgetMs() if the TCP side is silent
+                        stats.tcpFallbacks++;
+                        queryOverTcp(names[it->second.index], result);
+                    } else {
+                        fillResult(result, message);
+                    }
+                    result.latencyMs = std::chrono::duration<double, std::milli>(
+                        std::chrono::steady_clock::now() - it->second.firstSent).count();
+                    inFlight.erase(it);
+                }
+            }
+
+            // Retransmit (doubling the timeout) or give up on expired queries
+            now = std::chrono::steady_clock::now();
+            for (auto it = inFlight.begin(); it != inFlight.end();) {
+                InFlightQuery& query = it->second;
+                if (query.deadline > now) {
+                    ++it;
+                } else if (query.attempts < maxAttempts) {
+                    query.timeoutMs *= 2;
+                    stats.retransmits++;
+                    transmit(query);
+                    ++it;
+                } else {
+                    stats.timeouts++;
+                    results[query.index].attempts = query.attempts;
+                    results[query.index].latencyMs = std::chrono::duration<double, std::milli>(now - query.firstSent).count();
+                    it = inFlight.erase(it);
+                }
+            }
+        }
+
+        closeDnsSocket(udpSocket);
+        return results;
+    }
+
+    DNSQueryResult resolve(const std::string& name) {
+        return resolveBatch(std::vector<std::string>{ name }, 1)[0];
+    }
+};
+
+// =====================================================================================
+// LOCAL STUB DNS SERVER (CONFIGURABLE LATENCY AND LOSS)
+// =====================================================================================
+//
+// Answers A queries on 127.0.0.1 over UDP and TCP:
+// - hostN.example.com -> a deterministic 10.x.y.z address, TTL 300
+// - names starting with "nx"  -> NXDOMAIN
+// - names starting with "big" -> 40 A records, too large for UDP, so the UDP
+//   answer is truncated (TC bit) and the full answer is only available over TCP
+// Each UDP query is dropped with probability lossRate, otherwise answered after
+// latencyMs (+ up to jitterMs) without blocking other queries. TCP connections
+// are served on their own thread, so a slow TCP answer never delays UDP.
+
+struct StubDNSServerConfig {
+    int port = 5353;
+    int latencyMs = 20;
+    int jitterMs = 0;
+    double lossRate = 0.0;
+    uint32_t seed = 42;
+};
+
+class StubDNSServer {
+private:
+    StubDNSServerConfig config;
+    std::mutex profileMutex;  // latency/jitter/loss may change while serving
+    DnsSocket udpSocket = INVALID_DNS_SOCKET;
+    DnsSocket tcpSocket = INVALID_DNS_SOCKET;
+    std::thread worker;
+    std::thread tcpWorker;
+    std::atomic<bool> running{ false };
+
+    struct PendingAnswer {
+        std::chrono::steady_clock::time_point sendAt;
+        std::vector<uint8_t> packet;
+        sockaddr_in client;
+        bool operator>(const PendingAnswer& other) const { return sendAt > other.sendAt; }
+    };
+
+public:
+    std::atomic<uint64_t> queriesReceived{ 0 }, queriesDropped{ 0 }, truncatedAnswers{ 0 }, tcpQueries{ 0 };
+
+    explicit StubDNSServer(const StubDNSServerConfig& serverConfig) : config(serverConfig) {}
+    ~StubDNSServer() { stop(); }
+
+    int port() const { return config.port; }
+
+    void setProfile(int latencyMs, int jitterMs, double lossRate) {
+        std::lock_guard<std::mutex> lock(profileMutex);
+        config.latencyMs = latencyMs;
+        config.jitterMs = jitterMs;
+        config.lossRate = lossRate;
+    }
+
+    // Builds the full answer for a query; false if the query cannot be parsed
+    static bool answerQuery(const uint8_t* data, size_t size, size_t udpLimit, std::vector<uint8_t>& answer, bool& truncated) {
+        DNSMessage query;
+        if (!decodeDNSMessage(data, size, query) || query.isResponse || query.questionName.empty()) return false;
+
+        uint8_t rcode = DNS_RCODE_NOERROR;
+        std::vector<uint32_t> addresses;
+        if (query.questionName.compare(0, 2, "nx") == 0) {
+            rcode = DNS_RCODE_NXDOMAIN;
+        } else if (query.questionType == DNS_TYPE_A_RECORD) {
+            uint32_t hash = static_cast<uint32_t>(std::hash<std::string>()(query.questionName));
+            int count = query.questionName.compare(0, 3, "big") == 0 ? 40 : 1;
+            for (int i = 0; i < count; i++) addresses.push_back(0x0A000000u | ((hash + i) & 0x00FFFFFFu));
+        }
+
+        encodeDNSResponse(query.id, query.questionName, rcode, addresses, 300, false, answer);
+        truncated = answer.size() > udpLimit;
+        if (truncated) encodeDNSResponse(query.id, query.questionName, rcode, addresses, 300, true, answer);
+        return true;
+    }
+
+    bool start() {
+        udpSocket = socket(AF_INET, SOCK_DGRAM, 0);
+        tcpSocket = socket(AF_INET, SOCK_STREAM, 0);
+        if (udpSocket == INVALID_DNS_SOCKET || tcpSocket == INVALID_DNS_SOCKET) return false;
+
+        int reuse = 1;
+        setsockopt(tcpSocket, SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+        sockaddr_in address = makeIPv4Address("127.0.0.1", config.port);
+        if (bind(udpSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            bind(tcpSocket, reinterpret_cast<sockaddr*>(&address), sizeof(address)) != 0 ||
+            listen(tcpSocket, 16) != 0) {
+            std::cerr << "Stub DNS server: cannot bind 127.0.0.1:" << config.port << std::endl;
+            stop();
+            return false;
+        }
+        setSocketNonBlocking(udpSocket);
+
+        running = true;
+        worker = std::thread(&StubDNSServer::serve, this);
+        tcpWorker = std::thread(&StubDNSServer::serveTcp, this);
+        return true;
+    }
+
+    void stop() {
+        running = false;
+        if (worker.joinable()) worker.join();
+        if (tcpWorker.joinable()) tcpWorker.join();
+        if (udpSocket != INVALID_DNS_SOCKET) closeDnsSocket(udpSocket);
+        if (tcpSocket != INVALID_DNS_SOCKET) closeDnsSocket(tcpSocket);
+        udpSocket = tcpSocket = INVALID_DNS_SOCKET;
+    }
+
+private:
+    void serveTcpClient(DnsSocket client) {
+        std::vector<uint8_t> request;
+        uint8_t buffer[4096];
+        while (request.size() < 2 || request.size() < 2u + readUint16(request.data())) {
+            int received = recv(client, reinterpret_cast<char*>(buffer), sizeof(buffer), 0);
+            if (received <= 0) break;
+            request.insert(request.end(), buffer, buffer + received);
+        }
+
+        std::vector<uint8_t> answer;
+        bool truncated = false;
+        if (request.size() >= 2 && request.size() >= 2u + readUint16(request.data()) &&
+            answerQuery(request.data() + 2, readUint16(request.data()), 65535, answer, truncated)) {
+            tcpQueries++;
+            int latencyMs;
+            {
+                std::lock_guard<std::mutex> lock(profileMutex);
+                latencyMs = config.latencyMs;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(latencyMs));
+            std::vector<uint8_t> framed;
+            appendUint16(framed, static_cast<uint16_t>(answer.size()));
+            framed.insert(framed.end(), answer.begin(), answer.end());
+            send(client, reinterpret_cast<const char*>(framed.data()), static_cast<int>(framed.size()), 0);
+        }
+        closeDnsSocket(client);
+    }
+
+    void serveTcp() {
+        while (running) {
+            fd_set readSet;
+            FD_ZERO(&readSet);
+            FD_SET(tcpSocket, &readSet);
+            timeval timeout;
+            timeout.tv_sec = 0;
+            timeout.tv_usec = 10000;
+            if (select(static_cast<int>(tcpSocket) + 1, &readSet, NULL, NULL, &timeout) <= 0) continue;
+
+            DnsSocket client = accept(tcpSocket, NULL, NULL);
+            if (client != INVALID_DNS_SOCKET) serveTcpClient(client);
+        }
+    }
+
+    void serve() {
+        std::mt19937 rng(config.seed);
+        std::uniform_real_distribution<double> lossDistribution(0.0, 1.0);
+        std::priority_queue<PendingAnswer, std::vector<PendingAnswer>, std::greater<PendingAnswer>> pending;
+        std::vector<uint8_t> buffer(65536);
+
+        while (running) {
+            auto now = std::chrono::steady_clock::now();
+            while (!pending.empty() && pending.top().sendAt <= now) {
+                const PendingAnswer& answer = pending.top();
+                sendto(udpSocket, reinterpret_cast<const char*>(answer.packet.data()), static_cast<int>(answer.packet.size()), 0,
+                       reinterpret_cast<const sockaddr*>(&answer.client), sizeof(answer.client));
+                pending.pop();
+            }
+
+            long waitUs = 10000;
+            if (!pending.empty()) {
+                waitUs = std::min<long>(waitUs, static_cast<long>(std::max<long long>(0,
+                    std::chrono::duration_cast<std::chrono::microseconds>(pending.top().sendAt - now).count())));
+            }
+            fd_set readSet;
+            FD_ZERO(&readSet);
+            FD_SET(udpSocket, &readSet);
+            timeval timeout;
+            timeout.tv_sec = 0;
+            timeout.tv_usec = waitUs;
+            if (select(static_cast<int>(udpSocket) + 1, &readSet, NULL, NULL, &timeout) <= 0) continue;
+
+            while (true) {
+                PendingAnswer answer;
+                socklen_t clientLength = sizeof(answer.client);
+                int received = recvfrom(udpSocket, reinterpret_cast<char*>(buffer.data()), static_cast<int>(buffer.size()), 0,
+                                        reinterpret_cast<sockaddr*>(&answer.client), &clientLength);
+                if (received <= 0) break;
+                queriesReceived++;
+
+                bool truncated = false;
+                if (!answerQuery(buffer.data(), static_cast<size_t>(received), DNS_UDP_MAX_PAYLOAD, answer.packet, truncated)) continue;
+                StubDNSServerConfig profile;
+                {
+                    std::lock_guard<std::mutex> lock(profileMutex);
+                    profile = config;
+                }
+                if (lossDistribution(rng) < profile.lossRate) {
+                    queriesDropped++;
+                    continue;
+                }
+                if (truncated) truncatedAnswers++;
+                int jitter = profile.jitterMs > 0 ? static_cast<int>(rng() % (profile.jitterMs + 1)) : 0;
+                answer.sendAt = std::chrono::steady_clock::now() + std::chrono::milliseconds(profile.latencyMs + jitter);
+                pending.push(std::move(answer));
+            }
+        }
+    }
+};
+
+// =====================================================================================
+// UPSTREAM SELECTION (EWMA RANKING, HEDGED QUERIES, PROBES)
+// =====================================================================================
+//
+// Each upstream keeps a smoothed latency and deviation (as in TCP's RTO
+// estimator, RFC 6298) plus an EWMA failure rate. Queries go to the upstream with
+// the lowest score = latency + failureRate * penalty. If it has not answered
+// after srtt + 4 * rttvar, the same query is raced against the runner-up and
+// the first valid answer wins. Losers stay outstanding, so their late answers
+// (or timeouts) still update their statistics. Demoted upstreams are probed
+// periodically so a server that recovers can win its rank back.
+
+struct UpstreamServer {
+    std::string label;
+    sockaddr_in address;
+    double srttMs;
+    double rttVarMs;
+    double failureRate = 0.0;
+    uint64_t queries = 0;
+    uint64_t answers = 0;
+    uint64_t failures = 0;
+    uint64_t wins = 0;
+    uint64_t probes = 0;
+    std::chrono::steady_clock::time_point lastSent;
+};
+
+struct UpstreamPolicyConfig {
+    bool adaptive = true;             // false: always use the first configured upstream
+    bool hedge = true;                // race the runner-up when the best one is slow
+    int probeIntervalMs = 100;        // 0 disables probing of demoted upstreams
+    int timeoutMs = 300;              // an unanswered query counts as a failure after this
+    double latencyGain = 0.125;
+    double deviationGain = 0.25;
+    double failureGain = 0.1;
+    double failurePenaltyMs = 100.0;
+    double minHedgeDelayMs = 2.0;
+};
+
+struct UpstreamRaceResult {
+    DNSQueryResult result;
+    int upstream = -1;   // index of the upstream whose answer was used
+    bool hedged = false;
+};
+
+class UpstreamSelector {
+private:
+    struct OutstandingQuery {
+        int upstream;
+        std::string name;
+        std::chrono::steady_clock::time_point sentAt;
+        uint64_t race;   // 0 for probes
+    };
+
+    UpstreamPolicyConfig config;
+    std::vector<UpstreamServer> servers;
+    std::unordered_map<uint16_t, OutstandingQuery> outstanding;
+    DnsSocket udpSocket;
+    uint16_t nextId;
+    uint64_t raceCounter = 0;
+    std::chrono::steady_clock::time_point lastProbe;
+
+    void recordAnswer(int index, double latencyMs) {
+        UpstreamServer& server = servers[index];
+        double error = latencyMs - server.srttMs;
+        server.srttMs += config.latencyGain * error;
+        server.rttVarMs += config.deviationGain * (std::fabs(error) - server.rttVarMs);
+        server.failureRate *= 1.0 - config.failureGain;
+        server.answers++;
+    }
+
+    void recordFailure(int index) {
+        UpstreamServer& server = servers[index];
+        server.failureRate += config.failureGain * (1.0 - server.failureRate);
+        server.failures++;
+    }
+
+    bool sendQuery(int index, const std::string& name, uint64_t race) {
+        std::vector<uint8_t> packet;
+        uint16_t id = nextId++;
+        while (outstanding.count(id)) id = nextId++;
+        if (!encodeDNSQuery(id, name, packet)) return false;
+
+        UpstreamServer& server = servers[index];
+        sendto(udpSocket, reinterpret_cast<const char*>(packet.data()), static_cast<int>(packet.size()), 0,
+               reinterpret_cast<const sockaddr*>(&server.address), sizeof(server.address));
+        server.queries++;
+        server.lastSent = std::chrono::steady_clock::now();
+        outstanding[id] = OutstandingQuery{ index, name, server.lastSent, race };
+        return true;
+    }
+
+    // Handles every queued datagram; fills race when an answer for it arrives
+    void drainResponses(uint64_t race, UpstreamRaceResult& result) {
+        uint8_t buffer[4096];
+        while (true) {
+            sockaddr_in from;
+            socklen_t fromLength = sizeof(from);
+            int received = recvfrom(udpSocket, reinterpret_cast<char*>(buffer), sizeof(buffer), 0,
+                                    reinterpret_cast<sockaddr*>(&from), &fromLength);
+            if (received <= 0) return;
+
+            DNSMessage message;
+            if (!decodeDNSMessage(buffer, static_cast<size_t>(received), message) || !message.isResponse) continue;
+            auto it = outstanding.find(message.id);
+            if (it == outstanding.end()) continue;
+            const UpstreamServer& server = servers[it->second.upstream];
+            if (from.sin_addr.s_addr != server.address.sin_addr.s_addr || from.sin_port != server.address.sin_port ||
+                !sameDNSName(message.questionName, it->second.name)) {
+                continue;
+            }
+
+            int index = it->second.upstream;
+            bool forThisRace = it->second.race == race && race != 0;
+            std::string name = it->second.name;
+            double latencyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - it->second.sentAt).count();
+            outstanding.erase(it);
+
+            // SERVFAIL/REFUSED mean this upstream could not answer; let the race continue
+            if (message.rcode != DNS_RCODE_NOERROR && message.rcode != DNS_RCODE_NXDOMAIN) {
+                recordFailure(index);
+                continue;
+            }
+            recordAnswer(index, latencyMs);
+            if (!forThisRace || result.upstream >= 0) continue;
+
+            result.upstream = index;
+            servers[index].wins++;
+            result.result.rcode = message.rcode;
+            if (message.truncated) {
+                char ip[INET_ADDRSTRLEN];
+                inet_ntop(AF_INET, &server.address.sin_addr, ip, sizeof(ip));
+                UdpDNSResolver(ip, ntohs(server.address.sin_port), config.timeoutMs, 1).queryOverTcp(name, result.result);
+            } else if (!message.addresses.empty()) {
+                result.result.ip = ipv4ToString(message.addresses[0]);
+                result.result.ttl = message.minTtl;
+            }
+        }
+    }
+
+    void expireOutstanding(std::chrono::steady_clock::time_point now) {
+        for (auto it = outstanding.begin(); it != outstanding.end();) {
+            if (now - it->second.sentAt >= std::chrono::milliseconds(config.timeoutMs)) {
+                recordFailure(it->second.upstream);
+                it = outstanding.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+
+    // Sends the current name to the non-primary upstream that was used least recently
+    // (the runner-up included: it only sees traffic when the primary is slow)
+    void maybeProbe(const std::vector<int>& order, const std::string& name) {
+        auto now = std::chrono::steady_clock::now();
+        if (config.probeIntervalMs <= 0 || order.size() < 2 ||
+            now - lastProbe < std::chrono::milliseconds(config.probeIntervalMs)) {
+            return;
+        }
+        int candidate = order[1];
+        for (size_t i = 2; i < order.size(); i++) {
+            if (servers[order[i]].lastSent < servers[candidate].lastSent) candidate = order[i];
+        }
+        if (sendQuery(candidate, name, 0)) servers[candidate].probes++;
+        lastProbe = now;
+    }
+
+public:
+    explicit UpstreamSelector(const UpstreamPolicyConfig& policy = UpstreamPolicyConfig()) : config(policy) {
+        udpSocket = socket(AF_INET, SOCK_DGRAM, 0);
+        setSocketNonBlocking(udpSocket);
+        std::random_device seed;
+        nextId = static_cast<uint16_t>(seed());
+        lastProbe = std::chrono::steady_clock::now();
+    }
+
+    ~UpstreamSelector() {
+        if (udpSocket != INVALID_DNS_SOCKET) closeDnsSocket(udpSocket);
+    }
+
+    UpstreamSelector(const UpstreamSelector&) = delete;
+    UpstreamSelector& operator=(const UpstreamSelector&) = delete;
+
+    int addServer(const std::string& label, const std::string& ip, int port = 53, double initialLatencyMs = 50.0) {
+        UpstreamServer server;
+        server.label = label;
+        server.address = makeIPv4Address(ip, port);
+        server.srttMs = initialLatencyMs;
+        server.rttVarMs = initialLatencyMs / 2.0;
+        servers.push_back(server);
+        return static_cast<int>(servers.size()) - 1;
+    }
+
+    // Seeds an upstream with an externally measured result (e.g. mode 2's comparison)
+    void seed(int index, bool answered, double latencyMs) {
+        if (answered) {
+            servers[index].srttMs = latencyMs;
+            servers[index].rttVarMs = latencyMs / 2.0;
+        } else {
+            recordFailure(index);
+        }
+    }
+
+    double score(int index) const {
+        return servers[index].srttMs + servers[index].failureRate * config.failurePenaltyMs;
+    }
+
+    double hedgeDelayMs(int index) const {
+        return std::max(config.minHedgeDelayMs, servers[index].srttMs + 4.0 * servers[index].rttVarMs);
+    }
+
+    std::vector<int> ranking() const {
+        std::vector<int> order(servers.size());
+        for (size_t i = 0; i < order.size(); i++) order[i] = static_cast<int>(i);
+        if (config.adaptive) {
+            std::stable_sort(order.begin(), order.end(), [this](int a, int b) { return score(a) < score(b); });
+        }
+        return order;
+    }
+
+    const std::vector<UpstreamServer>& getServers() const { return servers; }
+
+    UpstreamRaceResult resolve(const std::string& name) {
+        UpstreamRaceResult race;
+        race.result.name = name;
+        if (servers.empty() || udpSocket == INVALID_DNS_SOCKET) return race;
+
+        uint64_t raceId = ++raceCounter;
+        std::vector<int> order = ranking();
+        auto start = std::chrono::steady_clock::now();
+        auto deadline = start + std::chrono::milliseconds(config.timeoutMs);
+        if (!sendQuery(order[0], name, raceId)) {
+            race.result.rcode = DNS_RCODE_FORMERR;
+            return race;
+        }
+        bool canHedge = config.hedge && order.size() > 1;
+        auto hedgeAt = start + std::chrono::microseconds(static_cast<long long>(hedgeDelayMs(order[0]) * 1000.0));
+        maybeProbe(order, name);
+
+        while (race.upstream < 0) {
+            auto now = std::chrono::steady_clock::now();
+            expireOutstanding(now);
+            if (now >= deadline) break;
+            if (canHedge && !race.hedged && now >= hedgeAt) {
+                race.hedged = sendQuery(order[1], name, raceId);
+            }
+
+            auto wakeAt = canHedge && !race.hedged ? std::min(hedgeAt, deadline) : deadline;
+            long waitUs = std::max<long>(0, static_cast<long>(
+                std::chrono::duration_cast<std::chrono::microseconds>(wakeAt - now).count()));
+            fd_set readSet;
+            FD_ZERO(&readSet);
+            FD_SET(udpSocket, &readSet);
+            timeval timeout;
+            timeout.tv_sec = waitUs / 1000000;
+            timeout.tv_usec = waitUs % 1000000;
+            if (select(static_cast<int>(udpSocket) + 1, &readSet, NULL, NULL, &timeout) > 0) {
+                drainResponses(raceId, race);
+            }
+        }
+
+        race.result.latencyMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return race;
+    }
+};
+
+// =====================================================================================
+// DNS CACHE SNAPSHOT (PERSISTENCE ACROSS RESTARTS)
+// =====================================================================================
+//
+// The cache is written to disk periodically so a restarted process starts warm.
+// Expiry times are stored as absolute wall-clock times: the time the process
+// was down is subtracted from every TTL when loading, and entries that expired
+// meanwhile are discarded. Files are written to a temporary name, flushed to
+// disk and renamed over the old snapshot, so a crash mid-write never leaves a
+// torn file. A snapshot that fails any check is ignored as a whole.
+//
+// Layout (big-endian):
+//   header:  magic "DNSC" u32 | version u16 | reserved u16 | written at u64 (Unix ms) | count u32
+//   entry:   name length u8 | name | IPv4 address u32 | original TTL u32 | expires at u64 (Unix ms)
+//   trailer: FNV-1a 32-bit checksum of everything before it
+
+const uint32_t DNS_SNAPSHOT_MAGIC = 0x444E5343;
+const uint16_t DNS_SNAPSHOT_VERSION = 1;
+const size_t DNS_SNAPSHOT_HEADER_SIZE = 20;
+const uint32_t DNS_SNAPSHOT_MAX_ENTRIES = 1000000;
+const uint32_t DNS_SNAPSHOT_MAX_TTL = 7 * 24 * 3600;
+const std::string DNS_SNAPSHOT_PATH = "dns_cache.snapshot";  // default for --snapshot
+const int DNS_SNAPSHOT_INTERVAL_MS = 10000;
+
+int64_t unixTimeMs() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count();
+}
+
+void appendUint64(std::vector<uint8_t>& out, uint64_t value) {
+    appendUint32(out, static_cast<uint32_t>(value >> 32));
+    appendUint32(out, static_cast<uint32_t>(value & 0xFFFFFFFF));
+}
+
+uint64_t readUint64(const uint8_t* p) {
+    return (static_cast<uint64_t>(readUint32(p)) << 32) | readUint32(p + 4);
+}
+
+uint32_t fnv1a32(const uint8_t* data, size_t size) {
+    uint32_t hash = 2166136261u;
+    for (size_t i = 0; i < size; i++) {
+        hash ^= data[i];
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Hostname characters accepted from a snapshot; anything else means a corrupt file
+bool isValidSnapshotName(const std::string& name) {
+    if (name.empty() || name.size() > 253) return false;
+    for (char c : name) {
+        if (!std::isalnum(static_cast<unsigned char>(c)) && c != '.' && c != '-' && c != '_') return false;
+    }
+    return true;
+}
+
+size_t encodeDNSCacheSnapshot(DNSCache& cache, std::vector<uint8_t>& out, int64_t nowMs) {
+    std::vector<DNSCache::SnapshotEntry> entries = cache.snapshotEntries();
+    out.clear();
+    appendUint32(out, DNS_SNAPSHOT_MAGIC);
+    appendUint16(out, DNS_SNAPSHOT_VERSION);
+    appendUint16(out, 0);
+    appendUint64(out, static_cast<uint64_t>(nowMs));
+    size_t countOffset = out.size();
+    appendUint32(out, 0);
+
+    uint32_t count = 0;
+    for (const auto& entry : entries) {
+        in_addr address;
+        if (!isValidSnapshotName(entry.domain) || inet_pton(AF_INET, entry.ipAddress.c_str(), &address) != 1) continue;
+        out.push_back(static_cast<uint8_t>(entry.domain.size()));
+        out.insert(out.end(), entry.domain.begin(), entry.domain.end());
+        appendUint32(out, ntohl(address.s_addr));
+        appendUint32(out, static_cast<uint32_t>(std::max(0, entry.ttl)));
+        appendUint64(out, static_cast<uint64_t>(nowMs + entry.remainingMs));
+        if (++count == DNS_SNAPSHOT_MAX_ENTRIES) break;
+    }
+    out[countOffset] = static_cast<uint8_t>(count >> 24);
+    out[countOffset + 1] = static_cast<uint8_t>(count >> 16);
+    out[countOffset + 2] = static_cast<uint8_t>(count >> 8);
+    out[countOffset + 3] = static_cast<uint8_t>(count);
+    appendUint32(out, fnv1a32(out.data(), out.size()));
+    return count;
+}
+
+// Write-to-temp, flush to disk, rename: readers see either the old or the new snapshot
+bool writeDNSCacheSnapshot(DNSCache& cache, const std::string& path, size_t* entriesWritten = nullptr) {
+    std::vector<uint8_t> data;
+    size_t count = encodeDNSCacheSnapshot(cache, data, unixTimeMs());
+    std::string temporaryPath = path + ".tmp";
+
+    FILE* file = fopen(temporaryPath.c_str(), "wb");
+    if (!file) return false;
+    bool ok = fwrite(data.data(), 1, data.size(), file) == data.size() && fflush(file) == 0;
+#ifdef _WIN32
+    ok = ok && _commit(_fileno(file)) == 0;
+#else
+    ok = ok && fsync(fileno(file)) == 0;
+#endif
+    ok = fclose(file) == 0 && ok;
+
+#ifdef _WIN32
+    ok = ok && MoveFileExA(temporaryPath.c_str(), path.c_str(), MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH) != 0;
+#else
+    ok = ok && rename(temporaryPath.c_str(), path.c_str()) == 0;
+#endif
+    if (!ok) {
+        remove(temporaryPath.c_str());
+        return false;
+    }
+    if (entriesWritten) *entriesWritten = count;
+    return true;
+}
+
+struct DNSSnapshotLoadResult {
+    bool valid = false;
+    std::string error;
+    size_t loaded = 0;
+    size_t expired = 0;
+    int64_t ageMs = 0;   // how old the snapshot was when loaded
+};
+
+// Validates the whole file before restoring anything; nowMs can be overridden for testing
+DNSSnapshotLoadResult loadDNSCacheSnapshot(DNSCache& cache, const std::string& path, int64_t nowMs = unixTimeMs()) {
+    DNSSnapshotLoadResult result;
+    std::vector<uint8_t> data;
+    FILE* file = fopen(path.c_str(), "rb");
+    if (!file) {
+        result.error = "no snapshot";
+        return result;
+    }
+    uint8_t buffer[65536];
+    size_t read;
+    while ((read = fread(buffer, 1, sizeof(buffer), file)) > 0) data.insert(data.end(), buffer, buffer + read);
+    fclose(file);
+
+    if (data.size() < DNS_SNAPSHOT_HEADER_SIZE + 4) {
+        result.error = "file too short";
+        return result;
+    }
+    size_t bodySize = data.size() - 4;
+    if (fnv1a32(data.data(), bodySize) != readUint32(data.data() + bodySize)) {
+        result.error = "checksum mismatch";
+        return result;
+    }
+    if (readUint32(data.data()) != DNS_SNAPSHOT_MAGIC || readUint16(data.data() + 4) != DNS_SNAPSHOT_VERSION) {
+        result.error = "unknown format";
+        return result;
+    }
+    int64_t writtenAt = static_cast<int64_t>(readUint64(data.data() + 8));
+    uint32_t count = readUint32(data.data() + 16);
+    if (count > DNS_SNAPSHOT_MAX_ENTRIES) {
+        result.error = "too many entries";
+        return result;
+    }
+
+    struct ParsedEntry { std::string domain; std::string ip; uint32_t ttl; int64_t remainingMs; };
+    std::vector<ParsedEntry> parsed;
+    size_t offset = DNS_SNAPSHOT_HEADER_SIZE;
+    for (uint32_t i = 0; i < count; i++) {
+        if (offset + 1 > bodySize || offset + 1 + data[offset] + 16 > bodySize) {
+            result.error = "truncated entry";
+            return result;
+        }
+        size_t nameLength = data[offset++];
+        std::string domain(reinterpret_cast<const char*>(data.data() + offset), nameLength);
+        offset += nameLength;
+        uint32_t address = readUint32(data.data() + offset);
+        uint32_t ttl = readUint32(data.data() + offset + 4);
+        int64_t expiresAt = static_cast<int64_t>(readUint64(data.data() + offset + 8));
+        offset += 16;
+        if (!isValidSnapshotName(domain) || ttl == 0 || ttl > DNS_SNAPSHOT_MAX_TTL ||
+            expiresAt - writtenAt > static_cast<int64_t>(ttl) * 1000 + 1000) {
+            result.error = "invalid entry";
+            return result;
+        }
+        if (expiresAt <= nowMs) {
+            result.expired++;
+            continue;
+        }
+        // A wall clock that moved backwards must not extend an answer beyond its TTL
+        int64_t remainingMs = std::min<int64_t>(expiresAt - nowMs, static_cast<int64_t>(ttl) * 1000);
+        parsed.push_back(ParsedEntry{ domain, ipv4ToString(address), ttl, remainingMs });
+    }
+    if (offset != bodySize) {
+        result.error = "trailing data";
+        return result;
+    }
+
+    for (const auto& entry : parsed) cache.restoreRecord(entry.domain, entry.ip, static_cast<int>(entry.ttl), entry.remainingMs);
+    result.valid = true;
+    result.loaded = parsed.size();
+    result.ageMs = nowMs - writtenAt;
+    return result;
+}
+
+// Writes the snapshot every intervalMs and once more when stopped
+class DNSCacheSnapshotter {
+private:
+    DNSCache& cache;
+    std::string path;
+    int intervalMs;
+    std::thread worker;
+    std::mutex mutex;
+    std::condition_variable condition;
+    bool stopping = false;
+
+    void run() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!condition.wait_for(lock, std::chrono::milliseconds(intervalMs), [this]() { return stopping; })) {
+            lock.unlock();
+            writeDNSCacheSnapshot(cache, path);
+            lock.lock();
+        }
+    }
+
+public:
+    DNSCacheSnapshotter(DNSCache& snapshotCache, const std::string& snapshotPath, int writeIntervalMs)
+        : cache(snapshotCache), path(snapshotPath), intervalMs(writeIntervalMs) {
+        worker = std::thread(&DNSCacheSnapshotter::run, this);
+    }
+
+    ~DNSCacheSnapshotter() { stop(); }
+
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (stopping) return;
+            stopping = true;
+        }
+        condition.notify_all();
+        worker.join();
+        writeDNSCacheSnapshot(cache, path);
+    }
+};
+
 // =====================================================================================
 // DNS QUERY FUNCTIONS
 // =====================================================================================
@@ -187,6 +1757,11 @@ std::string queryDNS_Unix(const std::string& domain, const std::string& dnsServe
 #endif
 
 std::string queryDNS(const std::string& domain, const std::string& dnsServer = "") {
+    // A specific server is asked directly over the wire; otherwise use the system resolver
+    if (!dnsServer.empty()) {
+        DNSQueryResult result = UdpDNSResolver(dnsServer).resolve(domain);
+        return result.ok() ? result.ip : "";
+    }
 #ifdef _WIN32
     return queryDNS_Windows(domain, dnsServer);
 #else
@@ -300,6 +1875,7 @@ void mode2_CompareServers(const std::string& domain) {
     std::vector<std::pair<std::string, double>> results;
     double minTime = 999999.0;
     std::string fastestServer;
+    UpstreamSelector selector;
 
     // Query each DNS server
     for (const auto& server : DNS_SERVERS) {
@@ -308,6 +1884,7 @@ void mode2_CompareServers(const std::string& domain) {
         Timer timer;
         std::string ip = queryDNS(domain, server.first);
         double elapsed = timer.elapsed_ms();
+        selector.seed(selector.addServer(server.second, server.first), !ip.empty(), elapsed);
 
         if (!ip.empty()) {
             std::cout << "  [OK] Response: " << ip << std::endl;
@@ -344,80 +1921,607 @@ void mode2_CompareServers(const std::string& domain) {
     std::cout << "[OK] Fastest DNS server: " << fastestServer << " (" << minTime << " ms)" << std::endl;
     std::cout << "[OK] Configure this as your primary DNS for best performance" << std::endl;
     std::cout << "[OK] Check Wireshark for multiple DNS queries to different servers" << std::endl;
+
+    // A single measurement goes stale; keep ranking the servers while using them
+    std::cout << "\n=== ADAPTIVE UPSTREAM SELECTION (EWMA + HEDGING) ===" << std::endl;
+    for (int i = 0; i < 5; i++) {
+        UpstreamRaceResult race = selector.resolve(domain);
+        std::cout << "Query " << (i + 1) << ": ";
+        if (race.result.ok()) {
+            std::cout << race.result.ip << " from " << selector.getServers()[race.upstream].label << " in "
+                      << race.result.latencyMs << " ms" << (race.hedged ? " (raced against runner-up)" : "") << std::endl;
+        }
+        else {
+            std::cout << "[FAIL] no upstream answered" << std::endl;
+        }
+    }
+    std::cout << "Current ranking (score = smoothed latency + failure penalty):" << std::endl;
+    for (int index : selector.ranking()) {
+        const UpstreamServer& server = selector.getServers()[index];
+        std::cout << "  " << server.label << ": " << selector.score(index) << " (srtt " << server.srttMs
+                  << " ms, failure rate " << server.failureRate << ")" << std::endl;
+    }
+    std::cout << "[OK] Run 'upstreambench' to see ranking, probing and racing adapt to changing servers" << std::endl;
 }
 
-void mode3_BatchQueries(const std::string& domain) {
+// The 100 queries arrive in rounds of 10. Each round is answered from the cache
+// where possible; the distinct names that miss go out together as one pipelined
+// batch on a single UDP socket, so duplicate misses share one query on the wire.
+// The uncached baseline sends every query of every round, also pipelined.
+void mode3_BatchQueries(const std::string& domain, const std::string& dnsServer = DNS_SERVERS.front().first,
+                        int dnsPort = 53) {
+    const int totalQueries = 100;
+    const int roundSize = 10;
+
     std::cout << "\n=== MODE 3: BATCH QUERIES (CACHE HIT RATE) ===" << std::endl;
     std::cout << "Domain: " << domain << std::endl;
-    std::cout << "Performing 100 queries..." << std::endl;
+    std::cout << "DNS Server: " << dnsServer << " (pipelined UDP resolver)" << std::endl;
+    std::cout << "Performing " << totalQueries << " queries in rounds of " << roundSize << "..." << std::endl;
     std::cout << std::endl;
 
-    int totalQueries = 100;
+    // Baseline: no cache, every query goes on the wire
+    UdpDNSResolver uncachedResolver(dnsServer, dnsPort);
+    int uncachedFailures = 0;
+    Timer uncachedTimer;
+    for (int round = 0; round < totalQueries / roundSize; round++) {
+        std::vector<DNSQueryResult> results = uncachedResolver.resolveBatch(std::vector<std::string>(roundSize, domain));
+        for (const auto& result : results) if (!result.ok()) uncachedFailures++;
+    }
+    double totalTimeWithoutCache = uncachedTimer.elapsed_ms();
+
     int cacheHits = 0;
     int cacheMisses = 0;
-    double totalTimeWithCache = 0.0;
-    double totalTimeWithoutCache = 0.0;
-
+    int failures = 0;
     globalDNSCache.clear();
-
-    for (int i = 0; i < totalQueries; i++) {
-        Timer timer;
-        std::string cachedIp;
-        bool cacheHit = globalDNSCache.lookup(domain, cachedIp);
-
-        if (cacheHit) {
-            // Cache hit
-            cacheHits++;
-            double elapsed = timer.elapsed_ms();
-            totalTimeWithCache += elapsed;
-        }
-        else {
-            // Cache miss - query DNS
-            cacheMisses++;
-            std::string ip = queryDNS(domain);
-            double elapsed = timer.elapsed_ms();
-            totalTimeWithCache += elapsed;
-            totalTimeWithoutCache += elapsed;
-
-            if (!ip.empty()) {
-                globalDNSCache.addRecord(domain, ip, 300);
+    UdpDNSResolver resolver(dnsServer, dnsPort);
+    Timer cachedTimer;
+
+    for (int round = 0; round < totalQueries / roundSize; round++) {
+        std::vector<std::string> names(roundSize, domain);
+        std::vector<std::string> answers(names.size());
+        std::vector<std::string> missing;
+        for (size_t i = 0; i < names.size(); i++) {
+            if (globalDNSCache.lookup(names[i], answers[i])) {
+                cacheHits++;
+            }
+            else {
+                cacheMisses++;
+                if (std::find(missing.begin(), missing.end(), names[i]) == missing.end()) missing.push_back(names[i]);
             }
         }
 
-        // Progress indicator
-        if ((i + 1) % 10 == 0) {
-            std::cout << "Progress: " << (i + 1) << "/" << totalQueries << " queries" << std::endl;
+        // One pipelined batch for the distinct misses of this round
+        std::vector<DNSQueryResult> results;
+        if (!missing.empty()) results = resolver.resolveBatch(missing);
+        for (const auto& result : results) {
+            if (result.ok()) globalDNSCache.addRecord(result.name, result.ip, static_cast<int>(result.ttl));
+        }
+        for (size_t i = 0; i < names.size(); i++) {
+            if (!answers[i].empty()) continue;
+            auto it = std::find_if(results.begin(), results.end(),
+                                   [&](const DNSQueryResult& result) { return result.name == names[i]; });
+            if (it == results.end() || !it->ok()) failures++;
         }
 
-        // Small delay
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        std::cout << "Progress: " << ((round + 1) * roundSize) << "/" << totalQueries << " queries ("
+                  << missing.size() << " on the wire)" << std::endl;
     }
+    double totalTimeWithCache = cachedTimer.elapsed_ms();
 
-    // Calculate statistics
-    double avgTimeWithCache = totalTimeWithCache / totalQueries;
-    double avgTimeWithoutCache = (totalTimeWithoutCache / cacheMisses) * totalQueries;
-    double timeSaved = avgTimeWithoutCache - totalTimeWithCache;
-    double improvement = (timeSaved / avgTimeWithoutCache) * 100.0;
+    const DNSResolverStats& stats = resolver.getStats();
+    double timeSaved = totalTimeWithoutCache - totalTimeWithCache;
+    double improvement = totalTimeWithoutCache > 0.0 ? (timeSaved / totalTimeWithoutCache) * 100.0 : 0.0;
 
     std::cout << "\n=== BATCH QUERY RESULTS ===" << std::endl;
     std::cout << "Total queries:           " << totalQueries << std::endl;
     std::cout << "Cache hits:              " << cacheHits << std::endl;
-    std::cout << "Cache misses:            " << cacheMisses << std::endl;
+    std::cout << "Cache misses:            " << cacheMisses << " (" << stats.sent - stats.retransmits
+              << " sent on the wire, the rest shared an in-flight query)" << std::endl;
     std::cout << "Cache hit rate:          " << ((double)cacheHits / totalQueries * 100.0) << "%" << std::endl;
+    std::cout << "Failed:                  " << failures << " with cache, " << uncachedFailures << " without" << std::endl;
     std::cout << std::endl;
 
     std::cout << "=== PERFORMANCE IMPACT ===" << std::endl;
     std::cout << "Total time (with cache):    " << totalTimeWithCache << " ms" << std::endl;
-    std::cout << "Total time (without cache): " << avgTimeWithoutCache << " ms (estimated)" << std::endl;
+    std::cout << "Total time (without cache): " << totalTimeWithoutCache << " ms (" << uncachedResolver.getStats().sent
+              << " datagrams, measured)" << std::endl;
     std::cout << "Time saved:                 " << timeSaved << " ms" << std::endl;
     std::cout << "Performance improvement:    " << improvement << "%" << std::endl;
     std::cout << std::endl;
 
     std::cout << "=== ANALYSIS ===" << std::endl;
-    std::cout << "[OK] First query: DNS lookup (" << (totalTimeWithoutCache / cacheMisses) << " ms avg)" << std::endl;
+    std::cout << "[OK] Misses of a round are resolved together on one socket, matched by query id" << std::endl;
     std::cout << "[OK] Subsequent queries: Cache hits (<1 ms)" << std::endl;
     std::cout << "[OK] Caching provides " << improvement << "% performance improvement" << std::endl;
-    std::cout << "[OK] Check Wireshark: Only " << cacheMisses << " DNS queries visible" << std::endl;
+    std::cout << "[OK] Check Wireshark: Only " << stats.sent << " DNS queries visible" << std::endl;
+}
+
+// =====================================================================================
+// CACHE BENCHMARK (ZIPF HOSTNAME WORKLOAD)
+// =====================================================================================
+//
+// Several client threads look up hostnames drawn from a Zipf distribution (a few
+// names are very popular, most are rare) against a cache smaller than the name
+// set. Misses go to a simulated upstream with fixed latency and short TTLs, so
+// expirations matter. The same workload runs with and without refresh-ahead and
+// serve-stale.
+
+struct ZipfSampler {
+    std::vector<double> cdf;
+
+    ZipfSampler(size_t count, double exponent) : cdf(count) {
+        double sum = 0.0;
+        for (size_t i = 0; i < count; i++) {
+            sum += 1.0 / std::pow(static_cast<double>(i + 1), exponent);
+            cdf[i] = sum;
+        }
+        for (auto& value : cdf) value /= sum;
+    }
+
+    size_t sample(std::mt19937_64& rng) const {
+        double u = std::uniform_real_distribution<double>(0.0, 1.0)(rng);
+        return static_cast<size_t>(std::lower_bound(cdf.begin(), cdf.end(), u) - cdf.begin());
+    }
+};
+
+// Simulated upstream: fixed latency, deterministic answer, short TTL
+bool simulatedUpstreamResolve(const std::string& domain, std::string& ip, int& ttlSeconds, int latencyMs, int ttl) {
+    std::this_thread::sleep_for(std::chrono::milliseconds(latencyMs));
+    size_t hash = std::hash<std::string>()(domain);
+    ip = "10." + std::to_string((hash >> 16) & 0xFF) + "." + std::to_string((hash >> 8) & 0xFF) + "." + std::to_string(hash & 0xFF);
+    ttlSeconds = ttl;
+    return true;
+}
+
+double percentile(std::vector<double>& samples, double fraction) {
+    if (samples.empty()) return 0.0;
+    size_t rank = std::min(samples.size() - 1, static_cast<size_t>(fraction * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+    return samples[rank];
+}
+
+void runCacheBenchmark() {
+    const size_t hostnameCount = 10000;
+    const size_t cacheCapacity = 2000;
+    const double zipfExponent = 1.0;
+    const int clientThreads = 16;
+    const int durationMs = 4000;
+    const int upstreamLatencyMs = 2;
+    const int recordTtl = 1;
+    const size_t hotNames = 100;  // the most popular names, tracked separately
+
+    std::cout << "\n=== DNS CACHE BENCHMARK (ZIPF WORKLOAD) ===" << std::endl;
+    std::cout << "Hostnames: " << hostnameCount << " (Zipf s=" << zipfExponent << "), cache capacity: "
+              << cacheCapacity << ", threads: " << clientThreads << std::endl;
+    std::cout << "Upstream latency: " << upstreamLatencyMs << " ms, TTL: " << recordTtl << " s, run: "
+              << durationMs << " ms per configuration" << std::endl;
+
+    std::vector<std::string> hostnames;
+    for (size_t i = 0; i < hostnameCount; i++) {
+        hostnames.push_back("host" + std::to_string(i) + ".example.com");
+    }
+    ZipfSampler zipf(hostnameCount, zipfExponent);
+
+    for (int variant = 0; variant < 2; variant++) {
+        DNSCacheConfig config;
+        config.capacity = cacheCapacity;
+        config.refreshAhead = variant == 1;
+        config.serveStale = variant == 1;
+        config.staleSeconds = recordTtl;
+
+        DNSCache cache(config, [&](const std::string& domain, std::string& ip, int& ttl) {
+            return simulatedUpstreamResolve(domain, ip, ttl, upstreamLatencyMs, recordTtl);
+        });
+
+        std::vector<std::vector<double>> cacheLatencies(clientThreads);
+        std::vector<std::vector<double>> endToEndLatencies(clientThreads);
+        std::vector<std::vector<double>> hotLatencies(clientThreads);
+        std::vector<size_t> hotMisses(clientThreads, 0);
+        std::vector<std::thread> clients;
+        auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(durationMs);
+
+        for (int t = 0; t < clientThreads; t++) {
+            clients.emplace_back([&, t]() {
+                std::mt19937_64 rng(1234 + t);
+                std::string ip;
+                while (std::chrono::steady_clock::now() < deadline) {
+                    size_t rank = zipf.sample(rng);
+                    const std::string& domain = hostnames[rank];
+                    auto start = std::chrono::steady_clock::now();
+                    DNSLookupStatus status = cache.lookupWithStatus(domain, ip);
+                    auto afterLookup = std::chrono::steady_clock::now();
+                    if (status == DNS_CACHE_MISS) {
+                        int ttl = 0;
+                        if (simulatedUpstreamResolve(domain, ip, ttl, upstreamLatencyMs, recordTtl)) {
+                            cache.addRecord(domain, ip, ttl);
+                        }
+                    }
+                    auto end = std::chrono::steady_clock::now();
+                    cacheLatencies[t].push_back(std::chrono::duration<double, std::micro>(afterLookup - start).count());
+                    endToEndLatencies[t].push_back(std::chrono::duration<double, std::micro>(end - start).count());
+                    if (rank < hotNames) {
+                        hotLatencies[t].push_back(endToEndLatencies[t].back());
+                        if (status == DNS_CACHE_MISS) hotMisses[t]++;
+                    }
+                }
+            });
+        }
+        for (auto& client : clients) client.join();
+
+        std::vector<double> cacheAll, endToEndAll, hotAll;
+        size_t hotMissTotal = 0;
+        for (int t = 0; t < clientThreads; t++) {
+            hotAll.insert(hotAll.end(), hotLatencies[t].begin(), hotLatencies[t].end());
+            hotMissTotal += hotMisses[t];
+            cacheAll.insert(cacheAll.end(), cacheLatencies[t].begin(), cacheLatencies[t].end());
+            endToEndAll.insert(endToEndAll.end(), endToEndLatencies[t].begin(), endToEndLatencies[t].end());
+        }
+
+        DNSCache::Stats stats = cache.stats();
+        double lookups = static_cast<double>(stats.hits + stats.staleHits + stats.misses);
+        std::cout << "\n--- " << (variant == 0 ? "LRU + timing wheel only" : "LRU + timing wheel + refresh-ahead + serve-stale")
+                  << " ---" << std::endl;
+        std::cout << "Lookups:            " << static_cast<uint64_t>(lookups) << std::endl;
+        std::cout << "Hit rate:           " << (100.0 * (stats.hits + stats.staleHits) / lookups) << "% ("
+                  << stats.staleHits << " served stale)" << std::endl;
+        std::cout << "Misses:             " << stats.misses << std::endl;
+        std::cout << "Background refresh: " << stats.refreshes << ", evictions: " << stats.evictions
+                  << ", expirations: " << stats.expirations << std::endl;
+        std::cout << "Cache lookup:       p50 " << percentile(cacheAll, 0.50) << " us, p99 "
+                  << percentile(cacheAll, 0.99) << " us" << std::endl;
+        std::cout << "End-to-end lookup:  p50 " << percentile(endToEndAll, 0.50) << " us, p99 "
+                  << percentile(endToEndAll, 0.99) << " us" << std::endl;
+        std::cout << "Top " << hotNames << " names:      hit rate " << (100.0 - 100.0 * hotMissTotal / std::max<size_t>(1, hotAll.size()))
+                  << "%, end-to-end p99 " << percentile(hotAll, 0.99) << " us" << std::endl;
+    }
+}
+
+// =====================================================================================
+// SNAPSHOT BENCHMARK (COLD VS WARM START)
+// =====================================================================================
+//
+// A "previous run" warms a cache with a Zipf workload and snapshots it. Two fresh
+// caches then serve the same first 1000 lookups: one starts empty, the other
+// loads the snapshot first. Misses go to a simulated upstream with real latency.
+
+void runSnapshotBenchmark() {
+    const size_t hostnameCount = 10000;
+    const size_t warmupLookups = 50000;
+    const size_t measuredLookups = 1000;
+    const int upstreamLatencyMs = 5;
+    const int recordTtl = 300;
+    const std::string path = "dns_cache_bench.snapshot";
+
+    std::cout << "\n=== DNS CACHE SNAPSHOT BENCHMARK ===" << std::endl;
+    std::cout << "Hostnames: " << hostnameCount << " (Zipf s=1.0), upstream latency: " << upstreamLatencyMs
+              << " ms, TTL: " << recordTtl << " s" << std::endl;
+
+    std::vector<std::string> hostnames;
+    for (size_t i = 0; i < hostnameCount; i++) hostnames.push_back("host" + std::to_string(i) + ".example.com");
+    ZipfSampler zipf(hostnameCount, 1.0);
+
+    // Previous run: warm up and snapshot
+    size_t written = 0;
+    {
+        DNSCache cache;
+        std::mt19937_64 rng(7);
+        std::string ip;
+        for (size_t i = 0; i < warmupLookups; i++) {
+            const std::string& domain = hostnames[zipf.sample(rng)];
+            int ttl = 0;
+            if (!cache.lookup(domain, ip) && simulatedUpstreamResolve(domain, ip, ttl, 0, recordTtl)) cache.addRecord(domain, ip, ttl);
+        }
+        Timer writeTimer;
+        if (!writeDNSCacheSnapshot(cache, path, &written)) {
+            std::cout << "[FAIL] Could not write " << path << std::endl;
+            return;
+        }
+        double writeMs = writeTimer.elapsed_ms();
+        FILE* file = fopen(path.c_str(), "rb");
+        long bytes = 0;
+        if (file) {
+            fseek(file, 0, SEEK_END);
+            bytes = ftell(file);
+            fclose(file);
+        }
+        std::cout << "Snapshot: " << written << " entries, " << bytes << " bytes ("
+                  << (written ? bytes / static_cast<double>(written) : 0.0) << " bytes/entry), written atomically in "
+                  << writeMs << " ms" << std::endl;
+    }
+
+    std::cout << std::endl;
+    std::cout << std::left << std::setw(12) << "Start" << std::right << std::setw(10) << "load ms" << std::setw(9) << "misses"
+              << std::setw(11) << "miss rate" << std::setw(12) << "mean ms" << std::setw(11) << "p50 ms"
+              << std::setw(11) << "p99 ms" << std::setw(12) << "total ms" << std::endl;
+    std::cout << std::fixed << std::setprecision(3);
+
+    for (int warm = 0; warm < 2; warm++) {
+        DNSCache cache;
+        double loadMs = 0.0;
+        if (warm) {
+            Timer loadTimer;
+            DNSSnapshotLoadResult load = loadDNSCacheSnapshot(cache, path);
+            loadMs = loadTimer.elapsed_ms();
+            if (!load.valid || load.loaded != written) {
+                std::cout << "[FAIL] Snapshot load: " << load.error << ", " << load.loaded << " loaded" << std::endl;
+            }
+        }
+
+        // Time until the answer is available, as seen by the application
+        std::mt19937_64 rng(99);
+        std::vector<double> latencies;
+        size_t misses = 0;
+        std::string ip;
+        Timer total;
+        for (size_t i = 0; i < measuredLookups; i++) {
+            const std::string& domain = hostnames[zipf.sample(rng)];
+            Timer lookupTimer;
+            if (!cache.lookup(domain, ip)) {
+                misses++;
+                int ttl = 0;
+                if (simulatedUpstreamResolve(domain, ip, ttl, upstreamLatencyMs, recordTtl)) cache.addRecord(domain, ip, ttl);
+            }
+            latencies.push_back(lookupTimer.elapsed_ms());
+        }
+        double totalMs = total.elapsed_ms();
+        double mean = 0.0;
+        for (double latency : latencies) mean += latency;
+        mean /= latencies.size();
+
+        std::cout << std::left << std::setw(12) << (warm ? "warm" : "cold") << std::right << std::setw(10) << loadMs
+                  << std::setw(9) << misses << std::setw(10) << (100.0 * misses / measuredLookups) << "%"
+                  << std::setw(12) << mean << std::setw(11) << percentile(latencies, 0.50)
+                  << std::setw(11) << percentile(latencies, 0.99) << std::setw(12) << totalMs << std::endl;
+    }
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+
+    // Validation: a snapshot older than every TTL restores nothing, damaged files are rejected
+    std::cout << "\n=== SNAPSHOT VALIDATION ===" << std::endl;
+    {
+        DNSCache cache;
+        DNSSnapshotLoadResult load = loadDNSCacheSnapshot(cache, path, unixTimeMs() + (recordTtl + 1) * 1000LL);
+        bool ok = load.valid && load.loaded == 0 && load.expired == written && cache.size() == 0;
+        std::cout << "  [" << (ok ? "PASS" : "FAIL") << "] restart after " << (recordTtl + 1)
+                  << " s: all " << load.expired << " entries discarded as expired" << std::endl;
+    }
+
+    std::vector<uint8_t> original;
+    {
+        FILE* file = fopen(path.c_str(), "rb");
+        uint8_t buffer[65536];
+        size_t read;
+        while (file && (read = fread(buffer, 1, sizeof(buffer), file)) > 0) original.insert(original.end(), buffer, buffer + read);
+        if (file) fclose(file);
+    }
+    struct Damage { const char* label; size_t keepBytes; size_t flipOffset; };
+    const Damage damages[] = {
+        { "flipped byte", original.size(), original.size() / 2 },
+        { "truncated file", original.size() / 3, original.size() },
+        { "header only", DNS_SNAPSHOT_HEADER_SIZE, original.size() },
+    };
+    for (const Damage& damage : damages) {
+        std::vector<uint8_t> bytes(original.begin(), original.begin() + std::min(damage.keepBytes, original.size()));
+        if (damage.flipOffset < bytes.size()) bytes[damage.flipOffset] ^= 0x40;
+        FILE* file = fopen(path.c_str(), "wb");
+        if (file) {
+            fwrite(bytes.data(), 1, bytes.size(), file);
+            fclose(file);
+        }
+        DNSCache cache;
+        DNSSnapshotLoadResult load = loadDNSCacheSnapshot(cache, path);
+        bool ok = !load.valid && cache.size() == 0;
+        std::cout << "  [" << (ok ? "PASS" : "FAIL") << "] " << damage.label << " rejected (" << load.error << ")" << std::endl;
+    }
+    remove(path.c_str());
+
+    std::cout << "\n=== ANALYSIS ===" << std::endl;
+    std::cout << "- A cold start pays the upstream latency for every name it has not seen yet" << std::endl;
+    std::cout << "- Loading the snapshot turns most of those first lookups into cache hits" << std::endl;
+    std::cout << "- Absolute expiry times keep restored answers within their original TTL" << std::endl;
+}
+
+// =====================================================================================
+// BATCH RESOLUTION BENCHMARK (LOCAL STUB SERVER)
+// =====================================================================================
+//
+// Resolves a batch of distinct hostnames against the local stub server, first one
+// query at a time (what a getaddrinfo loop does) and then pipelined on a single
+// UDP socket. The batch also contains NXDOMAIN names and oversized answers that
+// must be fetched over TCP, and every answer is checked against the stub's data.
+
+const int STUB_DNS_PORT = 15353;
+
+std::vector<std::string> buildBatchNames(size_t count) {
+    std::vector<std::string> names;
+    for (size_t i = 0; i < count; i++) {
+        if (i % 100 == 7) names.push_back("nx" + std::to_string(i) + ".example.com");
+        else if (i % 250 == 11) names.push_back("big" + std::to_string(i) + ".example.com");
+        else names.push_back("host" + std::to_string(i) + ".example.com");
+    }
+    return names;
+}
+
+// Returns how many results disagree with what the stub server should have answered
+size_t verifyBatchResults(const std::vector<DNSQueryResult>& results) {
+    size_t wrong = 0;
+    for (const auto& result : results) {
+        if (result.rcode < 0) continue;  // timed out, counted separately
+        if (result.name.compare(0, 2, "nx") == 0) {
+            if (result.rcode != DNS_RCODE_NXDOMAIN) wrong++;
+            continue;
+        }
+        uint32_t hash = static_cast<uint32_t>(std::hash<std::string>()(result.name));
+        bool big = result.name.compare(0, 3, "big") == 0;
+        if (!result.ok() || result.ttl != 300 || result.ip != ipv4ToString(0x0A000000u | (hash & 0x00FFFFFFu)) ||
+            big != result.viaTcp) {
+            wrong++;
+        }
+    }
+    return wrong;
+}
+
+void printBatchRow(const std::string& label, const std::vector<DNSQueryResult>& results, double elapsedMs,
+                   const DNSResolverStats& stats) {
+    size_t answered = 0;
+    for (const auto& result : results) if (result.rcode >= 0) answered++;
+    std::cout << std::left << std::setw(27) << label << std::right
+              << std::setw(7) << results.size()
+              << std::setw(12) << std::fixed << std::setprecision(0) << (results.size() * 1000.0 / elapsedMs)
+              << std::setw(11) << std::setprecision(1) << elapsedMs
+              << std::setw(9) << (results.size() - answered)
+              << std::setw(8) << stats.retransmits
+              << std::setw(6) << stats.tcpFallbacks
+              << std::setw(8) << verifyBatchResults(results) << std::endl;
+}
+
+void runBatchResolverBenchmark() {
+    struct Profile { const char* label; int latencyMs; int jitterMs; double lossRate; };
+    const Profile profiles[] = {
+        { "20 ms, no loss", 20, 0, 0.0 },
+        { "20+-5 ms, 2% loss", 20, 5, 0.02 },
+    };
+    const size_t sequentialNames = 100;
+    const size_t pipelinedNames = 5000;
+
+    std::cout << "\n=== BATCH RESOLUTION BENCHMARK (stub server on 127.0.0.1:" << STUB_DNS_PORT << ") ===" << std::endl;
+
+    for (const Profile& profile : profiles) {
+        StubDNSServerConfig config;
+        config.port = STUB_DNS_PORT;
+        config.latencyMs = profile.latencyMs;
+        config.jitterMs = profile.jitterMs;
+        config.lossRate = profile.lossRate;
+        StubDNSServer server(config);
+        if (!server.start()) return;
+
+        std::cout << "\nUpstream profile: " << profile.label << std::endl;
+        std::cout << std::left << std::setw(27) << "Strategy" << std::right << std::setw(7) << "names"
+                  << std::setw(12) << "names/s" << std::setw(11) << "ms" << std::setw(9) << "failed"
+                  << std::setw(8) << "retx" << std::setw(6) << "tcp" << std::setw(8) << "wrong" << std::endl;
+
+        // One query at a time, fresh resolver (and socket) per name
+        std::vector<std::string> names = buildBatchNames(sequentialNames);
+        std::vector<DNSQueryResult> results;
+        DNSResolverStats sequentialStats;
+        Timer sequentialTimer;
+        for (const auto& name : names) {
+            UdpDNSResolver resolver("127.0.0.1", STUB_DNS_PORT, 100, 4);
+            results.push_back(resolver.resolve(name));
+            sequentialStats.retransmits += resolver.getStats().retransmits;
+            sequentialStats.tcpFallbacks += resolver.getStats().tcpFallbacks;
+        }
+        printBatchRow("sequential", results, sequentialTimer.elapsed_ms(), sequentialStats);
+
+        // Everything in flight on one socket
+        for (size_t window : { (size_t)16, (size_t)256 }) {
+            names = buildBatchNames(pipelinedNames);
+            UdpDNSResolver resolver("127.0.0.1", STUB_DNS_PORT, 100, 4);
+            Timer pipelinedTimer;
+            results = resolver.resolveBatch(names, window);
+            printBatchRow("pipelined (" + std::to_string(window) + " in flight)", results, pipelinedTimer.elapsed_ms(),
+                          resolver.getStats());
+        }
+
+        server.stop();
+        std::cout << "Stub server: " << server.queriesReceived << " queries, " << server.queriesDropped << " dropped, "
+                  << server.truncatedAnswers << " truncated, " << server.tcpQueries << " over TCP" << std::endl;
+    }
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+
+    std::cout << "\n=== ANALYSIS ===" << std::endl;
+    std::cout << "- Sequential resolution is bounded by one round trip per name" << std::endl;
+    std::cout << "- Pipelining keeps many queries in flight, so throughput scales with the window" << std::endl;
+    std::cout << "- Lost datagrams are recovered by per-query retransmit timers with backoff" << std::endl;
+    std::cout << "- Truncated (TC) answers are re-queried over TCP; 'wrong' must stay 0" << std::endl;
+}
+
+// =====================================================================================
+// UPSTREAM SELECTION BENCHMARK (STUB SERVERS WITH DIFFERENT PROFILES)
+// =====================================================================================
+//
+// Three local stub servers; halfway through, the initially fastest one degrades
+// (slow, jittery, lossy) and the slowest one becomes the fastest. Each policy
+// resolves the same sequence of names one at a time.
+
+const int UPSTREAM_BENCH_PORT = 15360;
+
+void runUpstreamSelectionBenchmark() {
+    struct UpstreamProfile { const char* label; int latencyMs; int jitterMs; double lossRate; };
+    const UpstreamProfile phase1[] = { { "A", 4, 2, 0.0 }, { "B", 12, 4, 0.0 }, { "C", 30, 10, 0.0 } };
+    const UpstreamProfile phase2[] = { { "A", 40, 60, 0.10 }, { "B", 12, 4, 0.0 }, { "C", 3, 1, 0.03 } };
+    const int lookupsPerPhase = 400;
+
+    struct Policy { const char* label; bool adaptive; bool hedge; int probeIntervalMs; };
+    const Policy policies[] = {
+        { "static (first server)", false, false, 0 },
+        { "EWMA ranking", true, false, 0 },
+        { "EWMA + probes", true, false, 100 },
+        { "EWMA + hedge + probes", true, true, 100 },
+    };
+
+    std::vector<std::unique_ptr<StubDNSServer>> stubs;
+    for (int i = 0; i < 3; i++) {
+        StubDNSServerConfig config;
+        config.port = UPSTREAM_BENCH_PORT + i;
+        config.seed = 100 + i;
+        stubs.emplace_back(new StubDNSServer(config));
+        if (!stubs.back()->start()) return;
+    }
+
+    std::cout << "\n=== UPSTREAM SELECTION BENCHMARK (" << lookupsPerPhase << " lookups per phase) ===" << std::endl;
+    std::cout << "Phase 1: A=4+-2 ms, B=12+-4 ms, C=30+-10 ms" << std::endl;
+    std::cout << "Phase 2: A=40+-60 ms with 10% loss, B unchanged, C=3+-1 ms with 3% loss" << std::endl;
+    std::cout << std::endl;
+    std::cout << std::left << std::setw(24) << "Policy" << std::setw(7) << "phase" << std::right
+              << std::setw(9) << "p50 ms" << std::setw(9) << "p99 ms" << std::setw(8) << "failed"
+              << std::setw(8) << "hedged" << "   wins A/B/C" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+
+    for (const Policy& policy : policies) {
+        UpstreamPolicyConfig config;
+        config.adaptive = policy.adaptive;
+        config.hedge = policy.hedge;
+        config.probeIntervalMs = policy.probeIntervalMs;
+        UpstreamSelector selector(config);
+        for (int i = 0; i < 3; i++) selector.addServer(phase1[i].label, "127.0.0.1", UPSTREAM_BENCH_PORT + i);
+
+        for (int phase = 0; phase < 2; phase++) {
+            const UpstreamProfile* profiles = phase == 0 ? phase1 : phase2;
+            for (int i = 0; i < 3; i++) stubs[i]->setProfile(profiles[i].latencyMs, profiles[i].jitterMs, profiles[i].lossRate);
+
+            std::vector<double> latencies;
+            int failed = 0, hedged = 0;
+            uint64_t winsBefore[3];
+            for (int i = 0; i < 3; i++) winsBefore[i] = selector.getServers()[i].wins;
+
+            for (int lookup = 0; lookup < lookupsPerPhase; lookup++) {
+                UpstreamRaceResult race = selector.resolve("host" + std::to_string(phase * lookupsPerPhase + lookup) + ".example.com");
+                if (!race.result.ok()) failed++;
+                if (race.hedged) hedged++;
+                latencies.push_back(race.result.latencyMs);
+            }
+
+            std::cout << std::left << std::setw(24) << (phase == 0 ? policy.label : "") << std::setw(7) << (phase + 1) << std::right
+                      << std::setw(9) << percentile(latencies, 0.50) << std::setw(9) << percentile(latencies, 0.99)
+                      << std::setw(8) << failed << std::setw(8) << hedged << "   ";
+            for (int i = 0; i < 3; i++) {
+                std::cout << (selector.getServers()[i].wins - winsBefore[i]) << (i < 2 ? "/" : "");
+            }
+            std::cout << std::endl;
+        }
+    }
+
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+    for (auto& stub : stubs) stub->stop();
+
+    std::cout << "\n=== ANALYSIS ===" << std::endl;
+    std::cout << "- A static choice made once (as mode 2 would) keeps using A after it degrades" << std::endl;
+    std::cout << "- EWMA ranking moves away from A, but never notices that C became the fastest" << std::endl;
+    std::cout << "- Probing demoted upstreams lets C win its rank back" << std::endl;
+    std::cout << "- Hedging caps the tail: a slow or lost answer is covered by the runner-up" << std::endl;
 }
 
 // =====================================================================================
@@ -595,33 +2699,88 @@ int main(int argc, char* argv[]) {
     std::cout << "                    DNS OPTIMIZATION DEMONSTRATION" << std::endl;
     std::cout << "=====================================================================================" << std::endl;
 
-    // Parse command line arguments
+    // Background refreshes of the global cache go through the system resolver
+    globalDNSCache.setResolver([](const std::string& name, std::string& ip, int& ttl) {
+        ip = queryDNS(name);
+        ttl = 300; // getaddrinfo does not expose the record TTL
+        return !ip.empty();
+    });
+
+    // Parse command line arguments; --snapshot[=path] may appear anywhere
     std::string domain = "google.com"; // Default domain
     bool runAll = false;
     int selectedMode = -1;
+    std::string snapshotPath;  // empty: the cache is not persisted
+    std::vector<std::string> args;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--snapshot") snapshotPath = DNS_SNAPSHOT_PATH;
+        else if (arg.compare(0, 11, "--snapshot=") == 0) snapshotPath = arg.substr(11);
+        else args.push_back(arg);
+    }
 
-    if (argc >= 2) {
-        std::string arg1 = argv[1];
+    if (args.size() >= 1) {
+        std::string arg1 = args[0];
 
         if (arg1 == "all" || arg1 == "ALL") {
             runAll = true;
         }
+        else if (arg1 == "cachebench") {
+            runCacheBenchmark();
+            return 0;
+        }
+        else if (arg1 == "batchbench") {
+            initializeNetwork();
+            runBatchResolverBenchmark();
+            cleanupNetwork();
+            return 0;
+        }
+        else if (arg1 == "upstreambench") {
+            initializeNetwork();
+            runUpstreamSelectionBenchmark();
+            cleanupNetwork();
+            return 0;
+        }
+        else if (arg1 == "snapshotbench") {
+            runSnapshotBenchmark();
+            return 0;
+        }
         else {
-            selectedMode = atoi(argv[1]);
+            selectedMode = atoi(args[0].c_str());
             if (selectedMode < 0 || selectedMode > 3) {
                 std::cerr << "Error: Invalid mode. Mode must be 0-3 or 'all'" << std::endl;
-                std::cerr << "Usage: " << argv[0] << " [mode|all] [domain]" << std::endl;
+                std::cerr << "Usage: " << argv[0] << " [mode|all|cachebench|batchbench|upstreambench|snapshotbench] [domain] [--snapshot[=path]]" << std::endl;
                 std::cerr << "  mode: 0=Normal, 1=Cache, 2=Compare, 3=Batch" << std::endl;
                 std::cerr << "  all: Run all 4 modes in sequence" << std::endl;
+                std::cerr << "  cachebench: Zipf workload against the sharded LRU cache" << std::endl;
+                std::cerr << "  batchbench: Sequential vs pipelined resolution against a local stub server" << std::endl;
+                std::cerr << "  upstreambench: Upstream selection policies against stub servers with changing latency" << std::endl;
+                std::cerr << "  snapshotbench: Cold vs warm start with an on-disk cache snapshot" << std::endl;
                 std::cerr << "  domain: Domain to query (default: google.com)" << std::endl;
+                std::cerr << "  --snapshot: Persist the cache across runs (default path: " << DNS_SNAPSHOT_PATH << ")" << std::endl;
                 return 1;
             }
             DNS_MODE = selectedMode;
         }
     }
 
-    if (argc >= 3) {
-        domain = argv[2];
+    if (args.size() >= 2) {
+        domain = args[1];
+    }
+
+    // Opt-in: start warm from the previous run's snapshot and keep it up to date
+    std::unique_ptr<DNSCacheSnapshotter> snapshotter;
+    if (!snapshotPath.empty()) {
+        DNSSnapshotLoadResult snapshot = loadDNSCacheSnapshot(globalDNSCache, snapshotPath);
+        if (snapshot.valid) {
+            std::cout << "Loaded DNS cache snapshot: " << snapshot.loaded << " entries (" << snapshot.expired
+                      << " expired, snapshot age " << (snapshot.ageMs / 1000) << " s)" << std::endl;
+        }
+        else if (snapshot.error != "no snapshot") {
+            std::cout << "Ignoring DNS cache snapshot: " << snapshot.error << std::endl;
+        }
+        std::cout << "Persisting the DNS cache to " << snapshotPath << std::endl;
+        snapshotter.reset(new DNSCacheSnapshotter(globalDNSCache, snapshotPath, DNS_SNAPSHOT_INTERVAL_MS));
     }
 
     // If "all" specified, run all modes
@@ -691,7 +2850,7 @@ int main(int argc, char* argv[]) {
     std::string userInput;
 
     while (true) {
-        std::cout << "\n>>> Enter domain to query (or 'quit' to exit, 'mode' to cycle, 'all' to run all modes): ";
+        std::cout << "\n>>> Enter domain to query (or 'quit' to exit, 'mode' to cycle, 'all' to run all modes, 'cachebench', 'batchbench', 'upstreambench', 'snapshotbench'): ";
         std::getline(std::cin, userInput);
 
         if (userInput == "quit" || userInput == "exit") {
@@ -704,6 +2863,22 @@ int main(int argc, char* argv[]) {
             initializeNetwork();
             continue;
         }
+        else if (userInput == "cachebench") {
+            runCacheBenchmark();
+            continue;
+        }
+        else if (userInput == "batchbench") {
+            runBatchResolverBenchmark();
+            continue;
+        }
+        else if (userInput == "upstreambench") {
+            runUpstreamSelectionBenchmark();
+            continue;
+        }
+        else if (userInput == "snapshotbench") {
+            runSnapshotBenchmark();
+            continue;
+        }
         else if (userInput == "mode") {
             DNS_MODE = (DNS_MODE + 1) % 4;
             std::cout << "Mode changed to: " << DNS_MODE << std::endl;
@@ -763,7 +2938,7 @@ int main(int argc, char* argv[]) {
  * - Compile: g++ -o dns_optimization_demo example4-m3p4e4-dns-optimization-demo.cpp -lws2_32 -ldnsapi
  *
  * Linux/macOS:
- * - Compile: g++ -o dns_optimization_demo example4-m3p4e4-dns-optimization-demo.cpp
+ * - Compile: g++ -pthread -o dns_optimization_demo example4-m3p4e4-dns-optimization-demo.cpp
  *
  * =====================================================================================
  *
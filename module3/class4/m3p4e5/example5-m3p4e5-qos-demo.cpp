@@ -16,6 +16,9 @@
  *  Compile (Windows):
  *    g++ example5-m3p4e5-qos-demo.cpp -o qos_demo.exe -lws2_32 -std=c++11
  *
+ *  Compile (Linux):
+ *    g++ example5-m3p4e5-qos-demo.cpp -o qos_demo -std=c++11 -pthread
+ *
  *  Usage:
  *    qos_demo.exe              # Interactive mode
  *    qos_demo.exe all          # Run all 4 modes
@@ -23,6 +26,12 @@
  *    qos_demo.exe 1            # Mode 1 only
  *    qos_demo.exe 2            # Mode 2 only
  *    qos_demo.exe 3            # Mode 3 only
+ *    qos_demo.exe sched        # Packet scheduler benchmark (strict priority + DRR)
+ *    qos_demo.exe htb          # Token-bucket shaper: measured vs configured rates
+ *    qos_demo.exe codel        # Congestion control loop (delay feedback) under bulk load
+ *    qos_demo.exe acks         # Per-message vs coalesced/selective acknowledgements
+ *    qos_demo.exe frag         # Real-time latency behind fragmented bulk transfers
+ *    qos_demo.exe emu          # Link emulator tests (rate, delay, jitter, reordering, loss)
  *
  *  Wireshark Tips:
  *    - Start capture on localhost/loopback adapter
@@ -35,12 +44,23 @@
 
 #include <iostream>
 #include <string>
+#include <sstream>
 #include <vector>
 #include <map>
 #include <chrono>
 #include <thread>
 #include <cstring>
 #include <cstdlib>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+#include <algorithm>
+#include <iomanip>
+#include <cmath>
+#include <atomic>
+#include <set>
+#include <random>
 
 #ifdef _WIN32
 #define _WINSOCK_DEPRECATED_NO_WARNINGS
@@ -50,13 +70,16 @@
 typedef int socklen_t;
 #else
 #include <sys/socket.h>
+#include <sys/select.h>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <arpa/inet.h>
 #include <unistd.h>
 #define SOCKET int
 #define INVALID_SOCKET -1
 #define SOCKET_ERROR -1
 #define closesocket close
+#define SD_SEND SHUT_WR
 #endif
 
  // =====================================================================================
@@ -139,24 +162,841 @@ struct QoSStats {
     }
 };
 
+// =====================================================================================
+// PACKET SCHEDULER (STRICT PRIORITY + DEFICIT ROUND ROBIN)
+// =====================================================================================
+//
+// Instead of delaying the caller, packets are queued per priority class and a
+// single sender thread decides what goes on the wire next:
+// - Strict-priority classes (HIGH, real-time) are always served first
+// - The remaining classes share what is left by deficit round robin (DRR): each
+//   time a class comes up in the round it earns weight * DRR_QUANTUM_UNIT bytes
+//   of credit and sends head packets while they fit, so byte shares follow the
+//   weights whatever the packet sizes
+// - Each queue has a length limit; arrivals beyond it are tail-dropped
+// The FIFO discipline (one shared queue) is the no-QoS baseline.
+//
+// With a fragment limit, a packet larger than the limit leaves its queue in
+// pieces: each decision sends at most one fragment, so a real-time packet that
+// arrives while bulk data is going out waits for one fragment, not one packet.
+//
+// The HTB discipline adds a hierarchical token-bucket shaper (a root link bucket
+// with one child per class, as in Linux HTB):
+// - A class whose rate bucket is not in debt sends within its guaranteed rate
+//   (classes are checked in priority order)
+// - Otherwise it may borrow unused link capacity from the root, up to its
+//   ceiling; borrowers are served strict classes first, then by DRR weight
+// - Buckets refill from the monotonic clock on every decision. When nothing is
+//   eligible the sender waits until the earliest bucket a head packet needs is
+//   out of debt, so there is no sleep per packet
+
+const int CLASS_COUNT = 3;
+const int DRR_QUANTUM_UNIT = 1024;  // bytes of credit per weight unit per round
+
+enum SchedulingDiscipline {
+    FIFO_SCHEDULING,
+    PRIORITY_DRR_SCHEDULING,
+    HTB_SCHEDULING
+};
+
+struct QueuedPacket {
+    Priority priority;
+    int size;
+    int sequenceNum;
+    std::chrono::steady_clock::time_point enqueued;
+    int fragmentOffset;   // in a queue: bytes already sent; dequeued: start of this piece
+    int fragmentSize;     // dequeued: bytes in this piece
+
+    bool lastFragment() const { return fragmentOffset + fragmentSize >= size; }
+};
+
+struct SchedulerClassConfig {
+    bool strictPriority;
+    int weight;          // DRR weight (ignored for strict classes)
+    size_t queueLimit;   // packets
+};
+
+struct ShaperClassConfig {
+    double rateBytesPerSecond;   // guaranteed
+    double ceilBytesPerSecond;   // upper bound including borrowed bandwidth
+};
+
+struct ShaperConfig {
+    double linkBytesPerSecond;   // root bucket: what all classes share
+    double burstBytes;           // bucket depth; must hold the largest packet
+    ShaperClassConfig classes[CLASS_COUNT];
+};
+
+struct SchedulerClassStats {
+    uint64_t enqueued;
+    uint64_t dropped;
+    uint64_t sent;
+    uint64_t bytesSent;
+    uint64_t bytesBorrowed;  // HTB: sent above the guaranteed rate
+};
+
+// Token bucket refilled lazily from the steady clock. As in Linux HTB a class may
+// send while its bucket is not in debt and the packet may overdraw it, so a large
+// packet is not starved by a stream of small ones draining the shared bucket first
+class TokenBucket {
+private:
+    double rate;
+    double burst;
+    double tokens;
+    std::chrono::steady_clock::time_point lastRefill;
+
+public:
+    TokenBucket() : rate(0.0), burst(0.0), tokens(0.0), lastRefill(std::chrono::steady_clock::now()) {}
+
+    TokenBucket(double bytesPerSecond, double burstBytes)
+        : rate(bytesPerSecond), burst(burstBytes), tokens(burstBytes), lastRefill(std::chrono::steady_clock::now()) {}
+
+    void refill(std::chrono::steady_clock::time_point now) {
+        if (now <= lastRefill) return;
+        tokens = std::min(burst, tokens + rate * std::chrono::duration<double>(now - lastRefill).count());
+        lastRefill = now;
+    }
+
+    // New rate from `now` on; tokens earned at the old rate are kept
+    void setRate(double bytesPerSecond, std::chrono::steady_clock::time_point now) {
+        refill(now);
+        rate = bytesPerSecond;
+    }
+
+    bool available() const { return tokens >= 0.0; }
+
+    void charge(int bytes) { tokens = std::max(-burst, tokens - bytes); }
+
+    // Seconds until the debt is repaid (infinite if the bucket never refills)
+    double secondsUntilAvailable() const {
+        if (tokens >= 0.0) return 0.0;
+        return rate > 0.0 ? -tokens / rate : 1e9;
+    }
+};
+
+class PacketScheduler {
+private:
+    SchedulingDiscipline discipline;
+    SchedulerClassConfig config[CLASS_COUNT];
+    std::deque<QueuedPacket> queues[CLASS_COUNT];
+    std::deque<QueuedPacket> fifoQueue;
+    size_t fifoLimit;
+    int maxFragmentBytes;               // 0: packets go out whole
+
+    std::deque<int> activeClasses;      // DRR round order of backlogged non-strict classes
+    long long deficit[CLASS_COUNT];
+    bool quantumGranted[CLASS_COUNT];   // credit already added in the current visit
+
+    TokenBucket linkBucket;
+    TokenBucket rateBuckets[CLASS_COUNT];
+    TokenBucket ceilBuckets[CLASS_COUNT];
+
+    SchedulerClassStats stats[CLASS_COUNT];
+    std::mutex mutex;
+    std::condition_variable packetAvailable;
+    bool closed;
+
+    bool hasPacketLocked() const {
+        if (discipline == FIFO_SCHEDULING) return !fifoQueue.empty();
+        for (int c = 0; c < CLASS_COUNT; c++) {
+            if (!queues[c].empty()) return true;
+        }
+        return false;
+    }
+
+    // Bytes the next piece of a queued packet will carry
+    int nextFragmentBytes(const QueuedPacket& packet) const {
+        int remaining = packet.size - packet.fragmentOffset;
+        return maxFragmentBytes > 0 ? std::min(remaining, maxFragmentBytes) : remaining;
+    }
+
+    // Takes the next piece of the head packet; the packet leaves the queue with its last piece
+    QueuedPacket popLocked(std::deque<QueuedPacket>& queue) {
+        QueuedPacket& head = queue.front();
+        QueuedPacket piece = head;
+        piece.fragmentSize = nextFragmentBytes(head);
+        head.fragmentOffset += piece.fragmentSize;
+        stats[piece.priority].bytesSent += piece.fragmentSize;
+        if (piece.lastFragment()) {
+            stats[piece.priority].sent++;
+            queue.pop_front();
+        }
+        return piece;
+    }
+
+    // One DRR decision among the backlogged non-strict classes accepted by `eligible`
+    template <typename Eligible>
+    bool selectDrrLocked(Eligible eligible, QueuedPacket& packet) {
+        size_t skipped = 0;
+        while (!activeClasses.empty() && skipped < activeClasses.size()) {
+            int c = activeClasses.front();
+            if (!eligible(c)) {
+                // Ineligible classes keep their place in the round but earn no credit
+                quantumGranted[c] = false;
+                activeClasses.pop_front();
+                activeClasses.push_back(c);
+                skipped++;
+                continue;
+            }
+            skipped = 0;
+            if (!quantumGranted[c]) {
+                deficit[c] += static_cast<long long>(config[c].weight) * DRR_QUANTUM_UNIT;
+                quantumGranted[c] = true;
+            }
+            if (nextFragmentBytes(queues[c].front()) <= deficit[c]) {
+                deficit[c] -= nextFragmentBytes(queues[c].front());
+                packet = popLocked(queues[c]);
+                if (queues[c].empty()) {
+                    // An idle class keeps no credit
+                    deficit[c] = 0;
+                    quantumGranted[c] = false;
+                    activeClasses.pop_front();
+                }
+                return true;
+            }
+            quantumGranted[c] = false;
+            activeClasses.pop_front();
+            activeClasses.push_back(c);
+        }
+        return false;
+    }
+
+    void removeFromRoundLocked(int c) {
+        if (!queues[c].empty() || config[c].strictPriority) return;
+        activeClasses.erase(std::remove(activeClasses.begin(), activeClasses.end(), c), activeClasses.end());
+        deficit[c] = 0;
+        quantumGranted[c] = false;
+    }
+
+    bool selectHtbLocked(std::chrono::steady_clock::time_point now, QueuedPacket& packet) {
+        linkBucket.refill(now);
+        for (int c = 0; c < CLASS_COUNT; c++) {
+            rateBuckets[c].refill(now);
+            ceilBuckets[c].refill(now);
+        }
+        // Nobody sends while the link is in debt. Checked before DRR so that a busy
+        // link does not rotate the round and hand out fresh credit on every wakeup.
+        if (!linkBucket.available()) return false;
+
+        // Within the guaranteed rate, in priority order
+        for (int c = 0; c < CLASS_COUNT; c++) {
+            if (queues[c].empty() || !rateBuckets[c].available()) continue;
+            int size = nextFragmentBytes(queues[c].front());
+            rateBuckets[c].charge(size);
+            ceilBuckets[c].charge(size);
+            linkBucket.charge(size);
+            packet = popLocked(queues[c]);
+            removeFromRoundLocked(c);
+            return true;
+        }
+
+        // Borrowing spare link capacity, up to the ceiling
+        bool selected = false;
+        for (int c = 0; c < CLASS_COUNT && !selected; c++) {
+            if (config[c].strictPriority && !queues[c].empty() && ceilBuckets[c].available()) {
+                packet = popLocked(queues[c]);
+                selected = true;
+            }
+        }
+        if (!selected) {
+            selected = selectDrrLocked([this](int c) { return ceilBuckets[c].available(); }, packet);
+        }
+        if (selected) {
+            ceilBuckets[packet.priority].charge(packet.fragmentSize);
+            linkBucket.charge(packet.fragmentSize);
+            stats[packet.priority].bytesBorrowed += packet.fragmentSize;
+        }
+        return selected;
+    }
+
+    bool selectLocked(std::chrono::steady_clock::time_point now, QueuedPacket& packet) {
+        if (discipline == FIFO_SCHEDULING) {
+            packet = popLocked(fifoQueue);
+            return true;
+        }
+        if (discipline == HTB_SCHEDULING) return selectHtbLocked(now, packet);
+
+        for (int c = 0; c < CLASS_COUNT; c++) {
+            if (config[c].strictPriority && !queues[c].empty()) {
+                packet = popLocked(queues[c]);
+                return true;
+            }
+        }
+        return selectDrrLocked([](int) { return true; }, packet);
+    }
+
+    // Earliest time a backlogged class can send, either within its rate or by borrowing
+    std::chrono::steady_clock::time_point nextEligibleLocked(std::chrono::steady_clock::time_point now) const {
+        double wait = 1e9;
+        for (int c = 0; c < CLASS_COUNT; c++) {
+            if (queues[c].empty()) continue;
+            double linkWait = linkBucket.secondsUntilAvailable();
+            double rateWait = std::max(rateBuckets[c].secondsUntilAvailable(), linkWait);
+            double borrowWait = std::max(ceilBuckets[c].secondsUntilAvailable(), linkWait);
+            wait = std::min(wait, std::min(rateWait, borrowWait));
+        }
+        wait = std::min(wait, 0.1);
+        return now + std::chrono::nanoseconds(static_cast<long long>(wait * 1e9) + 1000);
+    }
+
+public:
+    PacketScheduler(SchedulingDiscipline schedulingDiscipline, const SchedulerClassConfig classConfig[CLASS_COUNT],
+                    const ShaperConfig* shaper = NULL, int fragmentLimit = 0)
+        : discipline(schedulingDiscipline), fifoLimit(0), maxFragmentBytes(fragmentLimit), closed(false) {
+        for (int c = 0; c < CLASS_COUNT; c++) {
+            config[c] = classConfig[c];
+            deficit[c] = 0;
+            quantumGranted[c] = false;
+            stats[c] = SchedulerClassStats{ 0, 0, 0, 0, 0 };
+            fifoLimit += classConfig[c].queueLimit;
+        }
+        if (discipline == HTB_SCHEDULING && shaper) {
+            linkBucket = TokenBucket(shaper->linkBytesPerSecond, shaper->burstBytes);
+            for (int c = 0; c < CLASS_COUNT; c++) {
+                rateBuckets[c] = TokenBucket(shaper->classes[c].rateBytesPerSecond, shaper->burstBytes);
+                ceilBuckets[c] = TokenBucket(shaper->classes[c].ceilBytesPerSecond, shaper->burstBytes);
+            }
+        }
+    }
+
+    // Returns false if the packet was tail-dropped
+    bool enqueue(QueuedPacket packet) {
+        packet.fragmentOffset = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            int c = packet.priority;
+            stats[c].enqueued++;
+            if (discipline == FIFO_SCHEDULING) {
+                if (fifoQueue.size() >= fifoLimit) {
+                    stats[c].dropped++;
+                    return false;
+                }
+                fifoQueue.push_back(packet);
+            }
+            else {
+                if (queues[c].size() >= config[c].queueLimit) {
+                    stats[c].dropped++;
+                    return false;
+                }
+                if (queues[c].empty() && !config[c].strictPriority) activeClasses.push_back(c);
+                queues[c].push_back(packet);
+            }
+        }
+        packetAvailable.notify_one();
+        return true;
+    }
+
+    // Blocks until a packet may be sent; false once closed and drained
+    bool dequeue(QueuedPacket& packet) {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            if (hasPacketLocked()) {
+                auto now = std::chrono::steady_clock::now();
+                if (selectLocked(now, packet)) return true;
+                packetAvailable.wait_until(lock, nextEligibleLocked(now));
+            }
+            else if (closed) {
+                return false;
+            }
+            else {
+                packetAvailable.wait(lock);
+            }
+        }
+    }
+
+    // Non-blocking decision at a caller-supplied time (e.g. a virtual clock);
+    // false if nothing may be sent at `now`
+    bool tryDequeue(std::chrono::steady_clock::time_point now, QueuedPacket& packet) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return hasPacketLocked() && selectLocked(now, packet);
+    }
+
+    // Applies new rates and ceilings (HTB only), e.g. from the congestion control loop
+    void updateShaper(const ShaperConfig& shaper) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (discipline != HTB_SCHEDULING) return;
+            auto now = std::chrono::steady_clock::now();
+            linkBucket.setRate(shaper.linkBytesPerSecond, now);
+            for (int c = 0; c < CLASS_COUNT; c++) {
+                rateBuckets[c].setRate(shaper.classes[c].rateBytesPerSecond, now);
+                ceilBuckets[c].setRate(shaper.classes[c].ceilBytesPerSecond, now);
+            }
+        }
+        packetAvailable.notify_one();
+    }
+
+    void close() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            closed = true;
+        }
+        packetAvailable.notify_all();
+    }
+
+    SchedulerClassStats classStats(Priority priority) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return stats[priority];
+    }
+};
+
+// =====================================================================================
+// SCHEDULED SENDER AND FRAMED RECEIVER
+// =====================================================================================
+//
+// Scheduled packets travel as frames: a fixed header followed by the payload.
+// The header carries the enqueue and send timestamps (steady clock, same process)
+// so the receiver can measure the full queueing + transmission delay. A receiver
+// giving feedback echoes (priority, send timestamp) for every frame it reads,
+// from which the sender measures per-class RTT. A fragmented packet is a run of
+// frames of one class with increasing fragmentOffset, all but the last flagged
+// FRAME_FLAG_MORE_FRAGMENTS; other classes' frames may sit in between.
+
+struct FrameHeader {
+    uint8_t priority;
+    uint8_t flags;
+    uint16_t reserved;
+    uint32_t sequenceNum;
+    uint32_t payloadSize;
+    int64_t enqueuedNs;
+    int64_t sentNs;
+    uint32_t fragmentOffset;   // position of this payload within the packet
+};
+
+const int FRAME_HEADER_SIZE = 32;
+const uint8_t FRAME_FLAG_MORE_FRAGMENTS = 0x02;
+const int MAX_FRAME_PAYLOAD = 200000;
+const int FEEDBACK_SIZE = 9;  // priority + send timestamp
+
+void encodeFrameHeader(const FrameHeader& header, char* out) {
+    out[0] = static_cast<char>(header.priority);
+    out[1] = static_cast<char>(header.flags);
+    memcpy(out + 2, &header.reserved, 2);
+    memcpy(out + 4, &header.sequenceNum, 4);
+    memcpy(out + 8, &header.payloadSize, 4);
+    memcpy(out + 12, &header.enqueuedNs, 8);
+    memcpy(out + 20, &header.sentNs, 8);
+    memcpy(out + 28, &header.fragmentOffset, 4);
+}
+
+void decodeFrameHeader(const char* in, FrameHeader& header) {
+    header.priority = static_cast<uint8_t>(in[0]);
+    header.flags = static_cast<uint8_t>(in[1]);
+    memcpy(&header.reserved, in + 2, 2);
+    memcpy(&header.sequenceNum, in + 4, 4);
+    memcpy(&header.payloadSize, in + 8, 4);
+    memcpy(&header.enqueuedNs, in + 12, 8);
+    memcpy(&header.sentNs, in + 20, 8);
+    memcpy(&header.fragmentOffset, in + 28, 4);
+}
+
+int64_t steadyNanoseconds(std::chrono::steady_clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+bool sendAll(SOCKET sock, const char* data, int size) {
+    while (size > 0) {
+        int sent = send(sock, data, size, 0);
+        if (sent <= 0) return false;
+        data += sent;
+        size -= sent;
+    }
+    return true;
+}
+
+bool recvAll(SOCKET sock, char* data, int size) {
+    while (size > 0) {
+        int received = recv(sock, data, size, 0);
+        if (received <= 0) return false;
+        data += received;
+        size -= received;
+    }
+    return true;
+}
+
+// Models the bottleneck link: the next frame may start once the previous one has
+// been serialized at bytesPerSecond. The sender waits on the link, not per class,
+// and only once it is a millisecond ahead so small frames keep the average rate
+// despite timer granularity.
+class LinkPacer {
+private:
+    double bytesPerSecond;
+    std::chrono::steady_clock::time_point linkFreeAt;
+
+public:
+    explicit LinkPacer(double rate) : bytesPerSecond(rate), linkFreeAt(std::chrono::steady_clock::now()) {}
+
+    void transmitted(int bytes) {
+        auto now = std::chrono::steady_clock::now();
+        if (linkFreeAt < now) linkFreeAt = now;
+        linkFreeAt += std::chrono::nanoseconds(static_cast<long long>(bytes * 1e9 / bytesPerSecond));
+        if (linkFreeAt - now >= std::chrono::milliseconds(1)) std::this_thread::sleep_until(linkFreeAt);
+    }
+};
+
+struct DelaySample {
+    int64_t atNs;
+    double ms;
+};
+
+// Per-class delay measurements for the congestion control loop: queueing delay in
+// the scheduler (enqueue -> on the wire) and RTT (on the wire -> echo back). The
+// loop consumes the minimum RTT one interval at a time, as CoDel does.
+class DelayMonitor {
+private:
+    std::mutex mutex;
+    std::vector<DelaySample> queueingDelays[CLASS_COUNT];
+    std::vector<DelaySample> rtts[CLASS_COUNT];
+    double intervalMinRttMs;
+
+    static std::vector<double> samplesBetween(const std::vector<DelaySample>& samples, int64_t fromNs, int64_t toNs) {
+        std::vector<double> values;
+        for (const DelaySample& sample : samples) {
+            if (sample.atNs >= fromNs && sample.atNs < toNs) values.push_back(sample.ms);
+        }
+        return values;
+    }
+
+public:
+    DelayMonitor() : intervalMinRttMs(-1.0) {}
+
+    void recordQueueingDelay(int c, int64_t nowNs, double ms) {
+        std::lock_guard<std::mutex> lock(mutex);
+        queueingDelays[c].push_back(DelaySample{ nowNs, ms });
+    }
+
+    void recordRtt(int c, int64_t nowNs, double ms) {
+        std::lock_guard<std::mutex> lock(mutex);
+        rtts[c].push_back(DelaySample{ nowNs, ms });
+        if (intervalMinRttMs < 0.0 || ms < intervalMinRttMs) intervalMinRttMs = ms;
+    }
+
+    // Minimum RTT over all classes since the previous call; -1 without samples
+    double takeIntervalMinRtt() {
+        std::lock_guard<std::mutex> lock(mutex);
+        double minRtt = intervalMinRttMs;
+        intervalMinRttMs = -1.0;
+        return minRtt;
+    }
+
+    std::vector<double> queueingDelaysBetween(int c, int64_t fromNs, int64_t toNs) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return samplesBetween(queueingDelays[c], fromNs, toNs);
+    }
+
+    std::vector<double> rttsBetween(int c, int64_t fromNs, int64_t toNs) {
+        std::lock_guard<std::mutex> lock(mutex);
+        return samplesBetween(rtts[c], fromNs, toNs);
+    }
+};
+
+// The single sender thread: drains the scheduler onto the socket until it is closed.
+// linkBytesPerSecond = 0 leaves pacing to the scheduler (HTB root bucket).
+void runScheduledSender(PacketScheduler& scheduler, SOCKET sock, double linkBytesPerSecond, DelayMonitor* monitor = NULL) {
+    std::vector<char> frame(FRAME_HEADER_SIZE + MAX_FRAME_PAYLOAD, 'X');
+    LinkPacer link(linkBytesPerSecond);
+    QueuedPacket packet;
+
+    while (scheduler.dequeue(packet)) {
+        int64_t nowNs = steadyNanoseconds(std::chrono::steady_clock::now());
+        int64_t enqueuedNs = steadyNanoseconds(packet.enqueued);
+        FrameHeader header = { static_cast<uint8_t>(packet.priority),
+                               static_cast<uint8_t>(packet.lastFragment() ? 0 : FRAME_FLAG_MORE_FRAGMENTS), 0,
+                               static_cast<uint32_t>(packet.sequenceNum), static_cast<uint32_t>(packet.fragmentSize),
+                               enqueuedNs, nowNs, static_cast<uint32_t>(packet.fragmentOffset) };
+        encodeFrameHeader(header, frame.data());
+        if (monitor && packet.fragmentOffset == 0) {
+            monitor->recordQueueingDelay(packet.priority, nowNs, (nowNs - enqueuedNs) / 1e6);
+        }
+        if (!sendAll(sock, frame.data(), FRAME_HEADER_SIZE + packet.fragmentSize)) break;
+        if (linkBytesPerSecond > 0) link.transmitted(FRAME_HEADER_SIZE + packet.fragmentSize);
+    }
+}
+
+struct ReceivedClassStats {
+    uint64_t packets;
+    uint64_t bytes;
+    std::vector<double> latenciesMs;                  // enqueue -> fully received
+    std::vector<double> waitMs;                       // enqueue -> first byte on the wire
+    std::vector<std::pair<int64_t, uint32_t>> arrivals;  // (steady ns, payload bytes)
+
+    // Delivery rate over [from, to), to measure steady state without start-up bursts
+    double bytesPerSecondBetween(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) const {
+        int64_t fromNs = steadyNanoseconds(from), toNs = steadyNanoseconds(to);
+        uint64_t total = 0;
+        for (const auto& arrival : arrivals) {
+            if (arrival.first >= fromNs && arrival.first < toNs) total += arrival.second;
+        }
+        return total / std::chrono::duration<double>(to - from).count();
+    }
+};
+
+// Reads frames until the peer closes, reassembling fragments and collecting
+// per-class delivery statistics for complete packets.
+// maxBytesPerSecond > 0 models a slow consumer that cannot read faster than that.
+void receiveFrames(SOCKET sock, ReceivedClassStats stats[CLASS_COUNT], double maxBytesPerSecond = 0,
+                   bool echoFeedback = false) {
+    // One packet per class can be in reassembly: fragments of a class arrive in order
+    std::vector<char> reassembly[CLASS_COUNT];
+    uint32_t reassemblySequence[CLASS_COUNT];
+    uint32_t reassembled[CLASS_COUNT];
+    for (int c = 0; c < CLASS_COUNT; c++) {
+        reassembly[c].resize(MAX_FRAME_PAYLOAD);
+        reassemblySequence[c] = 0;
+        reassembled[c] = 0;
+    }
+    char headerBytes[FRAME_HEADER_SIZE];
+    FrameHeader header;
+    LinkPacer consumer(maxBytesPerSecond);
+
+    while (recvAll(sock, headerBytes, FRAME_HEADER_SIZE)) {
+        decodeFrameHeader(headerBytes, header);
+        if (header.priority >= CLASS_COUNT) break;
+        int c = header.priority;
+        if (header.fragmentOffset == 0) {
+            reassemblySequence[c] = header.sequenceNum;
+            reassembled[c] = 0;
+            stats[c].waitMs.push_back((header.sentNs - header.enqueuedNs) / 1e6);
+        }
+        else if (header.sequenceNum != reassemblySequence[c] || header.fragmentOffset != reassembled[c]) {
+            std::cerr << "[FAIL] Out-of-order fragment (class " << c << ", packet " << header.sequenceNum << ")" << std::endl;
+            break;
+        }
+        if (header.payloadSize > MAX_FRAME_PAYLOAD - header.fragmentOffset) break;
+        if (!recvAll(sock, reassembly[c].data() + header.fragmentOffset, static_cast<int>(header.payloadSize))) break;
+        reassembled[c] += header.payloadSize;
+
+        int64_t nowNs = steadyNanoseconds(std::chrono::steady_clock::now());
+        if (!(header.flags & FRAME_FLAG_MORE_FRAGMENTS)) {
+            ReceivedClassStats& classStats = stats[c];
+            classStats.packets++;
+            classStats.bytes += reassembled[c];
+            classStats.latenciesMs.push_back((nowNs - header.enqueuedNs) / 1e6);
+            classStats.arrivals.push_back(std::make_pair(nowNs, reassembled[c]));
+        }
+        if (echoFeedback) {
+            char feedback[FEEDBACK_SIZE];
+            feedback[0] = static_cast<char>(header.priority);
+            memcpy(feedback + 1, &header.sentNs, 8);
+            if (!sendAll(sock, feedback, FEEDBACK_SIZE)) break;
+        }
+        if (maxBytesPerSecond > 0) consumer.transmitted(FRAME_HEADER_SIZE + static_cast<int>(header.payloadSize));
+    }
+}
+
+// Sender side of the feedback channel: turns echoed send timestamps into RTTs
+void readFeedback(SOCKET sock, DelayMonitor& monitor) {
+    char feedback[FEEDBACK_SIZE];
+    while (recvAll(sock, feedback, FEEDBACK_SIZE)) {
+        int64_t sentNs;
+        memcpy(&sentNs, feedback + 1, 8);
+        int c = static_cast<uint8_t>(feedback[0]);
+        if (c >= CLASS_COUNT) break;
+        int64_t nowNs = steadyNanoseconds(std::chrono::steady_clock::now());
+        monitor.recordRtt(c, nowNs, (nowNs - sentNs) / 1e6);
+    }
+}
+
+// =====================================================================================
+// LINK EMULATOR (IMPAIRED LINK ON A VIRTUAL CLOCK)
+// =====================================================================================
+//
+// Loopback is fast, lossless and in order, so congestion and loss paths never run
+// against it. The emulator is a one-way message transport that behaves like an
+// impaired link instead:
+// - Rate: messages are serialized one after another at rateBytesPerSecond; what
+//   does not fit in the bottleneck buffer (queueLimitBytes) is tail-dropped
+// - Propagation delay plus jitter (uniform in [0, jitterMs]); jitter alone keeps
+//   the order, as on a real path
+// - Reordering: a message is held back by reorderDelayMs so later ones overtake it
+// - Random loss, and bursty loss from a two-state (Gilbert-Elliott) channel: the
+//   bad state is entered and left with fixed probabilities per message
+// Time is a virtual clock the caller advances, and every random choice comes from
+// one seeded generator, so the same seed and inputs reproduce the same deliveries
+// to the nanosecond. Two emulators make a bidirectional path.
+
+struct LinkImpairment {
+    double rateBytesPerSecond;      // 0: unlimited
+    size_t queueLimitBytes;         // bottleneck buffer; 0: unlimited
+    double delayMs;                 // one-way propagation delay
+    double jitterMs;
+    double reorderProbability;
+    double reorderDelayMs;
+    double lossProbability;         // independent of other messages
+    double burstEnterProbability;   // good -> bad, per message
+    double burstExitProbability;    // bad -> good (mean burst length 1 / p)
+    double burstLossProbability;    // loss while in the bad state
+    uint64_t seed;
+};
+
+// A clean link of the given rate and delay; impairments are added field by field
+LinkImpairment cleanLink(double rateBytesPerSecond, double delayMs, uint64_t seed = 1) {
+    LinkImpairment link = { rateBytesPerSecond, 0, delayMs, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, seed };
+    return link;
+}
+
+// Virtual time in nanoseconds, also exposed as steady_clock time points for code
+// that takes them (the packet scheduler and its token buckets)
+class VirtualClock {
+private:
+    std::chrono::steady_clock::time_point epoch;
+    int64_t elapsedNs;
+
+public:
+    VirtualClock() : epoch(std::chrono::steady_clock::now()), elapsedNs(0) {}
+
+    int64_t nowNs() const { return elapsedNs; }
+    std::chrono::steady_clock::time_point now() const { return at(elapsedNs); }
+    std::chrono::steady_clock::time_point at(int64_t ns) const { return epoch + std::chrono::nanoseconds(ns); }
+    int64_t nanosecondsAt(std::chrono::steady_clock::time_point time) const {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(time - epoch).count();
+    }
+
+    // Time never goes backwards
+    void advanceTo(int64_t ns) { elapsedNs = std::max(elapsedNs, ns); }
+};
+
+const int64_t NO_EVENT_NS = INT64_MAX;
+
+struct LinkEmulatorStats {
+    uint64_t sent;
+    uint64_t delivered;
+    uint64_t bytesDelivered;
+    uint64_t droppedQueue;
+    uint64_t droppedRandom;
+    uint64_t droppedBurst;
+    uint64_t reordered;     // held back on purpose
+};
+
+class LinkEmulator {
+private:
+    LinkImpairment impairment;
+    std::mt19937_64 random;
+    bool badState;
+    int64_t transmitFreeNs;    // the bottleneck finishes everything accepted so far
+    int64_t lastInOrderNs;     // latest delivery time of a message not held back
+    uint64_t nextOrder;
+    std::map<std::pair<int64_t, uint64_t>, std::vector<char> > inFlight;   // (delivery, order)
+
+    // Uniform in [0, 1) from the raw 64-bit output: std distributions are not
+    // specified bit for bit, the engine is, so traces match on every platform
+    double uniform() { return static_cast<double>(random() >> 11) * (1.0 / 9007199254740992.0); }
+
+    static int64_t toNs(double ms) { return static_cast<int64_t>(std::llround(ms * 1e6)); }
+
+public:
+    LinkEmulatorStats stats;
+
+    explicit LinkEmulator(const LinkImpairment& link)
+        : impairment(link), random(link.seed), badState(false), transmitFreeNs(0), lastInOrderNs(0), nextOrder(0),
+          stats(LinkEmulatorStats{ 0, 0, 0, 0, 0, 0, 0 }) {}
+
+    // Hands a message to the link at `nowNs`; false if it will never arrive
+    bool send(int64_t nowNs, const char* data, int size) {
+        stats.sent++;
+        int64_t startNs = std::max(nowNs, transmitFreeNs);
+        if (impairment.rateBytesPerSecond > 0.0) {
+            if (impairment.queueLimitBytes > 0 &&
+                queuedBytes(nowNs) + size > static_cast<double>(impairment.queueLimitBytes)) {
+                stats.droppedQueue++;
+                return false;
+            }
+            transmitFreeNs = startNs + static_cast<int64_t>(std::llround(size * 1e9 / impairment.rateBytesPerSecond));
+        }
+        else {
+            transmitFreeNs = startNs;
+        }
+
+        // Lost on the wire: the message still used its share of the link
+        if (impairment.burstEnterProbability > 0.0) {
+            badState = badState ? uniform() >= impairment.burstExitProbability
+                                : uniform() < impairment.burstEnterProbability;
+            if (badState && uniform() < impairment.burstLossProbability) {
+                stats.droppedBurst++;
+                return false;
+            }
+        }
+        if (impairment.lossProbability > 0.0 && uniform() < impairment.lossProbability) {
+            stats.droppedRandom++;
+            return false;
+        }
+
+        int64_t deliverNs = transmitFreeNs + toNs(impairment.delayMs);
+        if (impairment.jitterMs > 0.0) deliverNs += toNs(uniform() * impairment.jitterMs);
+        if (impairment.reorderProbability > 0.0 && uniform() < impairment.reorderProbability) {
+            deliverNs += toNs(impairment.reorderDelayMs);
+            stats.reordered++;
+        }
+        else {
+            deliverNs = std::max(deliverNs, lastInOrderNs);
+            lastInOrderNs = deliverNs;
+        }
+        inFlight[std::make_pair(deliverNs, nextOrder++)].assign(data, data + size);
+        return true;
+    }
+
+    // Takes the next message that has arrived by `nowNs`
+    bool receive(int64_t nowNs, std::vector<char>& message) {
+        if (inFlight.empty() || inFlight.begin()->first.first > nowNs) return false;
+        message.swap(inFlight.begin()->second);
+        inFlight.erase(inFlight.begin());
+        stats.delivered++;
+        stats.bytesDelivered += message.size();
+        return true;
+    }
+
+    // Bytes waiting for the bottleneck at `nowNs`
+    double queuedBytes(int64_t nowNs) const {
+        if (impairment.rateBytesPerSecond <= 0.0 || transmitFreeNs <= nowNs) return 0.0;
+        return (transmitFreeNs - nowNs) * impairment.rateBytesPerSecond / 1e9;
+    }
+
+    // When the next message arrives, and when the bottleneck becomes idle
+    int64_t nextDeliveryNs() const { return inFlight.empty() ? NO_EVENT_NS : inFlight.begin()->first.first; }
+    int64_t idleAtNs() const { return transmitFreeNs; }
+    bool empty() const { return inFlight.empty(); }
+};
+
 // =====================================================================================
 // QoS MANAGER
 // =====================================================================================
 
+const double CONGESTION_TARGET_MS = 3.0;      // acceptable standing queue, with room for overshoot below a 10 ms SLA
+const int CONGESTION_INTERVAL_MS = 10;        // control loop period: the loop's own RTT, several path RTTs
+const double CONGESTION_INCREASE_PER_SECOND = 0.4;  // additive increase below the target
+const double CONGESTION_INCREASE = CONGESTION_INCREASE_PER_SECOND * CONGESTION_INTERVAL_MS / 1000.0;  // per interval
+const double CONGESTION_DECREASE_GAIN = 0.8;  // share of the excess delay removed by one cut
+const double CONGESTION_MAX_CUT = 0.2;        // one cut removes at most 20% of the scale
+const double MIN_LOWER_CLASS_SCALE = 0.05;    // lower classes never starve completely
+
 class QoSManager {
 private:
-    std::map<Priority, int> bandwidthAllocation;  // Percentage
+    std::map<Priority, int> bandwidthAllocation;  // Percentage (guaranteed)
+    std::map<Priority, int> bandwidthCeiling;     // Percentage (including borrowed)
     std::map<Priority, double> maxLatency;        // ms
     bool dynamicMode;
     bool securityMode;
+    double lowerClassScale;                       // congestion control: share of the configured rates
+    int holdIntervals;                            // after a cut: intervals before its effect is visible
+    int controlIntervals;                         // control loop runs with a measurement
+    int congestionCuts;
+    double worstIntervalDelayMs;                  // largest per-interval minimum seen
+    std::chrono::steady_clock::time_point nextControlAt;
 
 public:
-    QoSManager() : dynamicMode(false), securityMode(false) {
+    QoSManager()
+        : dynamicMode(false), securityMode(false), lowerClassScale(1.0), holdIntervals(0), controlIntervals(0),
+          congestionCuts(0), worstIntervalDelayMs(0.0), nextControlAt(std::chrono::steady_clock::now()) {
         // Default bandwidth allocation
         bandwidthAllocation[HIGH] = 70;
         bandwidthAllocation[MEDIUM] = 20;
         bandwidthAllocation[LOW] = 10;
 
+        // Ceilings: bulk traffic may borrow idle bandwidth, but never more than 30%
+        bandwidthCeiling[HIGH] = 100;
+        bandwidthCeiling[MEDIUM] = 100;
+        bandwidthCeiling[LOW] = 30;
+
         // SLA latency requirements
         maxLatency[HIGH] = 10.0;      // Critical: max 10ms
         maxLatency[MEDIUM] = 50.0;    // Normal: max 50ms
@@ -188,6 +1028,36 @@ public:
         }
     }
 
+    // Scheduler settings from the allocation: HIGH is served with strict priority,
+    // MEDIUM and LOW share the rest by DRR with their percentages as weights
+    SchedulerClassConfig getSchedulerConfig(Priority priority) {
+        SchedulerClassConfig classConfig;
+        classConfig.strictPriority = priority == HIGH;
+        classConfig.weight = bandwidthAllocation[priority];
+        classConfig.queueLimit = priority == LOW ? 16 : 64;
+        return classConfig;
+    }
+
+    // Token-bucket shaper enforcing the allocation on a link of the given rate.
+    // Classes below HIGH are scaled down by the congestion control loop. The burst
+    // covers two of the largest frames on the wire (a whole bulk packet by default).
+    ShaperConfig getShaperConfig(double linkBytesPerSecond, int largestFrameBytes = 0) {
+        ShaperConfig shaper;
+        shaper.linkBytesPerSecond = linkBytesPerSecond;
+        shaper.burstBytes = 2.0 * (largestFrameBytes > 0 ? largestFrameBytes : getPacketSize(BULK));
+        for (int c = 0; c < CLASS_COUNT; c++) {
+            Priority priority = static_cast<Priority>(c);
+            double scale = priority == HIGH ? 1.0 : lowerClassScale;
+            shaper.classes[c].rateBytesPerSecond = linkBytesPerSecond * bandwidthAllocation[priority] / 100.0 * scale;
+            shaper.classes[c].ceilBytesPerSecond = linkBytesPerSecond * bandwidthCeiling[priority] / 100.0 * scale;
+        }
+        return shaper;
+    }
+
+    // Sleep-based prioritization used by the interactive modes. It only delays the
+    // calling thread; see PacketScheduler for real isolation between classes.
+    // In dynamic mode the lower classes are paced at their scaled rate: a class at
+    // half its allocation waits twice as long between packets.
     void applyQoSDelay(Priority priority, int mode) {
         if (mode == 0) {
             // No QoS - all traffic gets same treatment
@@ -195,17 +1065,20 @@ public:
         }
         else {
             // Apply priority-based delays
+            double delayMs = 1.0;
             switch (priority) {
             case HIGH:
-                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+                delayMs = 1.0;
                 break;
             case MEDIUM:
-                std::this_thread::sleep_for(std::chrono::milliseconds(5));
+                delayMs = 5.0;
                 break;
             case LOW:
-                std::this_thread::sleep_for(std::chrono::milliseconds(15));
+                delayMs = 15.0;
                 break;
             }
+            if (dynamicMode && priority != HIGH) delayMs /= lowerClassScale;
+            std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(delayMs));
         }
     }
 
@@ -231,13 +1104,50 @@ public:
         }
     }
 
-    void adjustPrioritiesForCongestion() {
-        std::cout << "\n[!] Network congestion detected!" << std::endl;
-        std::cout << "[!] Adjusting QoS priorities dynamically..." << std::endl;
-        std::this_thread::sleep_for(std::chrono::milliseconds(500));
-        std::cout << "[OK] Critical traffic: bandwidth increased to 80%" << std::endl;
-        std::cout << "[OK] Bulk traffic: bandwidth reduced to 5%" << std::endl;
+    // CoDel-like control loop, called every CONGESTION_INTERVAL_MS with the minimum
+    // delay measured over that interval (-1 if nothing was measured). A minimum above
+    // the target is a standing queue, not a burst: the lower classes are cut in
+    // proportion to the excess delay, as in Swift (scale *= 1 - gain * excess / delay),
+    // by at most CONGESTION_MAX_CUT, and real-time traffic keeps its rate. The effect
+    // of a cut shows up one interval later, so the next interval is skipped. Below the
+    // target, bandwidth is given back additively, about 1.5% of the current share per
+    // interval: a capped cut is recovered in a dozen intervals, so the link stays busy.
+    // Returns true if rates changed.
+    bool adjustPrioritiesForCongestion(double minDelayMs) {
+        if (!dynamicMode || minDelayMs < 0.0) return false;
+        controlIntervals++;
+        worstIntervalDelayMs = std::max(worstIntervalDelayMs, minDelayMs);
+        double previousScale = lowerClassScale;
+        if (minDelayMs <= CONGESTION_TARGET_MS) {
+            holdIntervals = 0;
+            lowerClassScale = std::min(1.0, lowerClassScale + CONGESTION_INCREASE);
+        }
+        else if (holdIntervals > 0) {
+            holdIntervals--;
+        }
+        else {
+            double excess = (minDelayMs - CONGESTION_TARGET_MS) / minDelayMs;
+            double cut = std::max(1.0 - CONGESTION_MAX_CUT, 1.0 - CONGESTION_DECREASE_GAIN * excess);
+            lowerClassScale = std::max(MIN_LOWER_CLASS_SCALE, lowerClassScale * cut);
+            holdIntervals = 1;
+            congestionCuts++;
+        }
+        return lowerClassScale != previousScale;
     }
+
+    // For callers that run the loop from the traffic path: true once per elapsed interval
+    bool controlIntervalElapsed() {
+        auto now = std::chrono::steady_clock::now();
+        if (now < nextControlAt) return false;
+        nextControlAt = now + std::chrono::milliseconds(CONGESTION_INTERVAL_MS);
+        return true;
+    }
+
+    int getControlIntervals() const { return controlIntervals; }
+    int getCongestionCuts() const { return congestionCuts; }
+    double getWorstIntervalDelay() const { return worstIntervalDelayMs; }
+    double getLowerClassScale() const { return lowerClassScale; }
+    double getMaxLatency(Priority priority) { return maxLatency[priority]; }
 };
 
 // =====================================================================================
@@ -260,6 +1170,397 @@ void cleanupNetwork() {
 #endif
 }
 
+// =====================================================================================
+// ACKNOWLEDGEMENTS (CUMULATIVE + SELECTIVE)
+// =====================================================================================
+//
+// Demo traffic travels as frames (FrameHeader + payload). Instead of answering
+// every recv() with "ACK", the receiver acknowledges in batches:
+// - An ACK carries the cumulative sequence (every frame below it has arrived)
+//   plus up to MAX_SACK_RANGES ranges received beyond a gap (selective ACK)
+// - It goes out every ackEvery frames, once ackDelayMs has passed since the first
+//   unacknowledged frame, as soon as a gap opens or closes, and when the sender
+//   asks for one (FRAME_FLAG_ACK_NOW: its window is full or a burst ended)
+// The sender keeps up to `window` unacknowledged frames in flight instead of
+// stopping to wait for each one, and retransmits frames a SACK shows missing.
+
+const uint8_t FRAME_FLAG_ACK_NOW = 0x01;
+const int MAX_SACK_RANGES = 4;
+const int ACK_HEADER_SIZE = 5;        // cumulative sequence (4) + range count (1)
+const int ACK_RANGE_SIZE = 8;         // [start, end)
+const size_t DEFAULT_ACK_WINDOW = 64; // frames in flight
+
+struct AckPolicy {
+    int ackEvery;     // frames per ACK
+    int ackDelayMs;   // longest an arrived frame waits for its ACK
+};
+
+const AckPolicy DEFAULT_ACK_POLICY = { 16, 2 };
+
+struct AckRange {
+    uint32_t start;
+    uint32_t end;   // exclusive
+};
+
+struct AckMessage {
+    uint32_t cumulative;
+    std::vector<AckRange> ranges;
+};
+
+int encodeAck(const AckMessage& ack, char* out) {
+    memcpy(out, &ack.cumulative, 4);
+    out[4] = static_cast<char>(ack.ranges.size());
+    int size = ACK_HEADER_SIZE;
+    for (const AckRange& range : ack.ranges) {
+        memcpy(out + size, &range.start, 4);
+        memcpy(out + size + 4, &range.end, 4);
+        size += ACK_RANGE_SIZE;
+    }
+    return size;
+}
+
+// Receiver-side record of which sequences arrived
+class SackTracker {
+private:
+    uint32_t cumulative;           // every sequence below has arrived
+    std::set<uint32_t> beyond;     // arrived above a gap
+
+public:
+    SackTracker() : cumulative(0) {}
+
+    // Returns false for a duplicate
+    bool record(uint32_t sequence) {
+        if (sequence < cumulative || beyond.count(sequence)) return false;
+        if (sequence != cumulative) {
+            beyond.insert(sequence);
+            return true;
+        }
+        cumulative++;
+        while (!beyond.empty() && *beyond.begin() == cumulative) {
+            beyond.erase(beyond.begin());
+            cumulative++;
+        }
+        return true;
+    }
+
+    bool hasGap() const { return !beyond.empty(); }
+
+    AckMessage ack() const {
+        AckMessage message;
+        message.cumulative = cumulative;
+        for (uint32_t sequence : beyond) {
+            if (!message.ranges.empty() && message.ranges.back().end == sequence) {
+                message.ranges.back().end++;
+            }
+            else if (message.ranges.size() < static_cast<size_t>(MAX_SACK_RANGES)) {
+                message.ranges.push_back(AckRange{ sequence, sequence + 1 });
+            }
+            else {
+                break;
+            }
+        }
+        return message;
+    }
+};
+
+// Buffered reads: one recv() can deliver many frames or ACKs. recv calls are
+// counted for the syscall statistics.
+class SocketReader {
+private:
+    SOCKET sock;
+    std::vector<char> buffer;
+    size_t begin;
+    size_t end;
+
+public:
+    uint64_t recvCalls;
+
+    explicit SocketReader(SOCKET s, size_t capacity = 256 * 1024)
+        : sock(s), buffer(capacity), begin(0), end(0), recvCalls(0) {}
+
+    size_t buffered() const { return end - begin; }
+
+    // Reads exactly `size` bytes into out (NULL discards them)
+    bool read(char* out, size_t size) {
+        while (size > 0) {
+            if (begin == end) {
+                begin = end = 0;
+                int received = recv(sock, buffer.data(), static_cast<int>(buffer.size()), 0);
+                recvCalls++;
+                if (received <= 0) return false;
+                end = static_cast<size_t>(received);
+            }
+            size_t chunk = std::min(size, end - begin);
+            if (out) {
+                memcpy(out, buffer.data() + begin, chunk);
+                out += chunk;
+            }
+            begin += chunk;
+            size -= chunk;
+        }
+        return true;
+    }
+};
+
+// True if the socket becomes readable (data or EOF) within the timeout
+bool waitReadable(SOCKET sock, long timeoutMicros) {
+    fd_set readSet;
+    FD_ZERO(&readSet);
+    FD_SET(sock, &readSet);
+    timeval timeout;
+    timeout.tv_sec = timeoutMicros / 1000000;
+    timeout.tv_usec = timeoutMicros % 1000000;
+    return select(static_cast<int>(sock) + 1, &readSet, NULL, NULL, &timeout) > 0;
+}
+
+struct AckServerStats {
+    uint64_t frames;        // unique frames delivered
+    uint64_t duplicates;
+    uint64_t bytes;
+    uint64_t acksSent;
+    uint64_t recvCalls;
+    uint64_t sendCalls;
+    uint64_t selectCalls;
+};
+
+// Receives frames until the peer closes, acknowledging them according to the policy
+void serveAckedConnection(SOCKET sock, const AckPolicy& policy, AckServerStats& stats) {
+    stats = AckServerStats{ 0, 0, 0, 0, 0, 0, 0 };
+    int noDelay = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (char*)&noDelay, sizeof(noDelay));
+
+    SocketReader reader(sock);
+    SackTracker tracker;
+    char headerBytes[FRAME_HEADER_SIZE];
+    char ackBytes[ACK_HEADER_SIZE + MAX_SACK_RANGES * ACK_RANGE_SIZE];
+    int unacknowledged = 0;
+    std::chrono::steady_clock::time_point ackDeadline;
+
+    auto sendAck = [&]() -> bool {
+        int size = encodeAck(tracker.ack(), ackBytes);
+        stats.sendCalls++;
+        stats.acksSent++;
+        unacknowledged = 0;
+        return sendAll(sock, ackBytes, size);
+    };
+
+    while (true) {
+        // Between frames, wait no longer than the pending ACK may be delayed
+        if (unacknowledged > 0 && reader.buffered() == 0) {
+            long waitMicros = static_cast<long>(std::chrono::duration_cast<std::chrono::microseconds>(
+                ackDeadline - std::chrono::steady_clock::now()).count());
+            stats.selectCalls++;
+            if (waitMicros <= 0 || !waitReadable(sock, waitMicros)) {
+                if (!sendAck()) break;
+                continue;
+            }
+        }
+
+        if (!reader.read(headerBytes, FRAME_HEADER_SIZE)) break;
+        FrameHeader header;
+        decodeFrameHeader(headerBytes, header);
+        if (header.payloadSize > MAX_FRAME_PAYLOAD || !reader.read(NULL, header.payloadSize)) break;
+
+        bool hadGap = tracker.hasGap();
+        if (tracker.record(header.sequenceNum)) {
+            stats.frames++;
+            stats.bytes += header.payloadSize;
+        }
+        else {
+            stats.duplicates++;
+        }
+        if (unacknowledged++ == 0) ackDeadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(policy.ackDelayMs);
+
+        bool ackNow = (header.flags & FRAME_FLAG_ACK_NOW) != 0 || tracker.hasGap() != hadGap ||
+                      unacknowledged >= policy.ackEvery;
+        if (ackNow && !sendAck()) break;
+    }
+    stats.recvCalls = reader.recvCalls;
+}
+
+// Sender side: a window of unacknowledged frames. A reader thread timestamps ACKs
+// as they arrive; this thread is the only writer and retransmits what a SACK
+// reported missing. simulatedLoss drops first transmissions on purpose (never
+// frames that request an ACK, so a gap is always reported) to exercise SACK.
+// With a DelayMonitor attached, every ACK of a frame sent once is an RTT sample
+// (retransmitted frames are ambiguous and skipped, as in Karn's algorithm).
+class AckedConnection {
+private:
+    struct InFlightFrame {
+        Priority priority;
+        int size;
+        std::chrono::steady_clock::time_point start;   // latency is measured from here
+        std::chrono::steady_clock::time_point sent;    // RTT is measured from here
+        bool retransmitted;
+        std::vector<double>* latencies;
+    };
+
+    SOCKET sock;
+    DelayMonitor* monitor;
+    size_t window;
+    double simulatedLoss;
+    std::mt19937 random;
+    uint32_t nextSequence;
+    std::vector<char> frame;
+
+    std::mutex mutex;
+    std::condition_variable progress;
+    std::map<uint32_t, InFlightFrame> inFlight;
+    std::vector<uint32_t> lostFrames;   // reported by SACK, waiting for retransmission
+    bool connectionLost;
+    uint64_t recvCalls;
+    std::thread ackReader;
+
+    bool transmit(uint32_t sequence, const InFlightFrame& packet, bool ackNow) {
+        FrameHeader header = { static_cast<uint8_t>(packet.priority), static_cast<uint8_t>(ackNow ? FRAME_FLAG_ACK_NOW : 0),
+                               0, sequence, static_cast<uint32_t>(packet.size), steadyNanoseconds(packet.start),
+                               steadyNanoseconds(std::chrono::steady_clock::now()), 0 };
+        encodeFrameHeader(header, frame.data());
+        framesSent++;
+        if (!ackNow && simulatedLoss > 0.0 && std::uniform_real_distribution<double>(0.0, 1.0)(random) < simulatedLoss) {
+            framesLost++;
+            return true;
+        }
+        sendCalls++;
+        return sendAll(sock, frame.data(), FRAME_HEADER_SIZE + packet.size);
+    }
+
+    std::map<uint32_t, InFlightFrame>::iterator acknowledgeLocked(std::map<uint32_t, InFlightFrame>::iterator it,
+                                                                  std::chrono::steady_clock::time_point now) {
+        if (it->second.latencies) {
+            it->second.latencies->push_back(std::chrono::duration<double, std::milli>(now - it->second.start).count());
+        }
+        if (monitor && !it->second.retransmitted) {
+            monitor->recordRtt(it->second.priority, steadyNanoseconds(now),
+                               std::chrono::duration<double, std::milli>(now - it->second.sent).count());
+        }
+        return inFlight.erase(it);
+    }
+
+    void readAcks() {
+        SocketReader reader(sock, 16 * 1024);
+        char ackBytes[MAX_SACK_RANGES * ACK_RANGE_SIZE];
+        while (reader.read(ackBytes, ACK_HEADER_SIZE)) {
+            AckMessage ack;
+            memcpy(&ack.cumulative, ackBytes, 4);
+            size_t rangeCount = static_cast<uint8_t>(ackBytes[4]);
+            if (rangeCount > static_cast<size_t>(MAX_SACK_RANGES) ||
+                !reader.read(ackBytes, rangeCount * ACK_RANGE_SIZE)) break;
+            for (size_t r = 0; r < rangeCount; r++) {
+                AckRange range;
+                memcpy(&range.start, ackBytes + r * ACK_RANGE_SIZE, 4);
+                memcpy(&range.end, ackBytes + r * ACK_RANGE_SIZE + 4, 4);
+                ack.ranges.push_back(range);
+            }
+
+            auto now = std::chrono::steady_clock::now();
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                acksReceived++;
+                while (!inFlight.empty() && inFlight.begin()->first < ack.cumulative) {
+                    acknowledgeLocked(inFlight.begin(), now);
+                }
+                uint32_t highestSacked = ack.cumulative;
+                for (const AckRange& range : ack.ranges) {
+                    auto it = inFlight.lower_bound(range.start);
+                    while (it != inFlight.end() && it->first < range.end) it = acknowledgeLocked(it, now);
+                    highestSacked = std::max(highestSacked, range.end);
+                }
+                // Anything still in flight below a selectively acknowledged frame was lost
+                for (auto it = inFlight.begin(); it != inFlight.end() && it->first < highestSacked; ++it) {
+                    if (!it->second.retransmitted) {
+                        it->second.retransmitted = true;
+                        lostFrames.push_back(it->first);
+                    }
+                }
+            }
+            progress.notify_one();
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        connectionLost = true;
+        recvCalls = reader.recvCalls;
+        progress.notify_one();
+    }
+
+    // Retransmits reported losses; called with the lock held, released while sending
+    bool retransmitLost(std::unique_lock<std::mutex>& lock) {
+        while (!lostFrames.empty()) {
+            uint32_t sequence = lostFrames.back();
+            lostFrames.pop_back();
+            auto it = inFlight.find(sequence);
+            if (it == inFlight.end()) continue;
+            InFlightFrame packet = it->second;
+            retransmissions++;
+            lock.unlock();
+            bool sent = transmit(sequence, packet, true);
+            lock.lock();
+            if (!sent) return false;
+        }
+        return true;
+    }
+
+public:
+    uint64_t framesSent;
+    uint64_t framesLost;       // dropped on purpose (simulatedLoss)
+    uint64_t retransmissions;
+    uint64_t acksReceived;
+    uint64_t sendCalls;
+
+    explicit AckedConnection(SOCKET s, size_t windowFrames = DEFAULT_ACK_WINDOW, double lossRate = 0.0, unsigned seed = 1,
+                             DelayMonitor* delayMonitor = NULL)
+        : sock(s), monitor(delayMonitor), window(std::max<size_t>(1, windowFrames)), simulatedLoss(lossRate), random(seed), nextSequence(0),
+          frame(FRAME_HEADER_SIZE + MAX_FRAME_PAYLOAD, 'X'), connectionLost(false), recvCalls(0), framesSent(0),
+          framesLost(0), retransmissions(0), acksReceived(0), sendCalls(0) {
+        int noDelay = 1;
+        setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (char*)&noDelay, sizeof(noDelay));
+        ackReader = std::thread(&AckedConnection::readAcks, this);
+    }
+
+    ~AckedConnection() { close(); }
+
+    // Blocks while the window is full. Latency (start -> acknowledged) goes to `latencies`.
+    bool send(Priority priority, int size, std::chrono::steady_clock::time_point start, bool requestAck,
+              std::vector<double>* latencies) {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            if (!retransmitLost(lock) || connectionLost) return false;
+            if (inFlight.size() < window) break;
+            progress.wait(lock);
+        }
+        uint32_t sequence = nextSequence++;
+        InFlightFrame packet = { priority, std::min(size, MAX_FRAME_PAYLOAD), start, std::chrono::steady_clock::now(),
+                                 false, latencies };
+        inFlight[sequence] = packet;
+        bool fillsWindow = inFlight.size() >= window;
+        lock.unlock();
+        return transmit(sequence, packet, requestAck || fillsWindow);
+    }
+
+    // Waits until every frame is acknowledged
+    bool drain() {
+        std::unique_lock<std::mutex> lock(mutex);
+        while (!inFlight.empty()) {
+            if (!retransmitLost(lock) || connectionLost) return false;
+            if (inFlight.empty()) break;
+            progress.wait(lock);
+        }
+        return true;
+    }
+
+    // Drains, then half-closes: the receiver sees EOF and closes, ending the ACK reader
+    void close() {
+        if (!ackReader.joinable()) return;
+        drain();
+        shutdown(sock, SD_SEND);
+        ackReader.join();
+    }
+
+    uint64_t recvCallCount() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return recvCalls;
+    }
+};
+
 // =====================================================================================
 // SERVER FUNCTION
 // =====================================================================================
@@ -309,22 +1610,12 @@ void runServer() {
 
     std::cout << "[OK] Client connected" << std::endl;
 
-    // Receive traffic packets
-    int totalPackets = 0;
-    std::vector<char> buffer(200000); // Use heap allocation instead of stack
-
-    while (true) {
-        int bytesReceived = recv(clientSocket, buffer.data(), static_cast<int>(buffer.size()), 0);
-        if (bytesReceived <= 0) break;
-
-        totalPackets++;
-
-        // Send acknowledgment
-        const char* ack = "ACK";
-        send(clientSocket, ack, 3, 0);
-    }
+    // Receive traffic frames, acknowledging them in batches
+    AckServerStats stats;
+    serveAckedConnection(clientSocket, DEFAULT_ACK_POLICY, stats);
 
-    std::cout << "[OK] Total packets received: " << totalPackets << std::endl;
+    std::cout << "[OK] Total packets received: " << stats.frames << " (" << stats.acksSent << " ACKs, "
+              << stats.recvCalls << " recv calls)" << std::endl;
 
     closesocket(clientSocket);
     closesocket(serverSocket);
@@ -334,33 +1625,32 @@ void runServer() {
 // CLIENT FUNCTIONS - DIFFERENT MODES
 // =====================================================================================
 
-void sendTraffic(SOCKET sock, TrafficType type, int count, QoSManager& qos, int mode, std::vector<double>& latencies, bool suspicious = false) {
+// With a DelayMonitor (the one attached to the connection), the congestion control
+// loop runs from here: once per elapsed interval, on that interval's minimum RTT.
+void sendTraffic(AckedConnection& connection, TrafficType type, int count, QoSManager& qos, int mode, std::vector<double>& latencies, bool suspicious = false,
+                 DelayMonitor* monitor = NULL) {
     Priority priority = qos.assignPriority(type, suspicious);
     int packetSize = qos.getPacketSize(type);
 
-    std::vector<char> buffer(packetSize, 'X');
-    char ackBuffer[10];
-
     for (int i = 0; i < count; i++) {
-        Timer timer;
+        auto start = std::chrono::steady_clock::now();
 
         // Apply QoS delay before sending
         qos.applyQoSDelay(priority, mode);
 
-        // Send packet
-        int bytesSent = send(sock, buffer.data(), packetSize, 0);
-
-        if (bytesSent <= 0) {
+        // Send packet; the last one of the burst asks for an immediate ACK
+        if (!connection.send(priority, packetSize, start, i == count - 1, &latencies)) {
             std::cerr << "[FAIL] Send failed" << std::endl;
             break;
         }
 
-        // Receive acknowledgment
-        recv(sock, ackBuffer, sizeof(ackBuffer), 0);
-
-        double latency = timer.elapsed_ms();
-        latencies.push_back(latency);
+        if (monitor && qos.controlIntervalElapsed()) {
+            qos.adjustPrioritiesForCongestion(monitor->takeIntervalMinRtt());
+        }
     }
+
+    // Latencies are recorded as acknowledgements arrive
+    connection.drain();
 }
 
 QoSStats calculateStats(const std::string& name, TrafficType type, const std::vector<double>& latencies, QoSManager& qos, int packetSize) {
@@ -445,20 +1735,22 @@ void mode0_NoQoS() {
     }
 
     std::cout << "[OK] Connected to server" << std::endl;
+    AckedConnection connection(clientSocket);
     std::cout << "\nSending traffic..." << std::endl;
 
     // Send different traffic types
     std::vector<double> criticalLatencies, normalLatencies, bulkLatencies;
 
     std::cout << "  -> Sending Critical traffic (10 packets)..." << std::endl;
-    sendTraffic(clientSocket, CRITICAL, 10, qos, 0, criticalLatencies);
+    sendTraffic(connection, CRITICAL, 10, qos, 0, criticalLatencies);
 
     std::cout << "  -> Sending Normal traffic (10 packets)..." << std::endl;
-    sendTraffic(clientSocket, NORMAL, 10, qos, 0, normalLatencies);
+    sendTraffic(connection, NORMAL, 10, qos, 0, normalLatencies);
 
     std::cout << "  -> Sending Bulk traffic (10 packets)..." << std::endl;
-    sendTraffic(clientSocket, BULK, 10, qos, 0, bulkLatencies);
+    sendTraffic(connection, BULK, 10, qos, 0, bulkLatencies);
 
+    connection.close();
     closesocket(clientSocket);
 
     // Calculate and display stats
@@ -508,6 +1800,7 @@ void mode1_QoSPriority() {
     }
 
     std::cout << "[OK] Connected to server" << std::endl;
+    AckedConnection connection(clientSocket);
     std::cout << "[OK] QoS policies applied" << std::endl;
     std::cout << "\nSending traffic with QoS..." << std::endl;
 
@@ -515,14 +1808,15 @@ void mode1_QoSPriority() {
     std::vector<double> criticalLatencies, normalLatencies, bulkLatencies;
 
     std::cout << "  -> Sending Critical traffic (HIGH priority, 10 packets)..." << std::endl;
-    sendTraffic(clientSocket, CRITICAL, 10, qos, 1, criticalLatencies);
+    sendTraffic(connection, CRITICAL, 10, qos, 1, criticalLatencies);
 
     std::cout << "  -> Sending Normal traffic (MEDIUM priority, 10 packets)..." << std::endl;
-    sendTraffic(clientSocket, NORMAL, 10, qos, 1, normalLatencies);
+    sendTraffic(connection, NORMAL, 10, qos, 1, normalLatencies);
 
     std::cout << "  -> Sending Bulk traffic (LOW priority, 10 packets)..." << std::endl;
-    sendTraffic(clientSocket, BULK, 10, qos, 1, bulkLatencies);
+    sendTraffic(connection, BULK, 10, qos, 1, bulkLatencies);
 
+    connection.close();
     closesocket(clientSocket);
 
     // Calculate and display stats
@@ -547,7 +1841,7 @@ void mode1_QoSPriority() {
 void mode2_DynamicQoS() {
     std::cout << "\n=== MODE 2: DYNAMIC QoS ADJUSTMENT ===" << std::endl;
     std::cout << "QoS adapts to network conditions in real-time" << std::endl;
-    std::cout << "Simulates congestion detection and priority adjustment" << std::endl;
+    std::cout << "Congestion is detected from measured delay (see 'codel' for the loop under load)" << std::endl;
     std::cout << std::endl;
 
     QoSManager qos;
@@ -573,30 +1867,45 @@ void mode2_DynamicQoS() {
     }
 
     std::cout << "[OK] Connected to server" << std::endl;
-    std::cout << "[OK] Dynamic QoS monitoring enabled" << std::endl;
+    DelayMonitor monitor;
+    AckedConnection connection(clientSocket, DEFAULT_ACK_WINDOW, 0.0, 1, &monitor);
+    std::cout << "[OK] Dynamic QoS monitoring enabled (control interval " << CONGESTION_INTERVAL_MS << " ms)" << std::endl;
     std::cout << "\nPhase 1: Normal conditions..." << std::endl;
 
-    // Phase 1: Normal traffic
+    // Phase 1: Normal traffic. Every ACK is an RTT sample and the control loop runs
+    // on each interval's minimum while the traffic is being sent.
     std::vector<double> criticalLatencies1, normalLatencies1, bulkLatencies1;
 
     std::cout << "  -> Sending traffic under normal conditions..." << std::endl;
-    sendTraffic(clientSocket, CRITICAL, 5, qos, 1, criticalLatencies1);
-    sendTraffic(clientSocket, NORMAL, 5, qos, 1, normalLatencies1);
-    sendTraffic(clientSocket, BULK, 5, qos, 1, bulkLatencies1);
-
-    // Simulate congestion detection
-    qos.adjustPrioritiesForCongestion();
+    sendTraffic(connection, CRITICAL, 5, qos, 1, criticalLatencies1, false, &monitor);
+    sendTraffic(connection, NORMAL, 5, qos, 1, normalLatencies1, false, &monitor);
+    sendTraffic(connection, BULK, 5, qos, 1, bulkLatencies1, false, &monitor);
+
+    std::cout << "\n[i] Control loop: " << qos.getControlIntervals() << " intervals measured, worst interval minimum RTT "
+              << qos.getWorstIntervalDelay() << " ms (target " << CONGESTION_TARGET_MS << " ms)" << std::endl;
+    if (qos.getCongestionCuts() > 0) {
+        std::cout << "[!] Congestion detected " << qos.getCongestionCuts() << " time(s): lower-priority classes paced at "
+                  << qos.getLowerClassScale() * 100 << "% of their allocation" << std::endl;
+    }
+    else {
+        std::cout << "[OK] No standing queue: allocation unchanged, real-time traffic unaffected" << std::endl;
+    }
 
-    std::cout << "\nPhase 2: Under congestion (adjusted priorities)..." << std::endl;
+    std::cout << "\nPhase 2: Control loop still running..." << std::endl;
 
-    // Phase 2: Adjusted traffic
+    // Phase 2: lower classes are paced by whatever scale the loop has reached
     std::vector<double> criticalLatencies2, normalLatencies2, bulkLatencies2;
 
-    std::cout << "  -> Sending traffic with adjusted priorities..." << std::endl;
-    sendTraffic(clientSocket, CRITICAL, 5, qos, 1, criticalLatencies2);
-    sendTraffic(clientSocket, NORMAL, 5, qos, 1, normalLatencies2);
-    sendTraffic(clientSocket, BULK, 5, qos, 1, bulkLatencies2);
+    std::cout << "  -> Sending traffic with the current allocation..." << std::endl;
+    sendTraffic(connection, CRITICAL, 5, qos, 1, criticalLatencies2, false, &monitor);
+    sendTraffic(connection, NORMAL, 5, qos, 1, normalLatencies2, false, &monitor);
+    sendTraffic(connection, BULK, 5, qos, 1, bulkLatencies2, false, &monitor);
 
+    std::cout << "\n[i] Control loop: " << qos.getControlIntervals() << " intervals measured, " << qos.getCongestionCuts()
+              << " cut(s), lower classes at " << qos.getLowerClassScale() * 100 << "% of their allocation" << std::endl;
+    std::cout << "    (loopback rarely builds a standing queue; see 'codel' for the loop at a bottleneck)" << std::endl;
+
+    connection.close();
     closesocket(clientSocket);
 
     // Combine latencies
@@ -613,8 +1922,8 @@ void mode2_DynamicQoS() {
     displayStats(allStats);
 
     std::cout << "=== ANALYSIS ===" << std::endl;
-    std::cout << "- QoS automatically detected network congestion" << std::endl;
-    std::cout << "- Critical traffic bandwidth increased dynamically" << std::endl;
+    std::cout << "- Congestion is judged from measured delay against a target, not assumed" << std::endl;
+    std::cout << "- Under a standing queue, lower classes shrink while critical traffic keeps its rate" << std::endl;
     std::cout << "- System adapted without manual intervention" << std::endl;
     std::cout << "- Maintains service quality during varying conditions" << std::endl;
 }
@@ -652,6 +1961,7 @@ void mode3_QoSWithSecurity() {
     }
 
     std::cout << "[OK] Connected to server" << std::endl;
+    AckedConnection connection(clientSocket);
     std::cout << "[OK] QoS + Security policies active" << std::endl;
     std::cout << std::endl;
 
@@ -660,10 +1970,10 @@ void mode3_QoSWithSecurity() {
     std::vector<double> legitimateCritical, legitimateNormal;
 
     std::cout << "  -> Critical traffic (legitimate)..." << std::endl;
-    sendTraffic(clientSocket, CRITICAL, 5, qos, 1, legitimateCritical, false);
+    sendTraffic(connection, CRITICAL, 5, qos, 1, legitimateCritical, false);
 
     std::cout << "  -> Normal traffic (legitimate)..." << std::endl;
-    sendTraffic(clientSocket, NORMAL, 5, qos, 1, legitimateNormal, false);
+    sendTraffic(connection, NORMAL, 5, qos, 1, legitimateNormal, false);
 
     // Simulate threat detection
     std::cout << "\n[!] SECURITY ALERT: Suspicious traffic detected!" << std::endl;
@@ -677,11 +1987,12 @@ void mode3_QoSWithSecurity() {
     std::vector<double> suspiciousTraffic;
 
     std::cout << "  -> Bulk traffic (marked suspicious)..." << std::endl;
-    sendTraffic(clientSocket, BULK, 5, qos, 1, suspiciousTraffic, true);
+    sendTraffic(connection, BULK, 5, qos, 1, suspiciousTraffic, true);
 
     std::cout << "\n[OK] Legitimate critical traffic: PROTECTED" << std::endl;
     std::cout << "[OK] Suspicious traffic: DEPRIORITIZED" << std::endl;
 
+    connection.close();
     closesocket(clientSocket);
 
     // Calculate and display stats
@@ -700,6 +2011,952 @@ void mode3_QoSWithSecurity() {
     std::cout << "\n[OK] Check Wireshark: Notice traffic patterns and timing differences" << std::endl;
 }
 
+// =====================================================================================
+// SCHEDULER BENCHMARK (OVERLOADED LINK)
+// =====================================================================================
+//
+// Three generator threads offer more traffic than a 20 MB/s link can carry. A
+// single sender thread drains the scheduler onto a loopback TCP connection at
+// link rate, and the receiver measures per-class share and enqueue-to-delivery
+// latency. FIFO (no QoS) is compared with strict priority + DRR.
+
+const int SCHEDULER_BENCH_PORT = 8889;
+
+double percentileOf(std::vector<double> samples, double fraction) {
+    if (samples.empty()) return 0.0;
+    size_t rank = std::min(samples.size() - 1, static_cast<size_t>(fraction * samples.size()));
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+    return samples[rank];
+}
+
+// bufferBytes > 0 bounds the socket buffers (0 keeps the OS default)
+SOCKET createListeningSocket(int port, int bufferBytes = 0) {
+    SOCKET listener = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (listener == INVALID_SOCKET) return INVALID_SOCKET;
+    int opt = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, (char*)&opt, sizeof(opt));
+    if (bufferBytes > 0) {
+        // Inherited by the accepted socket
+        setsockopt(listener, SOL_SOCKET, SO_RCVBUF, (char*)&bufferBytes, sizeof(bufferBytes));
+    }
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_addr.s_addr = inet_addr(SERVER_IP);
+    address.sin_port = htons(port);
+    if (bind(listener, (sockaddr*)&address, sizeof(address)) == SOCKET_ERROR || listen(listener, 1) == SOCKET_ERROR) {
+        closesocket(listener);
+        return INVALID_SOCKET;
+    }
+    return listener;
+}
+
+SOCKET connectToLocalPort(int port, int bufferBytes = 0) {
+    SOCKET sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (sock == INVALID_SOCKET) return INVALID_SOCKET;
+    if (bufferBytes > 0) setsockopt(sock, SOL_SOCKET, SO_SNDBUF, (char*)&bufferBytes, sizeof(bufferBytes));
+    sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = inet_addr(SERVER_IP);
+    if (connect(sock, (sockaddr*)&address, sizeof(address)) == SOCKET_ERROR) {
+        closesocket(sock);
+        return INVALID_SOCKET;
+    }
+    int noDelay = 1;
+    setsockopt(sock, IPPROTO_TCP, TCP_NODELAY, (char*)&noDelay, sizeof(noDelay));
+    return sock;
+}
+
+struct TrafficSource {
+    Priority priority;
+    int packetSize;
+    int packetsPerSecond;
+};
+
+// Paced generator: enqueues packets on a fixed schedule until the deadline
+void generateTraffic(PacketScheduler& scheduler, const TrafficSource& source, std::chrono::steady_clock::time_point deadline) {
+    auto interval = std::chrono::nanoseconds(1000000000LL / source.packetsPerSecond);
+    auto next = std::chrono::steady_clock::now();
+    int sequence = 0;
+    while (next < deadline) {
+        std::this_thread::sleep_until(next);
+        QueuedPacket packet = { source.priority, source.packetSize, sequence++, std::chrono::steady_clock::now(), 0, 0 };
+        scheduler.enqueue(packet);
+        next += interval;
+    }
+}
+
+struct SessionResult {
+    ReceivedClassStats received[CLASS_COUNT];
+    SchedulerClassStats scheduled[CLASS_COUNT];
+    std::chrono::steady_clock::time_point start;     // generators started
+    std::chrono::steady_clock::time_point deadline;  // generators stopped
+    double elapsedSeconds;                           // until everything queued was delivered
+};
+
+// Runs generators -> scheduler -> one sender thread -> loopback TCP -> receiver.
+// With a monitor, the sender records queueing delays and the receiver echoes
+// every frame back so RTTs are measured too.
+bool runScheduledSession(PacketScheduler& scheduler, const TrafficSource sources[CLASS_COUNT], int durationMs,
+                         double linkBytesPerSecond, double receiverBytesPerSecond, SessionResult& result,
+                         DelayMonitor* monitor = NULL, int socketBufferBytes = 0) {
+    SOCKET listener = createListeningSocket(SCHEDULER_BENCH_PORT, socketBufferBytes);
+    if (listener == INVALID_SOCKET) {
+        std::cerr << "[FAIL] Cannot listen on port " << SCHEDULER_BENCH_PORT << std::endl;
+        return false;
+    }
+    for (int c = 0; c < CLASS_COUNT; c++) {
+        result.received[c].packets = 0;
+        result.received[c].bytes = 0;
+    }
+    std::thread receiver([&]() {
+        SOCKET connection = accept(listener, NULL, NULL);
+        if (connection == INVALID_SOCKET) return;
+        receiveFrames(connection, result.received, receiverBytesPerSecond, monitor != NULL);
+        closesocket(connection);
+    });
+
+    SOCKET sock = connectToLocalPort(SCHEDULER_BENCH_PORT, socketBufferBytes);
+    std::thread sender([&]() { runScheduledSender(scheduler, sock, linkBytesPerSecond, monitor); });
+    std::thread feedback;
+    if (monitor) feedback = std::thread([&]() { readFeedback(sock, *monitor); });
+
+    result.start = std::chrono::steady_clock::now();
+    result.deadline = result.start + std::chrono::milliseconds(durationMs);
+    std::vector<std::thread> generators;
+    for (int c = 0; c < CLASS_COUNT; c++) {
+        if (sources[c].packetsPerSecond > 0) {
+            generators.emplace_back(generateTraffic, std::ref(scheduler), std::cref(sources[c]), result.deadline);
+        }
+    }
+    for (auto& generator : generators) generator.join();
+
+    scheduler.close();
+    sender.join();
+    result.elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - result.start).count();
+    // Half-close: the receiver sees EOF and closes, which ends the feedback reader
+    shutdown(sock, SD_SEND);
+    receiver.join();
+    if (feedback.joinable()) feedback.join();
+    closesocket(sock);
+    closesocket(listener);
+    for (int c = 0; c < CLASS_COUNT; c++) result.scheduled[c] = scheduler.classStats(static_cast<Priority>(c));
+    return true;
+}
+
+const char* const CLASS_NAMES[CLASS_COUNT] = { "HIGH (real-time)", "MEDIUM (web)", "LOW (bulk)" };
+
+void runSchedulerBenchmark() {
+    const double linkBytesPerSecond = 20e6;
+    const int durationMs = 3000;
+    const TrafficSource sources[CLASS_COUNT] = {
+        { HIGH, 1024, 1000 },      // real-time: 1 MB/s of small packets
+        { MEDIUM, 10240, 2000 },   // web: 20 MB/s
+        { LOW, 102400, 200 },      // bulk: 20 MB/s of large packets
+    };
+
+    QoSManager qos;
+    SchedulerClassConfig classConfig[CLASS_COUNT];
+    for (int c = 0; c < CLASS_COUNT; c++) classConfig[c] = qos.getSchedulerConfig(static_cast<Priority>(c));
+
+    std::cout << "\n=== PACKET SCHEDULER BENCHMARK (OVERLOAD) ===" << std::endl;
+    std::cout << "Link: " << linkBytesPerSecond / 1e6 << " MB/s, offered: 41 MB/s, run: " << durationMs << " ms" << std::endl;
+    std::cout << "Strict priority for HIGH, DRR weights MEDIUM:LOW = " << classConfig[MEDIUM].weight << ":"
+              << classConfig[LOW].weight << std::endl;
+
+    for (int d = 0; d < 2; d++) {
+        PacketScheduler scheduler(d == 0 ? FIFO_SCHEDULING : PRIORITY_DRR_SCHEDULING, classConfig);
+        SessionResult result;
+        if (!runScheduledSession(scheduler, sources, durationMs, linkBytesPerSecond, 0, result)) return;
+
+        uint64_t totalBytes = 0;
+        for (int c = 0; c < CLASS_COUNT; c++) totalBytes += result.received[c].bytes;
+
+        std::cout << "\n--- " << (d == 0 ? "FIFO (no QoS)" : "Strict priority + DRR") << " ---" << std::endl;
+        std::cout << std::left << std::setw(18) << "Class" << std::right << std::setw(10) << "offered" << std::setw(11)
+                  << "delivered" << std::setw(8) << "share" << std::setw(8) << "drops" << std::setw(10) << "p50 ms"
+                  << std::setw(10) << "p99 ms" << std::setw(10) << "max ms" << std::endl;
+        std::cout << std::fixed << std::setprecision(1);
+        for (int c = 0; c < CLASS_COUNT; c++) {
+            const std::vector<double>& latencies = result.received[c].latenciesMs;
+            std::cout << std::left << std::setw(18) << CLASS_NAMES[c] << std::right
+                      << std::setw(8) << sources[c].packetSize * sources[c].packetsPerSecond / 1e6 << "MB"
+                      << std::setw(9) << result.received[c].bytes / result.elapsedSeconds / 1e6 << "MB"
+                      << std::setw(7) << 100.0 * result.received[c].bytes / std::max<uint64_t>(1, totalBytes) << "%"
+                      << std::setw(8) << result.scheduled[c].dropped
+                      << std::setw(10) << percentileOf(latencies, 0.50) << std::setw(10) << percentileOf(latencies, 0.99)
+                      << std::setw(10) << (latencies.empty() ? 0.0 : *std::max_element(latencies.begin(), latencies.end()))
+                      << std::endl;
+        }
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+    }
+
+    std::cout << "\n=== ANALYSIS ===" << std::endl;
+    std::cout << "- FIFO: shares follow the offered load and real-time packets wait behind bulk ones" << std::endl;
+    std::cout << "- Strict priority: real-time latency is bounded by the packet already on the wire" << std::endl;
+    std::cout << "  (up to 5 ms behind a 100 KB bulk packet), independent of load" << std::endl;
+    std::cout << "- DRR: the remaining capacity is split by weight, whatever the packet sizes" << std::endl;
+    std::cout << "- One sender thread does the scheduling; nothing sleeps to express priority" << std::endl;
+}
+
+// =====================================================================================
+// TOKEN-BUCKET SHAPER TEST (RATES VS CONFIGURATION)
+// =====================================================================================
+//
+// The HTB scheduler alone paces the link (no LinkPacer); the receiver is a
+// consumer limited to 25 MB/s, faster than the 20 MB/s shaped link, so any
+// rate it observes is the shaper's doing. Expected rates follow from the
+// configuration: every class gets min(demand, guaranteed rate), then spare link
+// capacity goes to strict classes first and to the others by DRR weight, never
+// above a class ceiling.
+
+void expectedShapedRates(const ShaperConfig& shaper, const SchedulerClassConfig classConfig[CLASS_COUNT],
+                         const double offered[CLASS_COUNT], double expected[CLASS_COUNT]) {
+    double demand[CLASS_COUNT];
+    double spare = shaper.linkBytesPerSecond;
+    for (int c = 0; c < CLASS_COUNT; c++) {
+        demand[c] = std::min(offered[c], shaper.classes[c].ceilBytesPerSecond);
+        expected[c] = std::min(demand[c], shaper.classes[c].rateBytesPerSecond);
+        spare -= expected[c];
+    }
+    for (int c = 0; c < CLASS_COUNT; c++) {
+        if (!classConfig[c].strictPriority) continue;
+        double extra = std::min(spare, demand[c] - expected[c]);
+        expected[c] += extra;
+        spare -= extra;
+    }
+    // Water-filling by weight among the remaining classes
+    while (spare > 1.0) {
+        double weights = 0.0;
+        for (int c = 0; c < CLASS_COUNT; c++) {
+            if (!classConfig[c].strictPriority && demand[c] - expected[c] > 1.0) weights += classConfig[c].weight;
+        }
+        if (weights == 0.0) break;
+        double given = 0.0;
+        for (int c = 0; c < CLASS_COUNT; c++) {
+            if (classConfig[c].strictPriority || demand[c] - expected[c] <= 1.0) continue;
+            double extra = std::min(spare * classConfig[c].weight / weights, demand[c] - expected[c]);
+            expected[c] += extra;
+            given += extra;
+        }
+        spare -= given;
+    }
+}
+
+void runShaperTest() {
+    const double linkBytesPerSecond = 20e6;
+    const double receiverBytesPerSecond = 25e6;
+    const int durationMs = 3000;
+    const int warmupMs = 500;   // excluded from the rate measurement (initial bucket burst)
+    const double tolerance = 0.10;
+
+    struct Scenario {
+        const char* label;
+        int packetsPerSecond[CLASS_COUNT];
+    };
+    const Scenario scenarios[] = {
+        { "all classes saturated", { 16000, 2000, 200 } },
+        { "light real-time, bulk borrows up to its ceiling", { 1000, 2000, 200 } },
+        { "bulk alone (ceiling applies)", { 0, 0, 200 } },
+    };
+
+    QoSManager qos;
+    SchedulerClassConfig classConfig[CLASS_COUNT];
+    for (int c = 0; c < CLASS_COUNT; c++) classConfig[c] = qos.getSchedulerConfig(static_cast<Priority>(c));
+    ShaperConfig shaper = qos.getShaperConfig(linkBytesPerSecond);
+
+    std::cout << "\n=== HIERARCHICAL TOKEN-BUCKET SHAPER TEST ===" << std::endl;
+    std::cout << "Link " << linkBytesPerSecond / 1e6 << " MB/s, receiver limited to " << receiverBytesPerSecond / 1e6
+              << " MB/s, burst " << shaper.burstBytes / 1024 << " KB" << std::endl;
+    for (int c = 0; c < CLASS_COUNT; c++) {
+        std::cout << "  " << std::left << std::setw(18) << CLASS_NAMES[c] << std::right << "rate "
+                  << shaper.classes[c].rateBytesPerSecond / 1e6 << " MB/s, ceil " << shaper.classes[c].ceilBytesPerSecond / 1e6
+                  << " MB/s" << std::endl;
+    }
+
+    bool allPassed = true;
+    for (const Scenario& scenario : scenarios) {
+        TrafficSource sources[CLASS_COUNT];
+        double offered[CLASS_COUNT], expected[CLASS_COUNT];
+        for (int c = 0; c < CLASS_COUNT; c++) {
+            Priority priority = static_cast<Priority>(c);
+            sources[c] = TrafficSource{ priority, qos.getPacketSize(static_cast<TrafficType>(c)), scenario.packetsPerSecond[c] };
+            offered[c] = static_cast<double>(sources[c].packetSize) * sources[c].packetsPerSecond;
+        }
+        expectedShapedRates(shaper, classConfig, offered, expected);
+
+        PacketScheduler scheduler(HTB_SCHEDULING, classConfig, &shaper);
+        SessionResult result;
+        if (!runScheduledSession(scheduler, sources, durationMs, 0, receiverBytesPerSecond, result)) return;
+
+        std::cout << "\n--- " << scenario.label << " ---" << std::endl;
+        std::cout << std::left << std::setw(18) << "Class" << std::right << std::setw(10) << "offered" << std::setw(10)
+                  << "expected" << std::setw(10) << "measured" << std::setw(10) << "borrowed" << std::setw(10)
+                  << "p99 ms" << std::setw(8) << "drops" << std::endl;
+        std::cout << std::fixed << std::setprecision(2);
+        for (int c = 0; c < CLASS_COUNT; c++) {
+            double measured = result.received[c].bytesPerSecondBetween(result.start + std::chrono::milliseconds(warmupMs),
+                                                                       result.deadline);
+            bool ok = std::fabs(measured - expected[c]) <= tolerance * std::max(expected[c], 0.05 * linkBytesPerSecond);
+            allPassed = allPassed && ok;
+            std::cout << std::left << std::setw(18) << CLASS_NAMES[c] << std::right
+                      << std::setw(10) << offered[c] / 1e6 << std::setw(10) << expected[c] / 1e6
+                      << std::setw(10) << measured / 1e6 << std::setw(9)
+                      << 100.0 * result.scheduled[c].bytesBorrowed / std::max<uint64_t>(1, result.scheduled[c].bytesSent) << "%"
+                      << std::setw(10) << percentileOf(result.received[c].latenciesMs, 0.99)
+                      << std::setw(8) << result.scheduled[c].dropped
+                      << (ok ? "  [OK]" : "  [FAIL]") << std::endl;
+        }
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+    }
+
+    std::cout << "\n" << (allPassed ? "[OK] All measured rates within " : "[FAIL] Some rates outside ")
+              << static_cast<int>(tolerance * 100) << "% of the configuration (MB/s)" << std::endl;
+    std::cout << "- Guaranteed rates hold under saturation; idle bandwidth is borrowed, never past a ceiling" << std::endl;
+    std::cout << "- The sender only waits while every bucket it needs is in debt: no per-packet sleeps" << std::endl;
+}
+
+// =====================================================================================
+// CONGESTION CONTROL LOOP BENCHMARK (BUFFERBLOAT)
+// =====================================================================================
+//
+// The shaper is configured for a 20 MB/s link but the real bottleneck is a
+// receiver that only consumes 8 MB/s. The standing queue then builds in the
+// socket buffers, past the scheduler, where strict priority cannot help: real-time
+// frames wait behind megabytes of bulk data. The receiver echoes every frame so the
+// sender measures per-class RTT. With the loop enabled, QoSManager shrinks the
+// lower classes until the minimum RTT falls below the target, which moves the
+// queue back into the scheduler where real-time traffic bypasses it.
+
+void runCongestionLoopBenchmark() {
+    const double shapedLinkBytesPerSecond = 20e6;
+    const double bottleneckBytesPerSecond = 8e6;
+    const int durationMs = 5000;
+    const int settleMs = 2000;   // statistics cover the rest of the run
+    // The bottleneck buffer, like a router queue: bounded, so a standing queue shows
+    // up as delay (loopback autotuning would otherwise buffer several megabytes)
+    const int bottleneckBufferBytes = 256 * 1024;
+    // A whole bulk packet holds the bottleneck for 12.5 ms, longer than the SLA:
+    // bulk goes out in 16 KB fragments (2 ms each) so real-time frames can interleave
+    const int fragmentBytes = 16384;
+    const TrafficSource sources[CLASS_COUNT] = {
+        { HIGH, 1024, 1000 },      // real-time: 1 MB/s
+        { MEDIUM, 10240, 500 },    // web: 5 MB/s
+        { LOW, 102400, 200 },      // bulk transfer: 20 MB/s
+    };
+
+    std::cout << "\n=== CONGESTION CONTROL LOOP BENCHMARK (BULK TRANSFER, HIDDEN BOTTLENECK) ===" << std::endl;
+    std::cout << "Shaper link " << shapedLinkBytesPerSecond / 1e6 << " MB/s, real bottleneck "
+              << bottleneckBytesPerSecond / 1e6 << " MB/s, offered 26 MB/s, run " << durationMs << " ms" << std::endl;
+    std::cout << "Target " << CONGESTION_TARGET_MS << " ms, interval " << CONGESTION_INTERVAL_MS
+              << " ms, fragments " << fragmentBytes / 1024 << " KB; statistics after the first " << settleMs << " ms"
+              << std::endl;
+
+    double realTimeRttP99[2] = { 0.0, 0.0 };
+    uint64_t realTimeDrops[2] = { 0, 0 };
+    double deliveredBytesPerSecond[2] = { 0.0, 0.0 };
+    double queueP99[2][CLASS_COUNT] = {};
+    for (int withLoop = 0; withLoop < 2; withLoop++) {
+        QoSManager qos;
+        if (withLoop) qos.enableDynamicMode();
+        SchedulerClassConfig classConfig[CLASS_COUNT];
+        for (int c = 0; c < CLASS_COUNT; c++) classConfig[c] = qos.getSchedulerConfig(static_cast<Priority>(c));
+        ShaperConfig shaper = qos.getShaperConfig(shapedLinkBytesPerSecond, fragmentBytes);
+        PacketScheduler scheduler(HTB_SCHEDULING, classConfig, &shaper, fragmentBytes);
+        DelayMonitor monitor;
+
+        std::atomic<bool> running(true);
+        std::vector<std::pair<double, double>> trajectory;  // (min RTT ms, scale) per interval
+        std::thread controller([&]() {
+            while (running) {
+                std::this_thread::sleep_for(std::chrono::milliseconds(CONGESTION_INTERVAL_MS));
+                double minRtt = monitor.takeIntervalMinRtt();
+                if (qos.adjustPrioritiesForCongestion(minRtt)) {
+                    scheduler.updateShaper(qos.getShaperConfig(shapedLinkBytesPerSecond, fragmentBytes));
+                }
+                trajectory.push_back(std::make_pair(minRtt, qos.getLowerClassScale()));
+            }
+        });
+        SessionResult result;
+        bool completed = runScheduledSession(scheduler, sources, durationMs, 0, bottleneckBytesPerSecond, result, &monitor,
+                                             bottleneckBufferBytes);
+        running = false;
+        controller.join();
+        if (!completed) return;
+
+        auto from = result.start + std::chrono::milliseconds(settleMs);
+        int64_t fromNs = steadyNanoseconds(from), toNs = steadyNanoseconds(result.deadline);
+
+        std::cout << "\n--- " << (withLoop ? "With the control loop" : "Without the control loop") << " ---" << std::endl;
+        std::cout << "Lower-class scale over time:";
+        const size_t intervalsPerStep = 500 / CONGESTION_INTERVAL_MS;
+        for (size_t i = intervalsPerStep - 1; i < trajectory.size(); i += intervalsPerStep) {
+            std::cout << " " << static_cast<int>(trajectory[i].second * 100 + 0.5) << "%";
+        }
+        std::cout << " (every 500 ms)" << std::endl;
+        std::cout << std::left << std::setw(18) << "Class" << std::right << std::setw(10) << "MB/s" << std::setw(12)
+                  << "queue p50" << std::setw(11) << "queue p99" << std::setw(10) << "RTT p50" << std::setw(10)
+                  << "RTT p99" << std::setw(8) << "drops" << std::endl;
+        std::cout << std::fixed << std::setprecision(1);
+        for (int c = 0; c < CLASS_COUNT; c++) {
+            std::vector<double> queueing = monitor.queueingDelaysBetween(c, fromNs, toNs);
+            std::vector<double> rtts = monitor.rttsBetween(c, fromNs, toNs);
+            double delivered = result.received[c].bytesPerSecondBetween(from, result.deadline);
+            deliveredBytesPerSecond[withLoop] += delivered;
+            queueP99[withLoop][c] = percentileOf(queueing, 0.99);
+            std::cout << std::left << std::setw(18) << CLASS_NAMES[c] << std::right
+                      << std::setw(10) << delivered / 1e6
+                      << std::setw(12) << percentileOf(queueing, 0.50) << std::setw(11) << percentileOf(queueing, 0.99)
+                      << std::setw(10) << percentileOf(rtts, 0.50) << std::setw(10) << percentileOf(rtts, 0.99)
+                      << std::setw(8) << result.scheduled[c].dropped << std::endl;
+            if (c == HIGH) {
+                realTimeRttP99[withLoop] = percentileOf(rtts, 0.99);
+                realTimeDrops[withLoop] = result.scheduled[c].dropped;
+            }
+        }
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+    }
+
+    // Cutting the lower classes to nothing would meet the real-time SLA trivially: the
+    // loop only counts if the link stays as busy as without it
+    const double minDeliveredShare = 0.9;
+    QoSManager slaPolicy;
+    std::cout << "\n=== ANALYSIS ===" << std::endl;
+    std::cout << std::fixed << std::setprecision(1);
+    std::cout << "- Real-time RTT p99: " << realTimeRttP99[0] << " ms without the loop, " << realTimeRttP99[1]
+              << " ms with it (SLA " << slaPolicy.getMaxLatency(HIGH) << " ms)" << std::endl;
+    std::cout << "- Delivered: " << deliveredBytesPerSecond[0] / 1e6 << " MB/s without the loop, "
+              << deliveredBytesPerSecond[1] / 1e6 << " MB/s with it (bottleneck " << bottleneckBytesPerSecond / 1e6
+              << " MB/s)" << std::endl;
+    for (int withLoop = 0; withLoop < 2; withLoop++) {
+        bool met = slaPolicy.checkSLA(realTimeRttP99[withLoop], HIGH) && realTimeDrops[withLoop] == 0;
+        std::cout << "  " << (met ? "[OK] SLA met" : "[FAIL] SLA missed") << (withLoop ? " with the loop" : " without the loop")
+                  << " (p99 " << realTimeRttP99[withLoop] << " ms, " << realTimeDrops[withLoop] << " real-time drops, "
+                  << deliveredBytesPerSecond[withLoop] / 1e6 << " MB/s delivered)" << std::endl;
+    }
+    double deliveredShare = deliveredBytesPerSecond[1] / std::max(1.0, deliveredBytesPerSecond[0]);
+    std::cout << "  " << (deliveredShare >= minDeliveredShare ? "[OK]" : "[FAIL]") << " The loop keeps "
+              << 100.0 * deliveredShare << "% of the throughput delivered without it (minimum "
+              << 100.0 * minDeliveredShare << "%)" << std::endl;
+    std::cout << "- Lower-class queue p99 with the loop:";
+    for (int c = HIGH + 1; c < CLASS_COUNT; c++) {
+        std::cout << " " << CLASS_NAMES[c] << " " << queueP99[1][c] << " ms (SLA "
+                  << slaPolicy.getMaxLatency(static_cast<Priority>(c)) << ")";
+    }
+    std::cout << std::endl;
+    std::cout << "  They are offered 25 MB/s for the bottleneck's spare 7 MB/s, so their queues stay full" << std::endl;
+    std::cout << "  whatever the loop does: it only moves that queue from the bottleneck into the scheduler" << std::endl;
+    std::cout.unsetf(std::ios::floatfield);
+    std::cout << std::setprecision(6);
+    std::cout << "- Without feedback the queue hides in the bottleneck, where priorities do not apply" << std::endl;
+    std::cout << "- The loop reacts to the minimum delay per interval, so bursts are tolerated and only" << std::endl;
+    std::cout << "  a standing queue shrinks the lower classes; real-time traffic keeps its rate" << std::endl;
+}
+
+// =====================================================================================
+// ACKNOWLEDGEMENT BENCHMARK (PER-MESSAGE VS COALESCED)
+// =====================================================================================
+//
+// One connection streams 1 KB frames as fast as its acknowledgements allow. The
+// baseline is the original protocol: one ACK per message and stop-and-wait.
+// Syscalls are counted on both ends (send, recv and the server's select).
+
+const int ACK_BENCH_PORT = 8890;
+
+struct AckScenario {
+    const char* label;
+    AckPolicy policy;
+    size_t window;
+    double loss;
+};
+
+void runAckBenchmark() {
+    const int frameCount = 20000;
+    const int frameSize = 1024;
+    const AckScenario scenarios[] = {
+        { "per-message ACK, stop-and-wait", { 1, 0 }, 1, 0.0 },
+        { "per-message ACK, window 64", { 1, 0 }, DEFAULT_ACK_WINDOW, 0.0 },
+        { "coalesced ACK, window 64", DEFAULT_ACK_POLICY, DEFAULT_ACK_WINDOW, 0.0 },
+        { "coalesced + SACK, 1% loss", DEFAULT_ACK_POLICY, DEFAULT_ACK_WINDOW, 0.01 },
+    };
+
+    std::cout << "\n=== ACKNOWLEDGEMENT BENCHMARK (" << frameCount << " frames of " << frameSize << " bytes) ===" << std::endl;
+    std::cout << "Coalesced: one ACK per " << DEFAULT_ACK_POLICY.ackEvery << " frames or " << DEFAULT_ACK_POLICY.ackDelayMs
+              << " ms, cumulative + up to " << MAX_SACK_RANGES << " SACK ranges" << std::endl;
+    std::cout << std::left << std::setw(32) << "Protocol" << std::right << std::setw(10) << "frames/s" << std::setw(8)
+              << "MB/s" << std::setw(9) << "ACKs" << std::setw(13) << "client sys/f" << std::setw(13) << "server sys/f"
+              << std::setw(8) << "rexmit" << std::setw(9) << "p99 ms" << std::endl;
+
+    bool allDelivered = true;
+    for (const AckScenario& scenario : scenarios) {
+        SOCKET listener = createListeningSocket(ACK_BENCH_PORT);
+        if (listener == INVALID_SOCKET) {
+            std::cerr << "[FAIL] Cannot listen on port " << ACK_BENCH_PORT << std::endl;
+            return;
+        }
+        AckServerStats serverStats = AckServerStats{ 0, 0, 0, 0, 0, 0, 0 };
+        std::thread server([&]() {
+            SOCKET connection = accept(listener, NULL, NULL);
+            if (connection == INVALID_SOCKET) return;
+            serveAckedConnection(connection, scenario.policy, serverStats);
+            closesocket(connection);
+        });
+
+        SOCKET sock = connectToLocalPort(ACK_BENCH_PORT);
+        std::vector<double> latencies;
+        latencies.reserve(frameCount);
+        uint64_t clientSyscalls = 0, retransmissions = 0;
+        auto start = std::chrono::steady_clock::now();
+        {
+            AckedConnection connection(sock, scenario.window, scenario.loss, 42);
+            for (int i = 0; i < frameCount; i++) {
+                if (!connection.send(HIGH, frameSize, std::chrono::steady_clock::now(), i == frameCount - 1, &latencies)) break;
+            }
+            connection.close();
+            clientSyscalls = connection.sendCalls + connection.recvCallCount();
+            retransmissions = connection.retransmissions;
+        }
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        server.join();
+        closesocket(sock);
+        closesocket(listener);
+
+        bool delivered = serverStats.frames == static_cast<uint64_t>(frameCount) && serverStats.duplicates == 0;
+        allDelivered = allDelivered && delivered;
+        std::cout << std::left << std::setw(32) << scenario.label << std::right << std::fixed << std::setprecision(0)
+                  << std::setw(10) << frameCount / seconds << std::setprecision(1) << std::setw(8)
+                  << frameCount * static_cast<double>(frameSize) / seconds / 1e6 << std::setw(9) << serverStats.acksSent
+                  << std::setprecision(3) << std::setw(13) << static_cast<double>(clientSyscalls) / frameCount
+                  << std::setw(13)
+                  << static_cast<double>(serverStats.recvCalls + serverStats.sendCalls + serverStats.selectCalls) / frameCount
+                  << std::setw(8) << retransmissions << std::setprecision(2) << std::setw(9) << percentileOf(latencies, 0.99)
+                  << (delivered ? "" : "  [FAIL] frames missing") << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+    }
+
+    std::cout << "\n" << (allDelivered ? "[OK] Every frame delivered exactly once in all runs" : "[FAIL] Delivery check failed")
+              << std::endl;
+    std::cout << "- Stop-and-wait pays a full round trip per message; a window keeps the pipe busy" << std::endl;
+    std::cout << "- Coalesced ACKs cut the reverse traffic and the syscalls spent on it" << std::endl;
+    std::cout << "- SACK ranges tell the sender exactly which frames to resend, without a timeout" << std::endl;
+}
+
+// =====================================================================================
+// LINK EMULATOR TESTS (DETERMINISTIC, VIRTUAL TIME)
+// =====================================================================================
+//
+// Each test drives frames through a LinkEmulator on a virtual clock and asserts
+// exact or statistically bounded outcomes. Nothing sleeps and no socket is used,
+// so the whole suite runs in milliseconds and gives the same result every time:
+// a failure is a behaviour change, never noise. The last tests put the packet
+// scheduler in front of an impaired bottleneck, a path loopback cannot exercise.
+
+// FNV-1a over the bytes of `value`: a fingerprint of a delivery trace
+uint64_t traceDigest(uint64_t hash, uint64_t value) {
+    for (int i = 0; i < 8; i++) {
+        hash ^= (value >> (8 * i)) & 0xFF;
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+const uint64_t TRACE_DIGEST_SEED = 14695981039346656037ULL;
+
+struct EmulatedTransfer {
+    std::vector<uint32_t> sequences;   // in delivery order
+    std::vector<int64_t> latencyNs;    // send -> delivery, same order
+    int64_t lastDeliveryNs;
+    uint64_t digest;
+    LinkEmulatorStats link;
+};
+
+// Sends `count` frames of `size` bytes, one every `intervalNs` (0: back to back)
+EmulatedTransfer runEmulatedTransfer(const LinkImpairment& impairment, int count, int size, int64_t intervalNs) {
+    LinkEmulator link(impairment);
+    VirtualClock clock;
+    EmulatedTransfer transfer;
+    transfer.lastDeliveryNs = 0;
+    transfer.digest = TRACE_DIGEST_SEED;
+    std::vector<char> frame(size), delivered;
+    int sent = 0;
+    while (sent < count || !link.empty()) {
+        int64_t nextSendNs = sent < count ? sent * intervalNs : NO_EVENT_NS;
+        clock.advanceTo(std::min(nextSendNs, link.nextDeliveryNs()));
+        if (clock.nowNs() == nextSendNs) {
+            FrameHeader header = { 0, 0, 0, static_cast<uint32_t>(sent), static_cast<uint32_t>(size - FRAME_HEADER_SIZE),
+                                   clock.nowNs(), clock.nowNs(), 0 };
+            encodeFrameHeader(header, frame.data());
+            link.send(clock.nowNs(), frame.data(), size);
+            sent++;
+        }
+        while (link.receive(clock.nowNs(), delivered)) {
+            FrameHeader header;
+            decodeFrameHeader(delivered.data(), header);
+            transfer.sequences.push_back(header.sequenceNum);
+            transfer.latencyNs.push_back(clock.nowNs() - header.sentNs);
+            transfer.lastDeliveryNs = clock.nowNs();
+            transfer.digest = traceDigest(traceDigest(transfer.digest, header.sequenceNum), clock.nowNs());
+        }
+    }
+    transfer.link = link.stats;
+    return transfer;
+}
+
+// Frames delivered after a higher sequence number
+size_t countReordered(const std::vector<uint32_t>& sequences) {
+    size_t reordered = 0;
+    uint32_t highest = 0;
+    for (size_t i = 0; i < sequences.size(); i++) {
+        if (i > 0 && sequences[i] < highest) reordered++;
+        highest = std::max(highest, sequences[i]);
+    }
+    return reordered;
+}
+
+// Mean length of the runs of consecutive missing sequence numbers
+double meanLossRun(const std::vector<uint32_t>& sequences, int count) {
+    std::vector<bool> arrived(count, false);
+    for (uint32_t sequence : sequences) arrived[sequence] = true;
+    int lost = 0, runs = 0;
+    for (int i = 0; i < count; i++) {
+        if (arrived[i]) continue;
+        lost++;
+        if (i == 0 || arrived[i - 1]) runs++;
+    }
+    return runs > 0 ? static_cast<double>(lost) / runs : 0.0;
+}
+
+struct EmulatedSessionResult {
+    std::vector<double> latenciesMs[CLASS_COUNT];   // enqueue -> delivery
+    std::vector<double> waitMs[CLASS_COUNT];        // enqueue -> first byte on the link
+    uint64_t bytesDelivered[CLASS_COUNT];
+    int64_t lastDeliveryNs;   // the queues drain after the sources stop
+    uint64_t digest;
+    LinkEmulatorStats link;
+};
+
+// Paced sources -> packet scheduler -> emulated link, all in virtual time. The
+// scheduler is asked for a packet whenever the bottleneck goes idle, as the
+// scheduled sender does on a real link
+EmulatedSessionResult runEmulatedSession(SchedulingDiscipline discipline, const TrafficSource sources[CLASS_COUNT],
+                                         int durationMs, const LinkImpairment& impairment, int fragmentLimit = 0) {
+    QoSManager qos;
+    SchedulerClassConfig classConfig[CLASS_COUNT];
+    for (int c = 0; c < CLASS_COUNT; c++) classConfig[c] = qos.getSchedulerConfig(static_cast<Priority>(c));
+    PacketScheduler scheduler(discipline, classConfig, NULL, fragmentLimit);
+    LinkEmulator link(impairment);
+    VirtualClock clock;
+
+    EmulatedSessionResult result;
+    result.lastDeliveryNs = 0;
+    result.digest = TRACE_DIGEST_SEED;
+    const int64_t durationNs = static_cast<int64_t>(durationMs) * 1000000;
+    int64_t nextArrivalNs[CLASS_COUNT];
+    int sequence[CLASS_COUNT];
+    for (int c = 0; c < CLASS_COUNT; c++) {
+        result.bytesDelivered[c] = 0;
+        nextArrivalNs[c] = sources[c].packetsPerSecond > 0 ? 0 : NO_EVENT_NS;
+        sequence[c] = 0;
+    }
+
+    std::vector<char> frame, delivered;
+    while (true) {
+        for (int c = 0; c < CLASS_COUNT; c++) {
+            while (nextArrivalNs[c] <= clock.nowNs()) {
+                QueuedPacket packet = { sources[c].priority, sources[c].packetSize, sequence[c]++, clock.at(nextArrivalNs[c]), 0, 0 };
+                scheduler.enqueue(packet);
+                nextArrivalNs[c] += 1000000000LL / sources[c].packetsPerSecond;
+                if (nextArrivalNs[c] >= durationNs) nextArrivalNs[c] = NO_EVENT_NS;
+            }
+        }
+        QueuedPacket packet;
+        if (link.idleAtNs() <= clock.nowNs() && scheduler.tryDequeue(clock.now(), packet)) {
+            if (packet.fragmentOffset == 0) {
+                result.waitMs[packet.priority].push_back((clock.nowNs() - clock.nanosecondsAt(packet.enqueued)) / 1e6);
+            }
+            FrameHeader header = { static_cast<uint8_t>(packet.priority), 0, 0, static_cast<uint32_t>(packet.sequenceNum),
+                                   static_cast<uint32_t>(packet.fragmentSize), clock.nanosecondsAt(packet.enqueued),
+                                   clock.nowNs(), 0 };
+            frame.resize(FRAME_HEADER_SIZE + packet.fragmentSize);
+            encodeFrameHeader(header, frame.data());
+            link.send(clock.nowNs(), frame.data(), static_cast<int>(frame.size()));
+        }
+        while (link.receive(clock.nowNs(), delivered)) {
+            FrameHeader header;
+            decodeFrameHeader(delivered.data(), header);
+            result.latenciesMs[header.priority].push_back((clock.nowNs() - header.enqueuedNs) / 1e6);
+            result.bytesDelivered[header.priority] += header.payloadSize;
+            result.lastDeliveryNs = clock.nowNs();
+            result.digest = traceDigest(traceDigest(result.digest, (static_cast<uint64_t>(header.priority) << 32) | header.sequenceNum),
+                                        clock.nowNs());
+        }
+
+        int64_t nextNs = link.nextDeliveryNs();
+        for (int c = 0; c < CLASS_COUNT; c++) nextNs = std::min(nextNs, nextArrivalNs[c]);
+        if (link.idleAtNs() > clock.nowNs()) nextNs = std::min(nextNs, link.idleAtNs());
+        if (nextNs == NO_EVENT_NS) break;
+        clock.advanceTo(nextNs);
+    }
+    result.link = link.stats;
+    return result;
+}
+
+bool reportEmulatorTest(bool ok, const std::string& name) {
+    std::cout << (ok ? "  [PASS] " : "  [FAIL] ") << name << std::endl;
+    return ok;
+}
+
+void runLinkEmulatorTests() {
+    std::cout << "\n=== LINK EMULATOR TESTS (virtual clock, seeded) ===" << std::endl;
+    bool ok = true;
+
+    // Rate and delay are exact: frame i (1000 bytes at 1 MB/s) lands (i + 1) ms + 10 ms after the start
+    {
+        EmulatedTransfer transfer = runEmulatedTransfer(cleanLink(1e6, 10.0), 100, 1000, 0);
+        bool exact = transfer.sequences.size() == 100;
+        for (size_t i = 0; exact && i < transfer.sequences.size(); i++) {
+            exact = transfer.sequences[i] == i && transfer.latencyNs[i] == static_cast<int64_t>(i + 1) * 1000000 + 10000000;
+        }
+        ok &= reportEmulatorTest(exact && transfer.lastDeliveryNs == 110000000,
+                                 "1 MB/s + 10 ms: 100 x 1000 B delivered at exactly (i+1) ms + 10 ms");
+    }
+
+    // Jitter spreads latency within [delay, delay + jitter] and keeps the order
+    {
+        LinkImpairment link = cleanLink(0.0, 20.0);
+        link.jitterMs = 5.0;
+        EmulatedTransfer transfer = runEmulatedTransfer(link, 5000, 200, 1000000);
+        std::vector<double> latencyMs;
+        for (int64_t ns : transfer.latencyNs) latencyMs.push_back(ns / 1e6);
+        double low = *std::min_element(latencyMs.begin(), latencyMs.end());
+        double high = *std::max_element(latencyMs.begin(), latencyMs.end());
+        bool bounded = transfer.sequences.size() == 5000 && low >= 20.0 && high <= 25.0 &&
+                       percentileOf(latencyMs, 0.99) - percentileOf(latencyMs, 0.01) >= 2.5 &&
+                       countReordered(transfer.sequences) == 0;
+        std::ostringstream name;
+        name << "20 ms + 5 ms jitter: latency " << std::fixed << std::setprecision(2) << low << ".." << high
+             << " ms, order kept";
+        ok &= reportEmulatorTest(bounded, name.str());
+    }
+
+    // Reordering: 5% of the frames are held back 3 ms and overtaken
+    {
+        LinkImpairment link = cleanLink(0.0, 10.0);
+        link.reorderProbability = 0.05;
+        link.reorderDelayMs = 3.0;
+        EmulatedTransfer transfer = runEmulatedTransfer(link, 10000, 200, 1000000);
+        double reordered = static_cast<double>(countReordered(transfer.sequences)) / transfer.sequences.size();
+        std::ostringstream name;
+        name << "reordering 5%: " << std::fixed << std::setprecision(2) << reordered * 100 << "% delivered out of order, none lost";
+        ok &= reportEmulatorTest(transfer.sequences.size() == 10000 && reordered >= 0.04 && reordered <= 0.06 &&
+                                 countReordered(transfer.sequences) == transfer.link.reordered, name.str());
+    }
+
+    // Random loss: the right rate, isolated losses
+    {
+        LinkImpairment link = cleanLink(0.0, 10.0);
+        link.lossProbability = 0.01;
+        EmulatedTransfer transfer = runEmulatedTransfer(link, 20000, 200, 100000);
+        double loss = 1.0 - transfer.sequences.size() / 20000.0;
+        double run = meanLossRun(transfer.sequences, 20000);
+        std::ostringstream name;
+        name << "random loss 1%: " << std::fixed << std::setprecision(2) << loss * 100 << "% lost, mean run "
+             << run << " frames";
+        ok &= reportEmulatorTest(loss >= 0.008 && loss <= 0.012 && run < 1.1, name.str());
+    }
+
+    // Bursty loss: a similar average, but losses come in runs (mean 1 / exit probability)
+    {
+        LinkImpairment link = cleanLink(0.0, 10.0);
+        link.burstEnterProbability = 0.005;
+        link.burstExitProbability = 0.25;
+        link.burstLossProbability = 1.0;
+        EmulatedTransfer transfer = runEmulatedTransfer(link, 20000, 200, 100000);
+        double loss = 1.0 - transfer.sequences.size() / 20000.0;
+        double run = meanLossRun(transfer.sequences, 20000);
+        std::ostringstream name;
+        name << "bursty loss (Gilbert-Elliott, ~2%): " << std::fixed << std::setprecision(2) << loss * 100
+             << "% lost, mean run " << run << " frames";
+        ok &= reportEmulatorTest(loss >= 0.01 && loss <= 0.03 && run >= 3.0, name.str());
+    }
+
+    // A bottleneck offered twice its rate: it runs at exactly its rate, the buffer
+    // bounds the queueing delay and the excess is tail-dropped
+    {
+        LinkImpairment link = cleanLink(1e6, 10.0);
+        link.queueLimitBytes = 50000;
+        EmulatedTransfer transfer = runEmulatedTransfer(link, 4000, 1000, 500000);
+        double seconds = (transfer.lastDeliveryNs - 10000000) / 1e9;   // the bottleneck never idles
+        double rate = transfer.link.bytesDelivered / seconds;
+        double worstMs = *std::max_element(transfer.latencyNs.begin(), transfer.latencyNs.end()) / 1e6;
+        std::ostringstream name;
+        name << "2 MB/s into 1 MB/s with a 50 KB buffer: " << std::fixed << std::setprecision(3) << rate / 1e6
+             << " MB/s, worst " << std::setprecision(1) << worstMs << " ms, " << transfer.link.droppedQueue << " dropped";
+        ok &= reportEmulatorTest(std::fabs(rate - 1e6) < 0.01e6 && worstMs <= 10.0 + 51.0 &&
+                                 transfer.link.droppedQueue > 1500 && transfer.link.droppedQueue < 2100, name.str());
+    }
+
+    // Determinism: every impairment at once, same seed -> identical trace
+    {
+        LinkImpairment link = cleanLink(2e6, 15.0, 42);
+        link.queueLimitBytes = 32768;
+        link.jitterMs = 3.0;
+        link.reorderProbability = 0.02;
+        link.reorderDelayMs = 2.0;
+        link.lossProbability = 0.005;
+        link.burstEnterProbability = 0.002;
+        link.burstExitProbability = 0.3;
+        link.burstLossProbability = 0.8;
+        EmulatedTransfer first = runEmulatedTransfer(link, 5000, 1200, 500000);
+        EmulatedTransfer second = runEmulatedTransfer(link, 5000, 1200, 500000);
+        link.seed = 43;
+        EmulatedTransfer other = runEmulatedTransfer(link, 5000, 1200, 500000);
+        std::ostringstream name;
+        name << "same seed, same trace (digest " << std::hex << first.digest << std::dec << "); new seed differs";
+        ok &= reportEmulatorTest(first.digest == second.digest && first.sequences == second.sequences &&
+                                 first.digest != other.digest, name.str());
+    }
+
+    // The scheduler in front of an impaired 2 MB/s bottleneck (20 ms, 2 ms jitter,
+    // 1% loss), real-time traffic next to an overload of 16 KB bulk packets
+    {
+        const TrafficSource sources[CLASS_COUNT] = {
+            { HIGH, 1024, 200 },       // 0.2 MB/s
+            { MEDIUM, 10240, 0 },
+            { LOW, 16384, 250 },       // 4 MB/s
+        };
+        LinkImpairment link = cleanLink(2e6, 20.0, 7);
+        link.jitterMs = 2.0;
+        link.lossProbability = 0.01;
+        const int durationMs = 3000;
+
+        EmulatedSessionResult fifo = runEmulatedSession(FIFO_SCHEDULING, sources, durationMs, link);
+        EmulatedSessionResult priority = runEmulatedSession(PRIORITY_DRR_SCHEDULING, sources, durationMs, link);
+        EmulatedSessionResult again = runEmulatedSession(PRIORITY_DRR_SCHEDULING, sources, durationMs, link);
+
+        // Real-time bound: propagation + jitter + one bulk frame already on the wire + its own frame
+        double boundMs = 20.0 + 2.0 + (2.0 * FRAME_HEADER_SIZE + 16384 + 1024) * 1e3 / 2e6;
+        double fifoP99 = percentileOf(fifo.latenciesMs[HIGH], 0.99);
+        double priorityMax = *std::max_element(priority.latenciesMs[HIGH].begin(), priority.latenciesMs[HIGH].end());
+        double delivered = static_cast<double>(priority.latenciesMs[HIGH].size()) / (sources[HIGH].packetsPerSecond * durationMs / 1000);
+        double bulkRate = priority.bytesDelivered[LOW] / ((priority.lastDeliveryNs - 20000000) / 1e9);
+
+        std::ostringstream name;
+        name << "priority over the impaired link: real-time max " << std::fixed << std::setprecision(1) << priorityMax
+             << " ms (bound " << boundMs << "), FIFO p99 " << fifoP99 << " ms";
+        ok &= reportEmulatorTest(priorityMax <= boundMs && fifoP99 > 10 * boundMs, name.str());
+
+        std::ostringstream share;
+        share << "real-time " << std::setprecision(1) << std::fixed << delivered * 100 << "% delivered (1% link loss), bulk "
+              << std::setprecision(2) << bulkRate / 1e6 << " MB/s of the ~1.8 left";
+        ok &= reportEmulatorTest(delivered >= 0.98 && delivered <= 1.0 && bulkRate >= 1.7e6 && bulkRate <= 1.8e6,
+                                 share.str());
+
+        ok &= reportEmulatorTest(priority.digest == again.digest, "scheduler session reproduces exactly");
+    }
+
+    std::cout << (ok ? "All link emulator tests passed" : "Some link emulator tests FAILED") << std::endl;
+}
+
+// =====================================================================================
+// FRAGMENTATION BENCHMARK (REAL-TIME LATENCY BEHIND BULK TRANSFERS)
+// =====================================================================================
+//
+// Strict priority decides what goes next, but not what is already on the wire: a
+// real-time packet arriving just after a 100 KB bulk packet started waits for all
+// of it. Fragmenting bulk packets bounds that wait by one fragment. The link is
+// paced at 20 MB/s and kept busy by bulk traffic; the receiver reassembles.
+// The worst case a real-time packet can see is the serialization of one bulk
+// fragment. On loopback that bound is blurred by the pacing quantum and by the
+// operating system's scheduler, so it is checked on the emulated link (virtual
+// clock), where every wait is exact and the maxima are reproducible.
+
+void runFragmentationBenchmark() {
+    const double linkBytesPerSecond = 20e6;
+    const int durationMs = 3000;
+    const int fragmentLimits[] = { 0, 65536, 16384, 4096, 1460 };
+    const TrafficSource sources[CLASS_COUNT] = {
+        { HIGH, 1024, 1000 },      // real-time: 1 MB/s
+        { MEDIUM, 10240, 0 },
+        { LOW, 102400, 250 },      // bulk transfer: 25 MB/s, keeps the link saturated
+    };
+
+    QoSManager qos;
+    SchedulerClassConfig classConfig[CLASS_COUNT];
+    for (int c = 0; c < CLASS_COUNT; c++) classConfig[c] = qos.getSchedulerConfig(static_cast<Priority>(c));
+
+    std::cout << "\n=== FRAGMENTATION BENCHMARK (STRICT PRIORITY, BULK TRANSFER ACTIVE) ===" << std::endl;
+    std::cout << "Link " << linkBytesPerSecond / 1e6 << " MB/s, real-time 1 KB x 1000/s, bulk 100 KB x 250/s, run "
+              << durationMs << " ms" << std::endl;
+    std::cout << "Real-time wait: enqueue -> on the wire (ms); delivery: enqueue -> reassembled (ms)" << std::endl;
+    std::cout << "\n--- Loopback TCP, real time ---" << std::endl;
+    std::cout << std::left << std::setw(10) << "Fragment" << std::right
+              << std::setw(10) << "wait p50" << std::setw(10) << "wait p99" << std::setw(10) << "wait max"
+              << std::setw(9) << "dlv p99" << std::setw(11) << "bulk MB/s"
+              << std::setw(10) << "frames/s" << std::setw(10) << "overhead" << std::endl;
+
+    for (int limit : fragmentLimits) {
+        PacketScheduler scheduler(PRIORITY_DRR_SCHEDULING, classConfig, NULL, limit);
+        SessionResult result;
+        if (!runScheduledSession(scheduler, sources, durationMs, linkBytesPerSecond, 0, result)) return;
+
+        // Frames on the wire: one per fragment
+        int bulkFragments = limit > 0 ? (sources[LOW].packetSize + limit - 1) / limit : 1;
+        double frames = static_cast<double>(result.received[HIGH].packets) + result.received[LOW].packets * bulkFragments;
+        double payload = static_cast<double>(result.received[HIGH].bytes + result.received[LOW].bytes);
+        const std::vector<double>& wait = result.received[HIGH].waitMs;
+
+        std::cout << std::left << std::setw(10) << (limit > 0 ? std::to_string(limit) + " B" : std::string("none"))
+                  << std::right << std::fixed << std::setprecision(2)
+                  << std::setw(10) << percentileOf(wait, 0.50) << std::setw(10) << percentileOf(wait, 0.99)
+                  << std::setw(10) << (wait.empty() ? 0.0 : *std::max_element(wait.begin(), wait.end()))
+                  << std::setw(9) << percentileOf(result.received[HIGH].latenciesMs, 0.99)
+                  << std::setprecision(1) << std::setw(11) << result.received[LOW].bytes / result.elapsedSeconds / 1e6
+                  << std::setprecision(0) << std::setw(10) << frames / result.elapsedSeconds
+                  << std::setprecision(2) << std::setw(9) << 100.0 * frames * FRAME_HEADER_SIZE / std::max(1.0, payload) << "%"
+                  << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+    }
+
+    // Same sources and scheduler on the emulated link: the worst case against its bound
+    std::cout << "\n--- Emulated link, virtual clock (deterministic) ---" << std::endl;
+    std::cout << std::left << std::setw(10) << "Fragment" << std::right << std::setw(8) << "bound"
+              << std::setw(10) << "wait p99" << std::setw(10) << "wait max" << std::setw(10) << "packets" << "  result"
+              << std::endl;
+    bool allWithinBound = true;
+    for (int limit : fragmentLimits) {
+        EmulatedSessionResult result = runEmulatedSession(PRIORITY_DRR_SCHEDULING, sources, durationMs,
+                                                          cleanLink(linkBytesPerSecond, 0.0), limit);
+        const std::vector<double>& wait = result.waitMs[HIGH];
+        int largestFrame = limit > 0 ? std::min(limit, sources[LOW].packetSize) : sources[LOW].packetSize;
+        double boundMs = (FRAME_HEADER_SIZE + largestFrame) * 1e3 / linkBytesPerSecond;
+        double worstMs = wait.empty() ? 0.0 : *std::max_element(wait.begin(), wait.end());
+        bool withinBound = !wait.empty() && worstMs <= boundMs;
+        allWithinBound &= withinBound;
+
+        std::cout << std::left << std::setw(10) << (limit > 0 ? std::to_string(limit) + " B" : std::string("none"))
+                  << std::right << std::fixed << std::setprecision(3) << std::setw(8) << boundMs
+                  << std::setw(10) << percentileOf(wait, 0.99) << std::setw(10) << worstMs
+                  << std::setw(10) << wait.size() << (withinBound ? "  [OK]" : "  [FAIL]") << std::endl;
+        std::cout.unsetf(std::ios::floatfield);
+        std::cout << std::setprecision(6);
+    }
+
+    std::cout << "\n=== ANALYSIS ===" << std::endl;
+    std::cout << "- Without fragmentation, real-time packets can wait a whole bulk packet (~5 ms)" << std::endl;
+    std::cout << "- With fragments the wait is bounded by one fragment on the wire: "
+              << (allWithinBound ? "holds for every fragment size" : "VIOLATED") << " on the virtual clock" << std::endl;
+    std::cout << "- On loopback the maxima add the 1 ms pacing quantum and operating-system scheduling" << std::endl;
+    std::cout << "- Smaller fragments cost more frames (headers, syscalls): 4-16 KB keeps both low" << std::endl;
+}
+
 // =====================================================================================
 // RUN ALL MODES
 // =====================================================================================
@@ -886,13 +3143,53 @@ int main(int argc, char* argv[]) {
         if (arg1 == "all" || arg1 == "ALL") {
             runAll = true;
         }
+        else if (arg1 == "sched") {
+            initializeNetwork();
+            runSchedulerBenchmark();
+            cleanupNetwork();
+            return 0;
+        }
+        else if (arg1 == "htb") {
+            initializeNetwork();
+            runShaperTest();
+            cleanupNetwork();
+            return 0;
+        }
+        else if (arg1 == "codel") {
+            initializeNetwork();
+            runCongestionLoopBenchmark();
+            cleanupNetwork();
+            return 0;
+        }
+        else if (arg1 == "acks") {
+            initializeNetwork();
+            runAckBenchmark();
+            cleanupNetwork();
+            return 0;
+        }
+        else if (arg1 == "frag") {
+            initializeNetwork();
+            runFragmentationBenchmark();
+            cleanupNetwork();
+            return 0;
+        }
+        else if (arg1 == "emu") {
+            runLinkEmulatorTests();
+            return 0;
+        }
         else {
             selectedMode = atoi(argv[1]);
             if (selectedMode < 0 || selectedMode > 3) {
                 std::cerr << "Error: Invalid mode. Mode must be 0-3 or 'all'" << std::endl;
-                std::cerr << "Usage: " << argv[0] << " [mode|all]" << std::endl;
+                std::cerr << "Usage: " << argv[0] << " [mode|all|sched|htb|codel|acks|frag|emu]" << std::endl;
                 std::cerr << "  mode: 0=No QoS, 1=Priority, 2=Dynamic, 3=Security" << std::endl;
                 std::cerr << "  all: Run all 4 modes in sequence" << std::endl;
+                std::cerr << "  sched: Packet scheduler (strict priority + DRR) under overload" << std::endl;
+                std::cerr << "  htb: Hierarchical token-bucket shaper, measured vs configured rates" << std::endl;
+                std::cerr << "  codel: Delay-driven congestion control loop under bulk load" << std::endl;
+                std::cerr << "  acks: Per-message vs coalesced/selective acknowledgements" << std::endl;
+                std::cerr << "  frag: Real-time latency behind fragmented bulk transfers" << std::endl;
+                std::cerr << "  emu: Deterministic link emulator tests (virtual clock)" << std::endl;
                 return 1;
             }
             QOS_MODE = selectedMode;
@@ -962,7 +3259,7 @@ int main(int argc, char* argv[]) {
     std::string userInput;
 
     while (true) {
-        std::cout << "\n>>> Type 'run' to execute, 'mode' to change mode, 'all' for all modes, 'quit' to exit: ";
+        std::cout << "\n>>> Type 'run' to execute, 'mode' to change mode, 'all' for all modes, 'sched'/'htb'/'codel'/'acks'/'frag' for the benchmarks, 'emu' for the link emulator tests, 'quit' to exit: ";
         std::getline(std::cin, userInput);
 
         if (userInput == "quit" || userInput == "exit") {
@@ -973,6 +3270,40 @@ int main(int argc, char* argv[]) {
             runAllModes();
             continue;
         }
+        else if (userInput == "sched") {
+            initializeNetwork();
+            runSchedulerBenchmark();
+            cleanupNetwork();
+            continue;
+        }
+        else if (userInput == "htb") {
+            initializeNetwork();
+            runShaperTest();
+            cleanupNetwork();
+            continue;
+        }
+        else if (userInput == "codel") {
+            initializeNetwork();
+            runCongestionLoopBenchmark();
+            cleanupNetwork();
+            continue;
+        }
+        else if (userInput == "acks") {
+            initializeNetwork();
+            runAckBenchmark();
+            cleanupNetwork();
+            continue;
+        }
+        else if (userInput == "frag") {
+            initializeNetwork();
+            runFragmentationBenchmark();
+            cleanupNetwork();
+            continue;
+        }
+        else if (userInput == "emu") {
+            runLinkEmulatorTests();
+            continue;
+        }
         else if (userInput == "mode") {
             QOS_MODE = (QOS_MODE + 1) % 4;
             std::cout << "Mode changed to: " << QOS_MODE << std::endl;
@@ -1014,7 +3345,7 @@ int main(int argc, char* argv[]) {
             serverThread.join();
         }
         else {
-            std::cout << "Invalid command. Use 'run', 'mode', 'all', or 'quit'." << std::endl;
+            std::cout << "Invalid command. Use 'run', 'mode', 'all', 'sched', 'htb', 'codel', 'acks', 'frag', 'emu', or 'quit'." << std::endl;
         }
     }
 